@@ -0,0 +1,368 @@
+/* blockingCirListDeque.c
+ * blocking cirListDeque implementation file.
+ 
+ Description:   Producer/consumer wrapper around cirListDeque. One mutex
+                guards the deque, consumers sleep on a condition variable
+                instead of polling isEmptyCirListDeque. Producers only
+                signal when someone is waiting, and a drain takes every
+                available value for a single wakeup. Closing wakes all
+                waiters; values already queued can still be removed.
+                A bounded blocking deque makes producers sleep on a second
+                condition variable while it is full.
+ **** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+#include "blockingCirListDeque.h"
+
+struct blockingCirListDeque {
+    struct cirListDeque *q;     /* the guarded deque */
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;    /* signalled when a value is added or on close */
+    pthread_cond_t notFull;     /* signalled when a value is removed or on close */
+    int waiters;                /* threads sleeping on notEmpty */
+    int putWaiters;             /* threads sleeping on notFull */
+    int closed;
+};
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* Wrap q in an open blocking deque
+
+	param: 	q		the deque to guard
+	post:	the lock and condition variables are initialized
+*/
+static struct blockingCirListDeque *_createBlocking(struct cirListDeque *q)
+{
+    struct blockingCirListDeque *b = malloc(sizeof(struct blockingCirListDeque));
+    assert(b != 0);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);   //immune to wall clock jumps
+
+    b->q = q;
+    pthread_mutex_init(&b->lock, 0);
+    pthread_cond_init(&b->notEmpty, &attr);
+    pthread_cond_init(&b->notFull, &attr);
+    pthread_condattr_destroy(&attr);
+    b->waiters = 0;
+    b->putWaiters = 0;
+    b->closed = 0;
+    return b;
+}
+
+/* Create an empty, open blocking deque
+
+	pre:	none
+	post:	the deque, its lock and condition variables are initialized
+*/
+struct blockingCirListDeque *createBlockingCirListDeque()
+{
+    return _createBlocking(createCirListDeque());
+}
+
+/* Create an empty, open blocking deque holding at most capacity values.
+   Its links are preallocated and adds to a full deque wait for room.
+
+	param: 	capacity	most values the deque holds
+	pre:	capacity > 0
+	post:	the deque, its lock and condition variables are initialized
+*/
+struct blockingCirListDeque *createBoundedBlockingCirListDeque(int capacity)
+{
+    assert(capacity > 0);
+    return _createBlocking(createBoundedCirListDeque(capacity, BOUNDED_REJECT));
+}
+
+/* Deallocate the deque and any values left in it
+
+	param: 	b		pointer to the deque
+	pre:	b is not null, no thread is using or waiting on b
+	post:	b is freed
+*/
+void deleteBlockingCirListDeque(struct blockingCirListDeque *b)
+{
+    if (b == 0)
+        _gracefulExit("Passed null blockingCirListDeque ptr to deleteBlockingCirListDeque", 1);
+
+    deleteCirListDeque(b->q);
+    pthread_cond_destroy(&b->notEmpty);
+    pthread_cond_destroy(&b->notFull);
+    pthread_mutex_destroy(&b->lock);
+    free(b);
+}
+
+/* Check whether the deque is empty
+
+	param: 	b		pointer to the deque
+	pre:	b is not null
+	ret: 	1 if the deque was empty when checked. Otherwise, 0.
+*/
+int isEmptyBlockingCirListDeque(struct blockingCirListDeque *b)
+{
+    if (b == 0)
+        _gracefulExit("Passed null blockingCirListDeque ptr to isEmptyBlockingCirListDeque", 2);
+
+    pthread_mutex_lock(&b->lock);
+    int empty = isEmptyCirListDeque(b->q);
+    pthread_mutex_unlock(&b->lock);
+    return empty;
+}
+
+/* Number of values in the deque
+
+	param: 	b		pointer to the deque
+	pre:	b is not null
+	ret: 	the number of values when checked
+*/
+int sizeBlockingCirListDeque(struct blockingCirListDeque *b)
+{
+    if (b == 0)
+        _gracefulExit("Passed null blockingCirListDeque ptr to sizeBlockingCirListDeque", 3);
+
+    int size = 0;
+    pthread_mutex_lock(&b->lock);
+    size = sizeCirListDeque(b->q);
+    pthread_mutex_unlock(&b->lock);
+    return size;
+}
+
+/* Add a value at either end and wake one waiting consumer, first
+   waiting for room if the deque is bounded and full
+
+	param: 	b		pointer to the deque
+	param: 	val		value to add
+	param: 	front	1 to add at the front, 0 at the back
+	ret: 	1 on success, 0 if the deque is closed
+*/
+static int _addBlocking(struct blockingCirListDeque *b, TYPE val, int front)
+{
+    pthread_mutex_lock(&b->lock);
+
+    while (!b->closed && isFullCirListDeque(b->q)) {
+        b->putWaiters++;
+        pthread_cond_wait(&b->notFull, &b->lock);
+        b->putWaiters--;
+    }
+
+    if (b->closed) {
+        pthread_mutex_unlock(&b->lock);
+        return 0;
+    }
+
+    if (front)
+        addFrontCirListDeque(b->q, val);
+    else
+        addBackCirListDeque(b->q, val);
+
+    int wake = b->waiters > 0;
+    pthread_mutex_unlock(&b->lock);
+
+    if (wake)
+        pthread_cond_signal(&b->notEmpty);
+    return 1;
+}
+
+/* Add a value to the back of the deque
+
+	param: 	b		pointer to the deque
+	param: 	val		value to add
+	pre:	b is not null
+	ret: 	1 on success, 0 if the deque is closed
+*/
+int addBackBlockingCirListDeque(struct blockingCirListDeque *b, TYPE val)
+{
+    if (b == 0)
+        _gracefulExit("Passed null blockingCirListDeque ptr to addBackBlockingCirListDeque", 4);
+
+    return _addBlocking(b, val, 0);
+}
+
+/* Add a value to the front of the deque
+
+	param: 	b		pointer to the deque
+	param: 	val		value to add
+	pre:	b is not null
+	ret: 	1 on success, 0 if the deque is closed
+*/
+int addFrontBlockingCirListDeque(struct blockingCirListDeque *b, TYPE val)
+{
+    if (b == 0)
+        _gracefulExit("Passed null blockingCirListDeque ptr to addFrontBlockingCirListDeque", 5);
+
+    return _addBlocking(b, val, 1);
+}
+
+/* Sleep until the deque is non-empty, closed or the timeout passes
+
+	param: 	b			pointer to the deque, locked by the caller
+	param: 	timeoutMs	< 0 waits forever, 0 returns at once
+	post:	b->lock is still held
+	ret: 	BLOCKING_OK if a value is available, else BLOCKING_TIMEOUT or
+			BLOCKING_CLOSED
+*/
+static int _waitNotEmpty(struct blockingCirListDeque *b, int timeoutMs)
+{
+    struct timespec deadline;
+
+    if (timeoutMs > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeoutMs / 1000;
+        deadline.tv_nsec += (long)(timeoutMs % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    while (isEmptyCirListDeque(b->q)) {
+        if (b->closed)
+            return BLOCKING_CLOSED;
+        if (timeoutMs == 0)
+            return BLOCKING_TIMEOUT;
+
+        b->waiters++;
+        int rc = (timeoutMs < 0) ? pthread_cond_wait(&b->notEmpty, &b->lock)
+                                 : pthread_cond_timedwait(&b->notEmpty, &b->lock, &deadline);
+        b->waiters--;
+
+        if (rc != 0 && isEmptyCirListDeque(b->q))
+            return b->closed ? BLOCKING_CLOSED : BLOCKING_TIMEOUT;
+    }
+    return BLOCKING_OK;
+}
+
+/* Remove a value from either end, waiting for one if needed */
+static int _removeBlocking(struct blockingCirListDeque *b, TYPE *val, int timeoutMs, int front)
+{
+    pthread_mutex_lock(&b->lock);
+
+    int rc = _waitNotEmpty(b, timeoutMs);
+    if (rc == BLOCKING_OK) {
+        if (front) {
+            *val = frontCirListDeque(b->q);
+            removeFrontCirListDeque(b->q);
+        }
+        else {
+            *val = backCirListDeque(b->q);
+            removeBackCirListDeque(b->q);
+        }
+    }
+
+    int wake = rc == BLOCKING_OK && b->putWaiters > 0;
+    pthread_mutex_unlock(&b->lock);
+
+    if (wake)
+        pthread_cond_signal(&b->notFull);
+    return rc;
+}
+
+/* Remove the front value, waiting up to timeoutMs for one to arrive
+
+	param: 	b			pointer to the deque
+	param: 	val			receives the removed value
+	param: 	timeoutMs	< 0 waits forever, 0 only polls
+	pre:	b is not null, val is not null
+	ret: 	BLOCKING_OK, BLOCKING_TIMEOUT, or BLOCKING_CLOSED once the
+			deque is closed and empty
+*/
+int removeFrontBlockingCirListDeque(struct blockingCirListDeque *b, TYPE *val, int timeoutMs)
+{
+    if (b == 0)
+        _gracefulExit("Passed null blockingCirListDeque ptr to removeFrontBlockingCirListDeque", 6);
+
+    assert(val != 0);
+    return _removeBlocking(b, val, timeoutMs, 1);
+}
+
+/* Remove the back value, waiting up to timeoutMs for one to arrive
+
+	param: 	b			pointer to the deque
+	param: 	val			receives the removed value
+	param: 	timeoutMs	< 0 waits forever, 0 only polls
+	pre:	b is not null, val is not null
+	ret: 	BLOCKING_OK, BLOCKING_TIMEOUT, or BLOCKING_CLOSED once the
+			deque is closed and empty
+*/
+int removeBackBlockingCirListDeque(struct blockingCirListDeque *b, TYPE *val, int timeoutMs)
+{
+    if (b == 0)
+        _gracefulExit("Passed null blockingCirListDeque ptr to removeBackBlockingCirListDeque", 7);
+
+    assert(val != 0);
+    return _removeBlocking(b, val, timeoutMs, 0);
+}
+
+/* Wait once for values, then take up to max of them from the front
+
+	param: 	b			pointer to the deque
+	param: 	vals		receives the removed values in front to back order
+	param: 	max			capacity of vals
+	param: 	timeoutMs	< 0 waits forever, 0 only polls
+	pre:	b is not null, vals holds at least max values, max > 0
+	ret: 	number of values taken, 0 on timeout, or BLOCKING_CLOSED once
+			the deque is closed and empty
+*/
+int drainBlockingCirListDeque(struct blockingCirListDeque *b, TYPE *vals, int max, int timeoutMs)
+{
+    if (b == 0)
+        _gracefulExit("Passed null blockingCirListDeque ptr to drainBlockingCirListDeque", 8);
+
+    assert(vals != 0 && max > 0);
+
+    pthread_mutex_lock(&b->lock);
+
+    int rc = _waitNotEmpty(b, timeoutMs), count = 0;
+    if (rc == BLOCKING_OK) {
+        while (count < max && !isEmptyCirListDeque(b->q)) {
+            vals[count++] = frontCirListDeque(b->q);
+            removeFrontCirListDeque(b->q);
+        }
+        rc = count;
+    }
+
+    int wake = rc > 0 && b->putWaiters > 0;
+    pthread_mutex_unlock(&b->lock);
+
+    if (wake)
+        pthread_cond_broadcast(&b->notFull);
+    return rc;
+}
+
+/* Close the deque: adds fail from now on and every waiter, producers
+   blocked on a full deque included, wakes up.
+   Values already in the deque can still be removed.
+
+	param: 	b		pointer to the deque
+	pre:	b is not null
+	post:	b is closed
+*/
+void closeBlockingCirListDeque(struct blockingCirListDeque *b)
+{
+    if (b == 0)
+        _gracefulExit("Passed null blockingCirListDeque ptr to closeBlockingCirListDeque", 9);
+
+    pthread_mutex_lock(&b->lock);
+    b->closed = 1;
+    pthread_mutex_unlock(&b->lock);
+    pthread_cond_broadcast(&b->notEmpty);
+    pthread_cond_broadcast(&b->notFull);
+}
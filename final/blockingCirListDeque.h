@@ -0,0 +1,40 @@
+#ifndef __BLOCKINGCIRLISTDEQUE_H
+#define __BLOCKINGCIRLISTDEQUE_H
+
+#include "cirListDeque.h"
+
+/* Thread-safe cirListDeque whose removals sleep until a value arrives,
+   the timeout passes or the deque is closed */
+struct blockingCirListDeque;
+
+/* results of the blocking removals */
+# define BLOCKING_OK       1
+# define BLOCKING_TIMEOUT  0
+# define BLOCKING_CLOSED (-1)
+
+/* timeoutMs < 0 waits forever, 0 only polls */
+# define BLOCKING_FOREVER (-1)
+
+struct blockingCirListDeque *createBlockingCirListDeque();
+
+/* preallocated deque of at most capacity values; adds wait while it is full */
+struct blockingCirListDeque *createBoundedBlockingCirListDeque(int capacity);
+void deleteBlockingCirListDeque(struct blockingCirListDeque *b);
+
+int  isEmptyBlockingCirListDeque(struct blockingCirListDeque *b);
+int  sizeBlockingCirListDeque(struct blockingCirListDeque *b);
+
+/* adds return 1, or 0 if the deque has been closed, also while waiting for room */
+int  addBackBlockingCirListDeque(struct blockingCirListDeque *b, TYPE val);
+int  addFrontBlockingCirListDeque(struct blockingCirListDeque *b, TYPE val);
+
+int  removeFrontBlockingCirListDeque(struct blockingCirListDeque *b, TYPE *val, int timeoutMs);
+int  removeBackBlockingCirListDeque(struct blockingCirListDeque *b, TYPE *val, int timeoutMs);
+
+/* waits once, then takes up to max values from the front; returns the
+   count taken, 0 on timeout or BLOCKING_CLOSED once closed and empty */
+int  drainBlockingCirListDeque(struct blockingCirListDeque *b, TYPE *vals, int max, int timeoutMs);
+
+void closeBlockingCirListDeque(struct blockingCirListDeque *b);
+
+#endif
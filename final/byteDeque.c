@@ -0,0 +1,358 @@
+/* byteDeque.c
+ * byte record deque implementation file.
+ 
+ Description:   Records are stored inline, one after another, in a doubly
+                linked chain of arenas. Each record is framed as
+                [len][bytes][len] with 4 byte lengths: the leading length
+                lets the front be popped, the trailing one the back. Adds at
+                the back fill an arena upwards from its used region, adds at
+                the front fill downwards, and a new arena is chained on at
+                that end when the record does not fit. Views point straight
+                into the arena, so no record is copied after it is added.
+
+                An arena emptied by removals is unlinked and kept as a spare
+                for the next arena the deque needs, so a queue in steady
+                state cycles between two arenas without calling malloc.
+ **** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include "byteDeque.h"
+
+# define BYTE_ARENA_SIZE (1 << 20)
+# define BYTE_FRAME      (2 * (int)sizeof(uint32_t))
+
+struct arena {
+    struct arena *prev;         /* toward the front */
+    struct arena *next;         /* toward the back */
+    int capacity;
+    int start;                  /* first used byte */
+    int end;                    /* one past the last used byte */
+    unsigned char data[];
+};
+
+struct byteDeque {
+    struct arena *head;         /* arena holding the front record */
+    struct arena *tail;         /* arena holding the back record */
+    struct arena *spare;        /* emptied arena kept for reuse */
+    int arenaSize;
+    int size;                   /* number of records */
+};
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* An empty arena with room for at least need bytes, the spare if it fits */
+static struct arena *_getArena(struct byteDeque *d, int need)
+{
+    struct arena *a;
+
+    if (d->spare != 0 && d->spare->capacity >= need) {
+        a = d->spare;
+        d->spare = 0;
+    }
+    else {
+        int capacity = (need > d->arenaSize) ? need : d->arenaSize;
+        a = malloc(sizeof(struct arena) + capacity);
+        assert(a != 0);
+        a->capacity = capacity;
+    }
+    a->prev = a->next = 0;
+    return a;
+}
+
+/* Keep an arena no longer in the chain as the spare, or free it */
+static void _putArena(struct byteDeque *d, struct arena *a)
+{
+    if (d->spare == 0 && a->capacity == d->arenaSize)
+        d->spare = a;
+    else
+        free(a);
+}
+
+/* Write one framed record at p */
+static void _writeRecord(unsigned char *p, const void *data, int len)
+{
+    uint32_t n = (uint32_t)len;
+
+    memcpy(p, &n, sizeof(n));
+    memcpy(p + sizeof(n), data, len);
+    memcpy(p + sizeof(n) + len, &n, sizeof(n));
+}
+
+static int _readLen(const unsigned char *p)
+{
+    uint32_t n;
+    memcpy(&n, p, sizeof(n));
+    return (int)n;
+}
+
+/* Arena at the requested end to add a record of need bytes to. Only the
+   last arena of an empty deque is ever empty; it is reset so the whole
+   arena is free at that end, or swapped for a bigger one, rather than
+   leaving an empty arena in the chain. */
+static struct arena *_roomInEmpty(struct byteDeque *d, int need, int front)
+{
+    struct arena *a = front ? d->head : d->tail;
+
+    if (d->size > 0)
+        return a;
+
+    if (a->capacity < need) {
+        _putArena(d, a);
+        a = d->head = d->tail = _getArena(d, need);
+    }
+    a->start = a->end = front ? a->capacity : 0;
+    return a;
+}
+
+/* Create an empty deque
+
+	param: 	arenaSize	bytes per arena, <= 0 for the default of 1MB
+	pre:	none
+	post:	the deque holds one arena with room at both ends
+*/
+struct byteDeque *createByteDeque(int arenaSize)
+{
+    struct byteDeque *d = malloc(sizeof(struct byteDeque));
+    assert(d != 0);
+
+    d->arenaSize = (arenaSize > 0) ? arenaSize : BYTE_ARENA_SIZE;
+    d->spare = 0;
+    d->size = 0;
+    d->head = d->tail = _getArena(d, d->arenaSize);
+    d->head->start = d->head->end = d->arenaSize / 2;
+    return d;
+}
+
+/* Deallocate the deque, all arenas and the spare
+
+	param: 	d		pointer to the deque
+	pre:	d is not null
+	post:	every view into d is invalid
+*/
+void deleteByteDeque(struct byteDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null byteDeque ptr to deleteByteDeque", 1);
+
+    struct arena *a = d->head, *next;
+    while (a != 0) {
+        next = a->next;
+        free(a);
+        a = next;
+    }
+    free(d->spare);
+    free(d);
+}
+
+/* Check whether the deque is empty
+
+	param: 	d		pointer to the deque
+	pre:	d is not null
+	ret: 	1 if the deque is empty. Otherwise, 0.
+*/
+int isEmptyByteDeque(struct byteDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null byteDeque ptr to isEmptyByteDeque", 2);
+
+    return d->size == 0;
+}
+
+/* Number of records in the deque
+
+	param: 	d		pointer to the deque
+	pre:	d is not null
+	ret: 	the number of records
+*/
+int sizeByteDeque(struct byteDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null byteDeque ptr to sizeByteDeque", 3);
+
+    return d->size;
+}
+
+/* Copy a record to the back of the deque
+
+	param: 	d		pointer to the deque
+	param: 	data	the record bytes
+	param: 	len		number of bytes, may be 0
+	pre:	d is not null, data is not null or len is 0
+	post:	the record is the back of the deque
+*/
+void addBackByteDeque(struct byteDeque *d, const void *data, int len)
+{
+    if (d == 0)
+        _gracefulExit("Passed null byteDeque ptr to addBackByteDeque", 4);
+
+    assert(len >= 0 && (data != 0 || len == 0));
+
+    int need = len + BYTE_FRAME;
+    struct arena *a = _roomInEmpty(d, need, 0);
+
+    if (a->capacity - a->end < need) {
+        struct arena *fresh = _getArena(d, need);
+        fresh->start = fresh->end = 0;
+        fresh->prev = a;
+        a->next = fresh;
+        d->tail = a = fresh;
+    }
+
+    _writeRecord(a->data + a->end, data, len);
+    a->end += need;
+    d->size++;
+}
+
+/* Copy a record to the front of the deque
+
+	param: 	d		pointer to the deque
+	param: 	data	the record bytes
+	param: 	len		number of bytes, may be 0
+	pre:	d is not null, data is not null or len is 0
+	post:	the record is the front of the deque
+*/
+void addFrontByteDeque(struct byteDeque *d, const void *data, int len)
+{
+    if (d == 0)
+        _gracefulExit("Passed null byteDeque ptr to addFrontByteDeque", 5);
+
+    assert(len >= 0 && (data != 0 || len == 0));
+
+    int need = len + BYTE_FRAME;
+    struct arena *a = _roomInEmpty(d, need, 1);
+
+    if (a->start < need) {
+        struct arena *fresh = _getArena(d, need);
+        fresh->start = fresh->end = fresh->capacity;
+        fresh->next = a;
+        a->prev = fresh;
+        d->head = a = fresh;
+    }
+
+    a->start -= need;
+    _writeRecord(a->data + a->start, data, len);
+    d->size++;
+}
+
+/* View the front record without copying it
+
+	param: 	d		pointer to the deque
+	pre:	d is not null and d is not empty
+	ret: 	view of the front record, valid until it is removed
+*/
+struct byteView frontByteDeque(struct byteDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null byteDeque ptr to frontByteDeque", 6);
+
+    if (d->size < 1)
+        _gracefulExit("Passed empty byteDeque to frontByteDeque", 7);
+
+    struct byteView v;
+    const unsigned char *p = d->head->data + d->head->start;
+    v.len = _readLen(p);
+    v.data = p + sizeof(uint32_t);
+    return v;
+}
+
+/* View the back record without copying it
+
+	param: 	d		pointer to the deque
+	pre:	d is not null and d is not empty
+	ret: 	view of the back record, valid until it is removed
+*/
+struct byteView backByteDeque(struct byteDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null byteDeque ptr to backByteDeque", 8);
+
+    if (d->size < 1)
+        _gracefulExit("Passed empty byteDeque to backByteDeque", 9);
+
+    struct byteView v;
+    const unsigned char *p = d->tail->data + d->tail->end;
+    v.len = _readLen(p - sizeof(uint32_t));
+    v.data = p - sizeof(uint32_t) - v.len;
+    return v;
+}
+
+/* Unlink an arena emptied by a removal, or recenter the last one */
+static void _retireArena(struct byteDeque *d, struct arena *a)
+{
+    if (d->head == d->tail) {
+        a->start = a->end = a->capacity / 2;
+        return;
+    }
+
+    if (a == d->head) {
+        d->head = a->next;
+        d->head->prev = 0;
+    }
+    else {
+        d->tail = a->prev;
+        d->tail->next = 0;
+    }
+    _putArena(d, a);
+}
+
+/* Remove the front record
+
+	param: 	d		pointer to the deque
+	pre:	d is not null and d is not empty
+	post:	views of the front record are invalid
+*/
+void removeFrontByteDeque(struct byteDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null byteDeque ptr to removeFrontByteDeque", 10);
+
+    if (d->size < 1)
+        _gracefulExit("Passed empty byteDeque to removeFrontByteDeque", 11);
+
+    struct arena *a = d->head;
+    a->start += _readLen(a->data + a->start) + BYTE_FRAME;
+    d->size--;
+
+    if (a->start == a->end)
+        _retireArena(d, a);
+}
+
+/* Remove the back record
+
+	param: 	d		pointer to the deque
+	pre:	d is not null and d is not empty
+	post:	views of the back record are invalid
+*/
+void removeBackByteDeque(struct byteDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null byteDeque ptr to removeBackByteDeque", 12);
+
+    if (d->size < 1)
+        _gracefulExit("Passed empty byteDeque to removeBackByteDeque", 13);
+
+    struct arena *a = d->tail;
+    a->end -= _readLen(a->data + a->end - sizeof(uint32_t)) + BYTE_FRAME;
+    d->size--;
+
+    if (a->start == a->end)
+        _retireArena(d, a);
+}
@@ -0,0 +1,26 @@
+#ifndef __BYTEDEQUE_H
+#define __BYTEDEQUE_H
+
+/* Deque of variable length byte records stored inline in large arenas */
+struct byteDeque;
+
+/* Read-only view of a record, valid until that record is removed */
+struct byteView {
+    const unsigned char *data;
+    int len;
+};
+
+/* arenaSize <= 0 selects the default arena size */
+struct byteDeque *createByteDeque(int arenaSize);
+void deleteByteDeque(struct byteDeque *d);
+
+int  isEmptyByteDeque(struct byteDeque *d);
+int  sizeByteDeque(struct byteDeque *d);
+void addBackByteDeque(struct byteDeque *d, const void *data, int len);
+void addFrontByteDeque(struct byteDeque *d, const void *data, int len);
+struct byteView frontByteDeque(struct byteDeque *d);
+struct byteView backByteDeque(struct byteDeque *d);
+void removeFrontByteDeque(struct byteDeque *d);
+void removeBackByteDeque(struct byteDeque *d);
+
+#endif
@@ -13,6 +13,11 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <float.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/mman.h>
 #include "cirListDeque.h"
 
 /* Double Link Struture */
@@ -32,12 +37,120 @@ struct DLink {
 struct cirListDeque {
 	int size;/* number of links in the deque */
 	struct DLink *Sentinel;	/* pointer to the sentinel */
+	struct _linkSlab *slabs;	/* blocks filled by compaction, newest first */
+	struct _linkSlab *compactSlab;	/* block the running compaction pass fills */
+	struct DLink *compactCursor;	/* last link moved by the running pass, else null */
+	int capacity;	/* most links a bounded deque holds, 0 if unbounded */
+	int policy;	/* BOUNDED_* behaviour of a full bounded deque */
+	struct DLink *pool;	/* sentinel and links of a bounded deque, one block */
+	struct DLink *freeLinks;	/* unused pool links, chained through next */
+# ifdef TRACE_OPS
+	struct opTrace *trace;	/* records every deque call when not null */
+# endif
 };
+
+# ifdef TRACE_OPS
+#include "opTrace.h"
+# define TRACE(Q, OP, V) do { if ((Q)->trace != 0) recordOpTrace((Q)->trace, OP, (double)(V)); } while (0)
+# else
+# define TRACE(Q, OP, V)
+# endif
+
+# ifdef NODE_CACHE
+#include "nodeCache.h"
+#include <pthread.h>
+
+static struct nodePool *_linkPool;
+static pthread_once_t _linkPoolOnce = PTHREAD_ONCE_INIT;
+
+static void _initLinkPool() {
+    _linkPool = createNodePool(sizeof(struct DLink));
+}
+# endif
+
+/* Allocate a link, from the calling thread's node cache when built with
+   -DNODE_CACHE and from malloc otherwise */
+struct DLink *_allocLink() {
+# ifdef NODE_CACHE
+    pthread_once(&_linkPoolOnce, _initLinkPool);
+    return allocNode(_linkPool);
+# else
+    return malloc(sizeof(struct DLink));
+# endif
+}
+
+/* Free a link allocated by _allocLink */
+void _freeLink(struct DLink *l) {
+# ifdef NODE_CACHE
+    freeNode(_linkPool, l);
+# else
+    free(l);
+# endif
+}
+
+/* Contiguous block of links handed out in deque order by compaction. The
+   block is freed once every link carved from it has been released. */
+struct _linkSlab {
+    struct _linkSlab *next;
+    int capacity;
+    int used;               /* links handed out */
+    int live;               /* links handed out and not yet released */
+    size_t released;        /* bytes of dead links returned to the OS by shrinkCirListDeque */
+    struct DLink links[];
+};
+
+# define COMPACT_MIN_SLAB 64
+
+/* Unlink a slab with no live links from the deque and free it */
+void _dropSlab(struct cirListDeque *q, struct _linkSlab *slab)
+{
+    struct _linkSlab **p = &q->slabs;
+
+    while (*p != slab)
+        p = &(*p)->next;
+    *p = slab->next;
+    free(slab);
+}
+
+/* Slab a link was carved from, or null if it came from _allocLink */
+struct _linkSlab *_slabOf(struct cirListDeque *q, struct DLink *l)
+{
+    uintptr_t a = (uintptr_t)l;
+
+    for (struct _linkSlab *s = q->slabs; s != 0; s = s->next)
+        if (a >= (uintptr_t)s->links && a < (uintptr_t)(s->links + s->capacity))
+            return s;
+    return 0;
+}
+
+/* Return an unlinked link to its slab, or to _freeLink if it came from
+   _allocLink */
+void _releaseLink(struct cirListDeque *q, struct DLink *l)
+{
+    //a bounded deque only ever holds pool links
+    if (q->capacity > 0) {
+        l->next = q->freeLinks;
+        q->freeLinks = l;
+        return;
+    }
+
+    struct _linkSlab *s = _slabOf(q, l);
+    if (s == 0) {
+        _freeLink(l);
+        return;
+    }
+
+    //the slab being filled stays until its pass moves on
+    if (--s->live == 0 && s != q->compactSlab)
+        _dropSlab(q, s);
+}
 /* internal functions prototypes */
 struct DLink* _createLink (TYPE val);
 void _addLinkAfter(struct cirListDeque *q, struct DLink *lnk, TYPE v);
 void _removeLink(struct cirListDeque *q, struct DLink *lnk);
 void _gracefulExit(char *message, int errorCode);
+void _endCompaction(struct cirListDeque *q);
+int _makeRoom(struct cirListDeque *q, int front);
 
 
 
@@ -56,15 +169,25 @@ void _initCirListDeque (struct cirListDeque *q)
     //pre-conditions
     assert(q != 0);
     
-    struct DLink *sentinel = malloc(sizeof(struct DLink));
+    struct DLink *sentinel = _allocLink();
     assert(sentinel != 0);
     
-    sentinel->value = 0;
+    memset(&sentinel->value, 0, sizeof(TYPE));
     sentinel->next = sentinel;
     sentinel->prev = sentinel;
     
     q->size = 0;
     q->Sentinel = sentinel;
+    q->slabs = 0;
+    q->compactSlab = 0;
+    q->compactCursor = 0;
+    q->capacity = 0;
+    q->policy = BOUNDED_OVERWRITE;
+    q->pool = 0;
+    q->freeLinks = 0;
+# ifdef TRACE_OPS
+    q->trace = 0;
+# endif
 }
 
 /*
@@ -79,6 +202,52 @@ struct cirListDeque *createCirListDeque()
 	return(newCL);
 }
 
+/* Create a deque that holds at most capacity values. The sentinel and
+   every link are allocated here in one block, so adds and removes never
+   allocate or free afterwards.
+
+	param: 	capacity	most values the deque holds
+	param: 	policy		BOUNDED_OVERWRITE or BOUNDED_REJECT, what an add
+						to a full deque does
+	pre:	capacity > 0
+	post:	an empty deque with capacity free links
+*/
+struct cirListDeque *createBoundedCirListDeque(int capacity, int policy)
+{
+    assert(capacity > 0);
+    assert(policy == BOUNDED_OVERWRITE || policy == BOUNDED_REJECT);
+
+    struct cirListDeque *q = malloc(sizeof(struct cirListDeque));
+    assert(q != 0);
+
+    q->pool = malloc(sizeof(struct DLink) * (capacity + 1));
+    assert(q->pool != 0);
+
+    struct DLink *sentinel = &q->pool[0];
+    memset(&sentinel->value, 0, sizeof(TYPE));
+    sentinel->next = sentinel;
+    sentinel->prev = sentinel;
+
+    //free list in address order, so the first fill walks memory forward
+    q->freeLinks = 0;
+    for (int i = capacity; i >= 1; i--) {
+        q->pool[i].next = q->freeLinks;
+        q->freeLinks = &q->pool[i];
+    }
+
+    q->size = 0;
+    q->Sentinel = sentinel;
+    q->slabs = 0;
+    q->compactSlab = 0;
+    q->compactCursor = 0;
+    q->capacity = capacity;
+    q->policy = policy;
+# ifdef TRACE_OPS
+    q->trace = 0;
+# endif
+    return q;
+}
+
 
 /* Create a link for a value.
 
@@ -88,7 +257,7 @@ struct cirListDeque *createCirListDeque()
 */
 struct DLink * _createLink (TYPE val)
 {
-    struct DLink *newLink = malloc(sizeof(struct DLink));
+    struct DLink *newLink = _allocLink();
     assert(newLink != 0);
     
     newLink->value = val;
@@ -115,7 +284,17 @@ void _addLinkAfter(struct cirListDeque *q, struct DLink *lnk, TYPE v)
     assert(q != 0);
     assert(lnk != 0);
     
-    struct DLink *newLink = _createLink(v);
+    struct DLink *newLink;
+
+    if (q->capacity > 0) {
+        //bounded deques take a pool link, the caller made room
+        newLink = q->freeLinks;
+        assert(newLink != 0);
+        q->freeLinks = newLink->next;
+        newLink->value = v;
+    }
+    else
+        newLink = _createLink(v);
     
     //new link pointers
     newLink->next = lnk->next;
@@ -157,7 +336,11 @@ void addBackCirListDeque (struct cirListDeque *q, TYPE val)
     if (q == 0)
         _gracefulExit("Passed null cirListDeque ptr to addBackCirListDeque", 1);
     
+    if (!_makeRoom(q, 0))
+        _gracefulExit("Passed full cirListDeque to addBackCirListDeque", 22);
+
     //else
+    TRACE(q, TRACE_ADD_BACK, KEY(val));
     _addLinkAfter(q, (q->Sentinel)->prev, val);
 
 }
@@ -175,11 +358,82 @@ void addFrontCirListDeque(struct cirListDeque *q, TYPE val)
     if (q == 0)
         _gracefulExit("Passed null cirListDeque ptr to addFrontCirListDeque", 2);
     
+    if (!_makeRoom(q, 1))
+        _gracefulExit("Passed full cirListDeque to addFrontCirListDeque", 23);
+
     //else
+    TRACE(q, TRACE_ADD_FRONT, KEY(val));
     _addLinkAfter(q, q->Sentinel, val);
 
 }
 
+/* Make room for one more link in a full bounded deque
+
+	param: 	q		pointer to the deque
+	param: 	front	1 if the link goes to the front, 0 if to the back
+	pre:	q is not null
+	post:	under BOUNDED_OVERWRITE a full deque has lost the value at the
+			end opposite the add, traced as a remove ahead of the add
+	ret: 	1 if a link can be added, 0 if a full deque rejects it
+*/
+int _makeRoom(struct cirListDeque *q, int front)
+{
+    if (q->capacity == 0 || q->size < q->capacity)
+        return 1;
+
+    if (q->policy == BOUNDED_REJECT)
+        return 0;
+
+    //a replay has to evict the same value before the add
+    TRACE(q, front ? TRACE_REMOVE_BACK : TRACE_REMOVE_FRONT, 0);
+    _removeLink(q, front ? (q->Sentinel)->prev : (q->Sentinel)->next);
+    return 1;
+}
+
+/* Adds a link to the back of the deque unless it is full and rejects adds
+
+	param: 	q		pointer to the deque
+	param: 	val		value for the link to be added
+	pre:	q is not null
+	post:	as addBackCirListDeque, or q is unchanged
+	ret: 	1 if val was added, 0 if a full BOUNDED_REJECT deque refused it
+*/
+int tryAddBackCirListDeque(struct cirListDeque *q, TYPE val)
+{
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to tryAddBackCirListDeque", 24);
+
+    if (!_makeRoom(q, 0))
+        return 0;
+
+    TRACE(q, TRACE_ADD_BACK, KEY(val));
+    _addLinkAfter(q, (q->Sentinel)->prev, val);
+    return 1;
+}
+
+/* Adds a link to the front of the deque unless it is full and rejects adds
+
+	param: 	q		pointer to the deque
+	param: 	val		value for the link to be added
+	pre:	q is not null
+	post:	as addFrontCirListDeque, or q is unchanged
+	ret: 	1 if val was added, 0 if a full BOUNDED_REJECT deque refused it
+*/
+int tryAddFrontCirListDeque(struct cirListDeque *q, TYPE val)
+{
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to tryAddFrontCirListDeque", 25);
+
+    if (!_makeRoom(q, 1))
+        return 0;
+
+    TRACE(q, TRACE_ADD_FRONT, KEY(val));
+    _addLinkAfter(q, q->Sentinel, val);
+    return 1;
+}
+
 /* Get the value of the front of the deque
 
 	param: 	q		pointer to the deque
@@ -196,6 +450,8 @@ TYPE frontCirListDeque(struct cirListDeque *q)
     if (q->size < 1)
         _gracefulExit("Passed empty cirListDeque to frontCirListDeque", 4);
     
+    TRACE(q, TRACE_FRONT, 0);
+
 	return ((q->Sentinel)->next)->value;
 }
 
@@ -215,6 +471,8 @@ TYPE backCirListDeque(struct cirListDeque *q)
     if (q->size < 1)
         _gracefulExit("Passed empty cirListDeque to backCirListDeque", 6);
     
+    TRACE(q, TRACE_BACK, 0);
+
     return ((q->Sentinel)->prev)->value;
 }
 
@@ -238,7 +496,11 @@ void _removeLink(struct cirListDeque *q, struct DLink *lnk)
     
     q->size--;
     
-    free(lnk);
+    //a running compaction resumes after the link before lnk
+    if (q->compactCursor == lnk)
+        q->compactCursor = lnk->prev;
+
+    _releaseLink(q, lnk);
 }
 
 /* Remove the front of the deque
@@ -256,6 +518,8 @@ void removeFrontCirListDeque (struct cirListDeque *q) {
     if (q->size < 1)
         _gracefulExit("Passed empty cirListDeque to removeFrontCirListDeque", 8);
     
+    TRACE(q, TRACE_REMOVE_FRONT, 0);
+
     _removeLink(q, (q->Sentinel)->next);
 }
 
@@ -275,6 +539,8 @@ void removeBackCirListDeque(struct cirListDeque *q)
     if (q->size < 1)
         _gracefulExit("Passed empty cirListDeque to removeBackCirListDeque", 10);
     
+    TRACE(q, TRACE_REMOVE_BACK, 0);
+
     _removeLink(q, (q->Sentinel)->prev);
 }
 
@@ -287,14 +553,24 @@ void removeBackCirListDeque(struct cirListDeque *q)
 void freeCirListDeque(struct cirListDeque *q)
 {
     struct DLink *current = (q->Sentinel)->next, *prev;
+
+    //a bounded deque's links all live in its pool
+    if (q->capacity > 0) {
+        free(q->pool);
+        return;
+    }
     
     while (current != q->Sentinel) {
         prev = current;
         //printf("%.02f, ", prev->value);   //DEBUG
         current = current->next;
-        free(prev);
+        _releaseLink(q, prev);
     }
-    free(q->Sentinel);
+    _freeLink(q->Sentinel);
+
+    //only an emptied slab of an unfinished pass can be left
+    while (q->slabs != 0)
+        _dropSlab(q, q->slabs);
 }
 
 /* 	Deallocate all the links and the deque itself. 
@@ -325,6 +601,69 @@ int isEmptyCirListDeque(struct cirListDeque *q) {
     return (q->size > 0) ? 0 : 1;
 }
 
+/* Number of links in the deque
+
+	param: 	q		pointer to the deque
+	pre:	q is not null
+	ret: 	the size of the deque
+*/
+int sizeCirListDeque(struct cirListDeque *q) {
+
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to sizeCirListDeque", 18);
+
+    return q->size;
+}
+
+/* Check whether a bounded deque is at capacity
+
+	param: 	q		pointer to the deque
+	pre:	q is not null
+	ret: 	1 if q is bounded and holds capacity values. Otherwise, 0.
+*/
+int isFullCirListDeque(struct cirListDeque *q) {
+
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to isFullCirListDeque", 26);
+
+    return q->capacity > 0 && q->size >= q->capacity;
+}
+
+/* Copy the last n values of the deque, front to back, e.g. for dumping
+   the most recent entries of a bounded event log
+
+	param: 	q		pointer to the deque
+	param: 	vals	receives the values, oldest first
+	param: 	n		most values to copy
+	pre:	q is not null, vals holds at least n values
+	ret: 	number of values copied, the smaller of n and the size
+*/
+int copyLastCirListDeque(struct cirListDeque *q, TYPE *vals, int n)
+{
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to copyLastCirListDeque", 27);
+
+    assert(vals != 0 || n <= 0);
+
+    if (n > q->size)
+        n = q->size;
+    if (n <= 0)
+        return 0;
+
+    struct DLink *current = q->Sentinel;
+    for (int i = 0; i < n; i++)
+        current = current->prev;
+
+    for (int i = 0; i < n; i++) {
+        vals[i] = current->value;
+        current = current->next;
+    }
+    return n;
+}
+
 /* Print the links in the deque from front to back
 
 	param: 	q		pointer to the deque
@@ -351,7 +690,7 @@ void printCirListDeque(struct cirListDeque *q)
         
         while (current->next != q->Sentinel) {
             current = current->next;
-            printf("List[%d]: %.02f\n", i, current->value);
+            printf("List[%d]: %.02f\n", i, (double)KEY(current->value));
             i++;
         }
     }
@@ -372,6 +711,10 @@ void reverseCirListDeque(struct cirListDeque *q)
     if (q->size < 1)
         _gracefulExit("Passed empty cirListDeque to reverseCirListDeque", 16);
 
+    //a running compaction cannot follow the flipped links, start over
+    if (q->compactCursor != 0)
+        _endCompaction(q);
+
     struct DLink *current = q->Sentinel, *temp;
     
     //have to do the swap once to get off the sentinel
@@ -388,3 +731,799 @@ void reverseCirListDeque(struct cirListDeque *q)
         current->next = temp;
     }
 }
+
+
+/* ************************************************************************
+	Compaction Functions
+************************************************************************ */
+
+/* Next unused link of the running pass's slab, opening a new slab when
+   the current one is full
+
+	param: 	q		pointer to the deque
+	pre:	q has a compaction pass running
+*/
+struct DLink *_slabLink(struct cirListDeque *q)
+{
+    struct _linkSlab *slab = q->compactSlab;
+
+    if (slab == 0 || slab->used == slab->capacity) {
+        //room for the whole deque keeps a single pass in one block
+        int capacity = q->size > COMPACT_MIN_SLAB ? q->size : COMPACT_MIN_SLAB;
+
+        q->compactSlab = malloc(sizeof(struct _linkSlab) + sizeof(struct DLink) * capacity);
+        assert(q->compactSlab != 0);
+        q->compactSlab->capacity = capacity;
+        q->compactSlab->used = 0;
+        q->compactSlab->live = 0;
+        q->compactSlab->released = 0;
+        q->compactSlab->next = q->slabs;
+        q->slabs = q->compactSlab;
+
+        if (slab != 0 && slab->live == 0)
+            _dropSlab(q, slab);
+        slab = q->compactSlab;
+    }
+
+    slab->live++;
+    return &slab->links[slab->used++];
+}
+
+/* End the running compaction pass, its slab becomes an ordinary one
+
+	param: 	q		pointer to the deque
+	pre:	q is not null
+*/
+void _endCompaction(struct cirListDeque *q)
+{
+    struct _linkSlab *slab = q->compactSlab;
+
+    q->compactCursor = 0;
+    q->compactSlab = 0;
+    if (slab != 0 && slab->live == 0)
+        _dropSlab(q, slab);
+}
+
+/* Move up to maxNodes links into contiguous memory in deque order,
+   continuing the pass started by an earlier call. Adds and removes may
+   happen between calls; links added behind the pass wait for the next one.
+
+	param: 	q			pointer to the deque
+	param: 	maxNodes	most links to move in this call
+	pre:	q is not null, maxNodes > 0
+	post:	the moved links follow each other in memory
+	ret: 	1 while the pass has links left to move, 0 once it is done
+*/
+int compactStepCirListDeque(struct cirListDeque *q, int maxNodes)
+{
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to compactStepCirListDeque", 19);
+
+    assert(maxNodes > 0);
+
+    //a bounded deque already keeps every link in its one pool
+    if (q->capacity > 0)
+        return 0;
+
+    if (q->compactCursor == 0)
+        q->compactCursor = q->Sentinel;     //start a new pass
+
+    for (int moved = 0; moved < maxNodes && q->compactCursor->next != q->Sentinel; moved++) {
+        struct DLink *old = q->compactCursor->next;
+        struct DLink *l = _slabLink(q);
+
+        //take old's place
+        l->value = old->value;
+        l->prev = old->prev;
+        l->next = old->next;
+        (l->prev)->next = l;
+        (l->next)->prev = l;
+
+        _releaseLink(q, old);
+        q->compactCursor = l;
+    }
+
+    if (q->compactCursor->next != q->Sentinel)
+        return 1;
+
+    _endCompaction(q);
+    return 0;
+}
+
+/* Move every link into one freshly allocated block in deque order so
+   traversals read memory sequentially. Finishes a pass already begun by
+   compactStepCirListDeque.
+
+	param: 	q		pointer to the deque
+	pre:	q is not null
+	post:	the links follow each other in memory
+*/
+void compactCirListDeque(struct cirListDeque *q)
+{
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to compactCirListDeque", 20);
+
+    compactStepCirListDeque(q, q->size + 1);
+}
+
+
+/* ************************************************************************
+	Merge Functions
+************************************************************************ */
+
+/* Loser tree over the heads of k sorted runs of links. Leaf i sits at
+   position k + i, internal node n holds the loser of the match played
+   there and tree[0] the overall winner, so replacing the winner replays
+   only the log2(k) matches on its path. */
+struct _loserTree {
+    int k;
+    int *tree;
+    struct DLink **head;    /* next link of each run */
+    struct DLink **end;     /* link that ends each run, its sentinel */
+};
+
+/* Whether run a's head goes before run b's: exhausted runs lose and ties
+   go to the lower run so equal values keep their source order */
+int _beats(struct _loserTree *t, int a, int b)
+{
+    if (t->head[a] == t->end[a])
+        return 0;
+    if (t->head[b] == t->end[b])
+        return 1;
+    if (LT(t->head[b]->value, t->head[a]->value))
+        return 0;
+    return LT(t->head[a]->value, t->head[b]->value) || a < b;
+}
+
+/* Play every match once, heads and ends already set */
+void _buildLoserTree(struct _loserTree *t)
+{
+    int k = t->k;
+    int *winner = malloc(sizeof(int) * 2 * k);
+    assert(winner != 0);
+
+    for (int i = 0; i < k; i++)
+        winner[k + i] = i;
+
+    for (int n = k - 1; n >= 1; n--) {
+        int a = winner[2 * n], b = winner[2 * n + 1];
+        if (_beats(t, a, b)) {
+            winner[n] = a;
+            t->tree[n] = b;
+        }
+        else {
+            winner[n] = b;
+            t->tree[n] = a;
+        }
+    }
+    t->tree[0] = (k == 1) ? 0 : winner[1];
+    free(winner);
+}
+
+/* Replay the matches on the path of run w after its head changed */
+void _replayLoserTree(struct _loserTree *t, int w)
+{
+    for (int n = (t->k + w) / 2; n >= 1; n /= 2) {
+        if (_beats(t, t->tree[n], w)) {
+            int loser = w;
+            w = t->tree[n];
+            t->tree[n] = loser;
+        }
+    }
+    t->tree[0] = w;
+}
+
+/* Allocate a tree over the runs of qs[0 .. k-1] and play it */
+void _initLoserTree(struct _loserTree *t, struct cirListDeque **qs, int k)
+{
+    t->k = k;
+    t->tree = malloc(sizeof(int) * (k > 0 ? k : 1));
+    t->head = malloc(sizeof(struct DLink *) * (k > 0 ? k : 1));
+    t->end = malloc(sizeof(struct DLink *) * (k > 0 ? k : 1));
+    assert(t->tree != 0 && t->head != 0 && t->end != 0);
+
+    for (int i = 0; i < k; i++) {
+        assert(qs[i] != 0);
+        t->head[i] = (qs[i]->Sentinel)->next;
+        t->end[i] = qs[i]->Sentinel;
+    }
+    if (k > 0)
+        _buildLoserTree(t);
+}
+
+void _freeLoserTree(struct _loserTree *t)
+{
+    free(t->tree);
+    free(t->head);
+    free(t->end);
+}
+
+/* Merge k deques, each sorted by LT, onto the back of out. The links are
+   moved rather than copied, with O(log k) comparisons per value; equal
+   values keep the order of their deques in qs.
+
+	param: 	out		pointer to the deque receiving the values
+	param: 	qs		the sorted deques to merge
+	param: 	k		number of deques in qs
+	pre:	out is not null and not bounded, qs holds k distinct unbounded
+			deques other than out
+	post:	out ends with every value of qs in LT order, the deques in qs
+			are empty
+*/
+void mergeCirListDeques(struct cirListDeque *out, struct cirListDeque **qs, int k)
+{
+    //pre-conditions
+    if (out == 0)
+        _gracefulExit("Passed null cirListDeque ptr to mergeCirListDeques", 28);
+
+    assert(qs != 0 || k == 0);
+
+    for (int i = 0; i < k; i++) {
+        assert(qs[i] != out);
+        if (out->capacity > 0 || qs[i]->capacity > 0)
+            _gracefulExit("Passed bounded cirListDeque to mergeCirListDeques", 29);
+
+        //links carved from a slab take the slab with them
+        if (qs[i]->compactCursor != 0)
+            _endCompaction(qs[i]);
+        if (qs[i]->slabs != 0) {
+            struct _linkSlab *last = qs[i]->slabs;
+            while (last->next != 0)
+                last = last->next;
+            last->next = out->slabs;
+            out->slabs = qs[i]->slabs;
+            qs[i]->slabs = 0;
+        }
+    }
+
+    struct _loserTree t;
+    _initLoserTree(&t, qs, k);
+
+    while (k > 0 && t.head[t.tree[0]] != t.end[t.tree[0]]) {
+        int w = t.tree[0];
+        struct DLink *l = t.head[w];
+
+        t.head[w] = l->next;
+
+        //relink l at the back of out
+        l->prev = (out->Sentinel)->prev;
+        l->next = out->Sentinel;
+        (l->prev)->next = l;
+        (out->Sentinel)->prev = l;
+        out->size++;
+
+        _replayLoserTree(&t, w);
+    }
+
+    for (int i = 0; i < k; i++) {
+        (qs[i]->Sentinel)->next = qs[i]->Sentinel;
+        (qs[i]->Sentinel)->prev = qs[i]->Sentinel;
+        qs[i]->size = 0;
+    }
+    _freeLoserTree(&t);
+}
+
+/* Streaming merge of sorted deques, read one value at a time */
+struct cirListDequeMerge {
+    struct _loserTree t;
+};
+
+/* Start a streaming merge of k deques, each sorted by LT. The deques are
+   only read and must not change until the merge is deleted.
+
+	param: 	qs		the sorted deques to merge
+	param: 	k		number of deques in qs
+	pre:	qs holds k deques
+	ret: 	a merge positioned before the smallest value
+*/
+struct cirListDequeMerge *createCirListDequeMerge(struct cirListDeque **qs, int k)
+{
+    //pre-conditions
+    if (qs == 0 && k > 0)
+        _gracefulExit("Passed null cirListDeque array to createCirListDequeMerge", 30);
+
+    struct cirListDequeMerge *m = malloc(sizeof(struct cirListDequeMerge));
+    assert(m != 0);
+    _initLoserTree(&m->t, qs, k);
+    return m;
+}
+
+/* Take the next value of a streaming merge
+
+	param: 	m		pointer to the merge
+	param: 	val		receives the value
+	pre:	m is not null, val is not null
+	ret: 	1 if a value was read, 0 once every deque is exhausted
+*/
+int nextCirListDequeMerge(struct cirListDequeMerge *m, TYPE *val)
+{
+    //pre-conditions
+    if (m == 0)
+        _gracefulExit("Passed null cirListDequeMerge ptr to nextCirListDequeMerge", 31);
+
+    assert(val != 0);
+
+    struct _loserTree *t = &m->t;
+    if (t->k == 0 || t->head[t->tree[0]] == t->end[t->tree[0]])
+        return 0;
+
+    int w = t->tree[0];
+    *val = t->head[w]->value;
+    t->head[w] = t->head[w]->next;
+    _replayLoserTree(t, w);
+    return 1;
+}
+
+/* Free a streaming merge, the deques are left untouched
+
+	param: 	m		pointer to the merge
+	pre:	m is not null
+*/
+void deleteCirListDequeMerge(struct cirListDequeMerge *m)
+{
+    //pre-conditions
+    if (m == 0)
+        _gracefulExit("Passed null cirListDequeMerge ptr to deleteCirListDequeMerge", 32);
+
+    _freeLoserTree(&m->t);
+    free(m);
+}
+
+
+/* ************************************************************************
+	Footprint Functions
+************************************************************************ */
+
+# ifdef __GLIBC__
+#include <malloc.h>
+# endif
+
+/* Bytes a malloc block takes from the heap, its header included */
+size_t _heapBytes(void *p, size_t size)
+{
+    if (p == 0)
+        return 0;
+# ifdef __GLIBC__
+    //the request is a floor should the allocator report less
+    size_t usable = malloc_usable_size(p);
+    if (usable > size)
+        size = usable;
+    return size + sizeof(size_t);
+# else
+    return size;
+# endif
+}
+
+/* Bytes a link from _allocLink takes from its allocator */
+size_t _linkBytes(struct DLink *l)
+{
+# ifdef NODE_CACHE
+    //pool nodes carry no header, the pool's spare nodes are not the deque's
+    (void)l;
+    return sizeof(struct DLink);
+# else
+    return _heapBytes(l, sizeof(struct DLink));
+# endif
+}
+
+/* Report the memory the deque holds. Values count as payload; link
+   pointers, padding, the sentinel and allocator headers as overhead;
+   free links of a bounded deque's pool and slab space holding no live
+   link as reserved. Spare nodes of a -DNODE_CACHE pool are shared by
+   every deque and are reported by residentNodeCache instead.
+
+	param: 	q		pointer to the deque
+	param: 	f		receives the byte counts
+	pre:	q is not null, f is not null
+	post:	f->payload + f->overhead + f->reserved is the deque's footprint
+*/
+void footprintCirListDeque(struct cirListDeque *q, struct memoryFootprint *f)
+{
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to footprintCirListDeque", 33);
+
+    assert(f != 0);
+
+    f->payload = (size_t)q->size * sizeof(TYPE);
+    f->overhead = _heapBytes(q, sizeof(struct cirListDeque));
+    f->reserved = 0;
+
+    if (q->capacity > 0) {
+        size_t pool = sizeof(struct DLink) * (q->capacity + 1);
+
+        f->overhead += _heapBytes(q->pool, pool) - pool
+                       + sizeof(struct DLink) * (q->size + 1) - f->payload;
+        f->reserved = sizeof(struct DLink) * (q->capacity - q->size);
+        return;
+    }
+
+    f->overhead += _linkBytes(q->Sentinel);
+    for (struct DLink *l = (q->Sentinel)->next; l != q->Sentinel; l = l->next) {
+        if (_slabOf(q, l) != 0)
+            f->overhead += sizeof(struct DLink) - sizeof(TYPE);
+        else
+            f->overhead += _linkBytes(l) - sizeof(TYPE);
+    }
+
+    for (struct _linkSlab *s = q->slabs; s != 0; s = s->next) {
+        size_t block = sizeof(struct _linkSlab) + sizeof(struct DLink) * s->capacity;
+
+        f->overhead += _heapBytes(s, block) - sizeof(struct DLink) * s->capacity;
+        f->reserved += sizeof(struct DLink) * (s->capacity - s->live) - s->released;
+    }
+}
+
+/* Whole pages of a slab's links, and which of them hold a live link */
+struct _slabPages {
+    struct _linkSlab *slab;
+    uintptr_t first;        /* first page boundary inside the links */
+    size_t pages;
+    unsigned char *live;
+};
+
+/* Return the whole pages of finished slabs that hold no live link to the
+   OS; compaction never hands those links out again
+
+	param: 	q		pointer to the deque
+	pre:	q is not null
+	ret: 	bytes newly returned
+*/
+size_t _releaseDeadPages(struct cirListDeque *q)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE), released = 0;
+    int slabs = 0, i;
+
+    for (struct _linkSlab *s = q->slabs; s != 0; s = s->next)
+        slabs++;
+    if (slabs == 0)
+        return 0;
+
+    struct _slabPages *sp = malloc(sizeof(struct _slabPages) * slabs);
+    assert(sp != 0);
+
+    i = 0;
+    for (struct _linkSlab *s = q->slabs; s != 0; s = s->next, i++) {
+        uintptr_t start = ((uintptr_t)s->links + page - 1) & ~(uintptr_t)(page - 1);
+        uintptr_t end = (uintptr_t)(s->links + s->capacity) & ~(uintptr_t)(page - 1);
+
+        sp[i].slab = s;
+        sp[i].first = start;
+        sp[i].pages = (end > start) ? (end - start) / page : 0;
+        sp[i].live = calloc(sp[i].pages + 1, 1);
+        assert(sp[i].live != 0);
+    }
+
+    for (struct DLink *l = (q->Sentinel)->next; l != q->Sentinel; l = l->next) {
+        struct _linkSlab *s = _slabOf(q, l);
+        if (s == 0)
+            continue;
+        for (i = 0; sp[i].slab != s; i++)
+            ;
+
+        //a link may straddle two pages
+        uintptr_t ends[2] = {(uintptr_t)l, (uintptr_t)(l + 1) - 1};
+        for (int e = 0; e < 2; e++)
+            if (ends[e] >= sp[i].first && (ends[e] - sp[i].first) / page < sp[i].pages)
+                sp[i].live[(ends[e] - sp[i].first) / page] = 1;
+    }
+
+    for (i = 0; i < slabs; i++) {
+        struct _linkSlab *s = sp[i].slab;
+        size_t dead = 0;
+
+        //the running pass still hands out links from its slab
+        if (s != q->compactSlab) {
+            for (size_t p = 0; p < sp[i].pages; p++)
+                if (!sp[i].live[p] && madvise((void *)(sp[i].first + p * page), page, MADV_DONTNEED) == 0)
+                    dead += page;
+
+            if (dead > s->released) {
+                released += dead - s->released;
+                s->released = dead;
+            }
+        }
+        free(sp[i].live);
+    }
+    free(sp);
+    return released;
+}
+
+/* Return memory the deque no longer needs: the dead pages of compaction
+   slabs, then free heap memory through malloc_trim and the node cache's
+   free slabs through trimNodeCache when built with -DNODE_CACHE. A
+   bounded deque keeps its pool, which it needs to stay allocation free.
+
+	param: 	q		pointer to the deque
+	pre:	q is not null
+	post:	the deque's contents are unchanged
+	ret: 	bytes returned, not counting what malloc_trim releases
+*/
+size_t shrinkCirListDeque(struct cirListDeque *q)
+{
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to shrinkCirListDeque", 34);
+
+    size_t released = _releaseDeadPages(q);
+
+# ifdef NODE_CACHE
+    released += trimNodeCache();
+# endif
+# ifdef __GLIBC__
+    malloc_trim(0);
+# endif
+    return released;
+}
+
+
+# ifdef TRACE_OPS
+/* ************************************************************************
+	Trace Interface Functions
+************************************************************************ */
+
+/* Start or stop recording the deque calls made on q
+
+	param: 	q		pointer to the deque
+	param: 	t		trace to append to, or null to stop recording
+	pre:	q is not null
+	post:	every later deque call on q is appended to t
+*/
+void traceCirListDeque(struct cirListDeque *q, struct opTrace *t)
+{
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to traceCirListDeque", 21);
+
+    q->trace = t;
+}
+# endif
+
+
+/* ************************************************************************
+	Export Interface Functions
+************************************************************************ */
+
+# define EXPORT_BUFFER_SIZE (1 << 16)
+# define EXPORT_MAX_ROW     64      /* longest formatted row, with room to spare */
+
+/* Output buffer shared by the export functions */
+struct _exportBuffer {
+    char *data;
+    int len;
+    exportWriter write;
+    void *ctx;
+    int error;
+    long long scale;    /* 10^EXPORT_DECIMALS */
+    double limit;       /* largest magnitude formatted without snprintf */
+};
+
+/* Two digit lookup table used by _formatInt */
+static const char _digitPairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* Format a non-negative integer in decimal
+
+	param: 	out		buffer with room for at least 20 chars
+	param: 	u		the value to format
+	pre:	out is not null
+	post:	the decimal representation of u is written to out
+	ret: 	number of chars written
+*/
+int _formatInt(char *out, unsigned long long u)
+{
+    char tmp[24];
+    char *p = tmp + sizeof(tmp);
+
+    while (u >= 100) {
+        int pair = (int)(u % 100) * 2;
+        u /= 100;
+        *--p = _digitPairs[pair + 1];
+        *--p = _digitPairs[pair];
+    }
+    if (u >= 10) {
+        *--p = _digitPairs[u * 2 + 1];
+        *--p = _digitPairs[u * 2];
+    }
+    else
+        *--p = (char)('0' + u);
+
+    int len = (int)(tmp + sizeof(tmp) - p);
+    memcpy(out, p, len);
+    return len;
+}
+
+/* Format a double rounded to EXPORT_DECIMALS places, trailing zeros dropped.
+   Values too large for exact fixed point (and inf/nan) go through snprintf.
+
+	param: 	buf		the export buffer, supplies scale and limit
+	param: 	out		buffer with room for at least EXPORT_MAX_ROW - 1 chars
+	param: 	v		the value to format
+	pre:	out is not null
+	post:	the decimal representation of v is written to out
+	ret: 	number of chars written
+*/
+int _formatDouble(struct _exportBuffer *buf, char *out, double v)
+{
+    if (!(v < buf->limit && v > -buf->limit))
+        return snprintf(out, EXPORT_MAX_ROW - 1, "%.17g", v);
+
+    int n = 0;
+    double a = (v < 0) ? -v : v;
+    unsigned long long scaled = (unsigned long long)(a * buf->scale + 0.5);
+    unsigned long long whole = scaled / buf->scale;
+    unsigned long long frac = scaled % buf->scale;
+
+    if (v < 0 && scaled != 0)
+        out[n++] = '-';
+    n += _formatInt(out + n, whole);
+
+    if (frac != 0) {
+        char digits[24];
+        int len = _formatInt(digits, frac);
+
+        out[n++] = '.';
+        for (int i = len; i < EXPORT_DECIMALS; i++)    //leading zeros
+            out[n++] = '0';
+        while (digits[len - 1] == '0')                  //trailing zeros
+            len--;
+        memcpy(out + n, digits, len);
+        n += len;
+    }
+    return n;
+}
+
+/* Hand buffered bytes to the writer
+
+	param: 	buf		the export buffer
+	pre:	buf is not null
+	post:	buf->len is 0
+*/
+void _flushExport(struct _exportBuffer *buf)
+{
+    if (buf->len > 0 && !buf->error)
+        if (buf->write(buf->ctx, buf->data, buf->len) != 0)
+            buf->error = 1;
+    buf->len = 0;
+}
+
+/* Make room for n more bytes in the export buffer
+
+	param: 	buf		the export buffer
+	param: 	n		number of bytes about to be appended
+	pre:	buf is not null, n <= EXPORT_BUFFER_SIZE
+	ret: 	pointer to the first free byte
+*/
+char *_reserveExport(struct _exportBuffer *buf, int n)
+{
+    if (buf->len + n > EXPORT_BUFFER_SIZE)
+        _flushExport(buf);
+    return buf->data + buf->len;
+}
+
+/* Stream the deque front to back through a writer callback. Output is
+   assembled in a large buffer so the writer sees few, large chunks.
+   Unlike printCirListDeque an empty deque is not an error.
+
+	param: 	q		pointer to the deque
+	param: 	mode	EXPORT_TEXT, EXPORT_CSV or EXPORT_BINARY
+	param: 	write	the writer callback
+	param: 	ctx		opaque pointer passed through to write
+	pre:	q is not null, write is not null
+	post:	no changes to the deque
+	ret: 	0 on success, -1 if the writer reported an error
+*/
+int exportCirListDeque(struct cirListDeque *q, int mode, exportWriter write, void *ctx)
+{
+    //pre-conditions
+    if (q == 0)
+        _gracefulExit("Passed null cirListDeque ptr to exportCirListDeque", 17);
+
+    assert(write != 0);
+    assert(mode == EXPORT_TEXT || mode == EXPORT_CSV || mode == EXPORT_BINARY);
+
+    struct _exportBuffer buf;
+    buf.data = malloc(EXPORT_BUFFER_SIZE);
+    assert(buf.data != 0);
+    buf.len = 0;
+    buf.write = write;
+    buf.ctx = ctx;
+    buf.error = 0;
+    buf.scale = 1;
+    for (int i = 0; i < EXPORT_DECIMALS; i++)
+        buf.scale *= 10;
+    buf.limit = 9e15 / buf.scale;   //keeps v * scale exact in a double
+
+    if (mode == EXPORT_CSV) {
+        memcpy(_reserveExport(&buf, 12), "index,value\n", 12);
+        buf.len += 12;
+    }
+
+    struct DLink *current = q->Sentinel->next;
+    unsigned long long i = 0;
+
+    //a binary row is one TYPE, which a struct payload can make longer than a text row
+    int row = (mode == EXPORT_BINARY && sizeof(TYPE) > EXPORT_MAX_ROW) ? (int)sizeof(TYPE) : EXPORT_MAX_ROW;
+    assert(row <= EXPORT_BUFFER_SIZE);
+
+    while (current != q->Sentinel && !buf.error) {
+        char *out = _reserveExport(&buf, row);
+        int n = 0;
+
+        if (mode == EXPORT_BINARY) {
+            memcpy(out, &current->value, sizeof(TYPE));
+            n = sizeof(TYPE);
+        }
+        else {
+            if (mode == EXPORT_CSV) {
+                n += _formatInt(out, i);
+                out[n++] = ',';
+            }
+            n += _formatDouble(&buf, out + n, KEY(current->value));
+            out[n++] = '\n';
+        }
+
+        buf.len += n;
+        current = current->next;
+        i++;
+    }
+
+    _flushExport(&buf);
+    free(buf.data);
+    return buf.error ? -1 : 0;
+}
+
+/* exportWriter for stdio streams */
+int _writeFile(void *ctx, const char *buf, int len)
+{
+    return (fwrite(buf, 1, len, (FILE *)ctx) == (size_t)len) ? 0 : -1;
+}
+
+/* exportWriter for file descriptors, retries short writes */
+int _writeFd(void *ctx, const char *buf, int len)
+{
+    int fd = *(int *)ctx;
+
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        buf += n;
+        len -= (int)n;
+    }
+    return 0;
+}
+
+/* Stream the deque to a stdio stream, see exportCirListDeque
+
+	param: 	q		pointer to the deque
+	param: 	mode	EXPORT_TEXT, EXPORT_CSV or EXPORT_BINARY
+	param: 	fp		the destination stream
+	pre:	q is not null, fp is not null
+	ret: 	0 on success, -1 on a write error
+*/
+int exportCirListDequeToFile(struct cirListDeque *q, int mode, FILE *fp)
+{
+    assert(fp != 0);
+    return exportCirListDeque(q, mode, _writeFile, fp);
+}
+
+/* Stream the deque to a file descriptor, see exportCirListDeque
+
+	param: 	q		pointer to the deque
+	param: 	mode	EXPORT_TEXT, EXPORT_CSV or EXPORT_BINARY
+	param: 	fd		the destination file descriptor
+	pre:	q is not null, fd is open for writing
+	ret: 	0 on success, -1 on a write error
+*/
+int exportCirListDequeToFd(struct cirListDeque *q, int mode, int fd)
+{
+    return exportCirListDeque(q, mode, _writeFd, &fd);
+}
@@ -1,17 +1,27 @@
 #ifndef __CIRLISTDEQUE_H
 #define __CIRLISTDEQUE_H
 
+#include <stdio.h>
+
+/* Payload hooks, defined before including this header (and compiled
+   into cirListDeque.c with the same definitions). TYPE may be a struct:
+   KEY extracts the arithmetic key that LT and EQ compare by default, so
+   merges order by key, and that print and text export show. */
 # ifndef TYPE
 # define TYPE      double
 # define TYPE_SIZE sizeof(double)
 # endif
 
+# ifndef KEY
+# define KEY(A) (A)
+# endif
+
 # ifndef LT
-# define LT(A, B) ((A) < (B))
+# define LT(A, B) (KEY(A) < KEY(B))
 # endif
 
 # ifndef EQ
-# define EQ(A, B) ((A) == (B))
+# define EQ(A, B) (KEY(A) == KEY(B))
 # endif
 
 /* struct prototype */
@@ -21,6 +31,7 @@ struct cirListDeque *createCirListDeque();
 void deleteCirListDeque(struct cirListDeque *q);
 
 int isEmptyCirListDeque(struct cirListDeque *q);
+int sizeCirListDeque(struct cirListDeque *q);
 void addBackCirListDeque(struct cirListDeque *q, TYPE val);
 void addFrontCirListDeque(struct cirListDeque *q, TYPE val);
 TYPE frontCirListDeque(struct cirListDeque *q);
@@ -29,7 +40,70 @@ void removeFrontCirListDeque(struct cirListDeque *q);
 void removeBackCirListDeque(struct cirListDeque *q);
 void freeCirListDeque(struct cirListDeque *q);
 
+/* Bounded Interface: a deque created with a fixed capacity allocates all
+   its links up front and never allocates again. An add to a full deque
+   follows the policy; blockingCirListDeque adds a waiting policy. */
+# define BOUNDED_OVERWRITE 0    /* drop the value at the opposite end */
+# define BOUNDED_REJECT    1    /* keep the contents, the add fails */
+
+struct cirListDeque *createBoundedCirListDeque(int capacity, int policy);
+int isFullCirListDeque(struct cirListDeque *q);
+int tryAddBackCirListDeque(struct cirListDeque *q, TYPE val);
+int tryAddFrontCirListDeque(struct cirListDeque *q, TYPE val);
+int copyLastCirListDeque(struct cirListDeque *q, TYPE *vals, int n);
+
 void printCirListDeque(struct cirListDeque *q);
 void reverseCirListDeque(struct cirListDeque *q);
 
+/* Compaction Interface: relocate the links into contiguous memory in
+   deque order, all at once or a bounded number per step */
+void compactCirListDeque(struct cirListDeque *q);
+int compactStepCirListDeque(struct cirListDeque *q, int maxNodes);
+
+/* Merge Interface: k-way merge of deques sorted by LT through a loser
+   tree, O(log k) per value. mergeCirListDeques moves the links onto the
+   back of out; a streaming merge reads the values without moving them. */
+struct cirListDequeMerge;
+
+void mergeCirListDeques(struct cirListDeque *out, struct cirListDeque **qs, int k);
+struct cirListDequeMerge *createCirListDequeMerge(struct cirListDeque **qs, int k);
+int nextCirListDequeMerge(struct cirListDequeMerge *m, TYPE *val);
+void deleteCirListDequeMerge(struct cirListDequeMerge *m);
+
+/* Footprint Interface: bytes of stored values, of structure (links,
+   sentinel, allocator headers) and of space reserved but unused;
+   shrinkCirListDeque returns what it can to the OS */
+struct memoryFootprint {
+    size_t payload;
+    size_t overhead;
+    size_t reserved;
+};
+
+void footprintCirListDeque(struct cirListDeque *q, struct memoryFootprint *f);
+size_t shrinkCirListDeque(struct cirListDeque *q);
+
+/* Trace Interface, built with -DTRACE_OPS and opTrace.c: records every
+   deque call made on q, see opTrace.h */
+# ifdef TRACE_OPS
+struct opTrace;
+void traceCirListDeque(struct cirListDeque *q, struct opTrace *t);
+# endif
+
+/* Export Interface */
+# define EXPORT_TEXT   0    /* one value per line */
+# define EXPORT_CSV    1    /* "index,value" header followed by one row per value */
+# define EXPORT_BINARY 2    /* raw TYPE values, front to back */
+
+/* decimal places kept by the text and CSV modes */
+# ifndef EXPORT_DECIMALS
+# define EXPORT_DECIMALS 6
+# endif
+
+/* Export sink, returns 0 on success and -1 on a write error */
+typedef int (*exportWriter)(void *ctx, const char *buf, int len);
+
+int exportCirListDeque(struct cirListDeque *q, int mode, exportWriter write, void *ctx);
+int exportCirListDequeToFile(struct cirListDeque *q, int mode, FILE *fp);
+int exportCirListDequeToFd(struct cirListDeque *q, int mode, int fd);
+
 #endif
@@ -0,0 +1,811 @@
+/* journaledDeque.c
+ * write-ahead journaled cirListDeque implementation file.
+
+ Description:   Every update is applied to an in-memory cirListDeque and
+                appended as a compact record (one op byte, plus the value
+                for adds) to a pending buffer. A background flusher swaps
+                the buffer out, writes it with one write() and makes it
+                durable with one fdatasync(), so every operation that
+                arrived during the previous sync shares the next one.
+
+                JOURNAL_SYNC_GROUP operations sleep until their record is
+                durable, JOURNAL_SYNC_ASYNC operations return at once and
+                JOURNAL_SYNC_ALWAYS writes and syncs inside the operation.
+                groupDelayMs holds a batch back to collect more records,
+                groupBytes releases it early.
+
+                The log starts with a magic number and an epoch. Once the
+                log passes compactBytes the flusher writes the contents to
+                <path>.snap tagged with the log's epoch and starts an empty
+                log with the next epoch, each through a temporary file and
+                rename. On open the snapshot is loaded and the log is only
+                replayed when its epoch is newer, so a crash between the two
+                renames cannot apply the same records twice. A torn record
+                at the end of the log is dropped.
+
+                Only cirListDeque is wrapped. The q1 linkedList has the
+                same four end operations, but it also changes by value
+                (removeList, the batch removes, set mode, mergeLists), which
+                this record format cannot express, and it is built
+                separately with an int TYPE.
+ **** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "journaledDeque.h"
+
+/* log record op codes */
+# define JOURNAL_ADD_FRONT    1
+# define JOURNAL_ADD_BACK     2
+# define JOURNAL_REMOVE_FRONT 3
+# define JOURNAL_REMOVE_BACK  4
+
+# define JOURNAL_HEADER  12    /* 4 byte magic, 8 byte epoch */
+
+static const char _logMagic[4] = {'J', 'D', 'Q', 'L'};
+static const char _snapMagic[4] = {'J', 'D', 'Q', 'S'};
+
+struct journalBuffer {
+    unsigned char *data;
+    int len;
+    int cap;
+};
+
+struct journaledDeque {
+    struct cirListDeque *q;         /* current contents */
+    struct journalOptions opt;
+    char *logPath;
+    char *snapPath;
+    char *tmpPath;
+    int fd;                         /* open log, appended by one thread at a time */
+    unsigned long long epoch;       /* epoch of the open log */
+    long logBytes;                  /* size of the open log */
+
+    pthread_mutex_t lock;
+    pthread_cond_t work;            /* wakes the flusher */
+    pthread_cond_t durable;         /* signalled after each flush */
+    pthread_t flusher;
+    int hasFlusher;
+
+    struct journalBuffer pending;   /* records not yet written */
+    struct journalBuffer spare;     /* swapped in while pending is written */
+    unsigned long long appended;    /* records appended so far */
+    unsigned long long synced;      /* records known to be durable */
+    struct timespec firstPending;   /* when pending became non-empty */
+    int syncWaiters;                /* callers that want a flush now */
+    int compactWanted;
+    int flushing;
+    int closing;
+    int failed;
+};
+
+/* Prints custom error message and exits w/ custom error code
+
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+
+    //pre-conditions
+    assert(message != 0);
+
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* Make room for len more bytes at the end of a buffer */
+static unsigned char *_reserve(struct journalBuffer *b, int len)
+{
+    if (b->len + len > b->cap) {
+        int cap = b->cap ? b->cap : 4096;
+        while (cap < b->len + len)
+            cap *= 2;
+        b->data = realloc(b->data, cap);
+        assert(b->data != 0);
+        b->cap = cap;
+    }
+    return b->data + b->len;
+}
+
+/* exportWriter that copies the binary export into a journalBuffer */
+static int _bufferWriter(void *ctx, const char *buf, int len)
+{
+    struct journalBuffer *b = ctx;
+
+    memcpy(_reserve(b, len), buf, len);
+    b->len += len;
+    return 0;
+}
+
+/* write() all of buf, retrying partial writes, returns 0 or -1 */
+static int _writeAll(int fd, const void *buf, long len)
+{
+    const char *p = buf;
+
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/* fsync the directory holding path so a rename into it is durable */
+static int _syncDir(const char *path)
+{
+    char dir[4096];
+    const char *slash = strrchr(path, '/');
+
+    if (slash == 0)
+        strcpy(dir, ".");
+    else if (slash == path)
+        strcpy(dir, "/");
+    else {
+        int n = slash - path;
+        if (n >= (int)sizeof(dir))
+            return -1;
+        memcpy(dir, path, n);
+        dir[n] = 0;
+    }
+
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+        return -1;
+    int rc = fsync(fd);
+    close(fd);
+    return rc;
+}
+
+/* Durably replace target with a new file holding header then body
+
+	param: 	j		the deque, j->tmpPath is used as scratch
+	param: 	target	path being replaced
+	ret: 	the new file opened for appending, or -1
+*/
+static int _replaceFile(struct journaledDeque *j, const char *target,
+                        const unsigned char *header, int headerLen,
+                        const unsigned char *body, long bodyLen)
+{
+    int fd = open(j->tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0)
+        return -1;
+
+    if (_writeAll(fd, header, headerLen) < 0 || _writeAll(fd, body, bodyLen) < 0
+        || fdatasync(fd) < 0 || rename(j->tmpPath, target) < 0 || _syncDir(target) < 0) {
+        close(fd);
+        unlink(j->tmpPath);
+        return -1;
+    }
+    return fd;
+}
+
+/* Write the snapshot for the open epoch, then switch to an empty log with
+   the next one. vals holds the contents as raw TYPE values.
+
+	ret: 	0 on success, -1 on an I/O error
+*/
+static int _compact(struct journaledDeque *j, struct journalBuffer *vals)
+{
+    unsigned char header[JOURNAL_HEADER + 8];
+    unsigned long long count = vals->len / sizeof(TYPE);
+
+    memcpy(header, _snapMagic, 4);
+    memcpy(header + 4, &j->epoch, 8);
+    memcpy(header + JOURNAL_HEADER, &count, 8);
+
+    int fd = _replaceFile(j, j->snapPath, header, sizeof(header), vals->data, vals->len);
+    if (fd < 0)
+        return -1;
+    close(fd);
+
+    //the old log is now covered by the snapshot
+    unsigned long long next = j->epoch + 1;
+    memcpy(header, _logMagic, 4);
+    memcpy(header + 4, &next, 8);
+
+    fd = _replaceFile(j, j->logPath, header, JOURNAL_HEADER, 0, 0);
+    if (fd < 0)
+        return -1;
+
+    close(j->fd);
+    j->fd = fd;
+    j->epoch = next;
+    j->logBytes = JOURNAL_HEADER;
+    return 0;
+}
+
+/* Write out and sync every pending record, compacting instead when due
+
+	param: 	j			the deque, locked by the caller
+	param: 	unlock		1 to release the lock during the I/O
+	post:	j->synced or j->failed is updated and waiters are woken
+*/
+static void _flush(struct journaledDeque *j, int unlock)
+{
+    struct journalBuffer out = j->pending;
+    struct journalBuffer vals = {0, 0, 0};
+    unsigned long long upto = j->appended;
+    int compact = j->compactWanted
+        || (j->opt.compactBytes > 0 && j->logBytes + out.len >= j->opt.compactBytes);
+
+    j->pending = j->spare;
+    j->pending.len = 0;
+    j->compactWanted = 0;
+    j->flushing = 1;
+
+    //the contents match the records taken above
+    if (compact)
+        exportCirListDeque(j->q, EXPORT_BINARY, _bufferWriter, &vals);
+
+    if (unlock)
+        pthread_mutex_unlock(&j->lock);
+
+    int rc;
+    if (compact)
+        rc = _compact(j, &vals);
+    else {
+        rc = _writeAll(j->fd, out.data, out.len);
+        if (rc == 0)
+            rc = fdatasync(j->fd);
+        if (rc == 0)
+            j->logBytes += out.len;
+    }
+    free(vals.data);
+
+    if (unlock)
+        pthread_mutex_lock(&j->lock);
+
+    out.len = 0;
+    j->spare = out;
+    j->flushing = 0;
+    if (rc < 0)
+        j->failed = 1;
+    else
+        j->synced = upto;
+    pthread_cond_broadcast(&j->durable);
+}
+
+/* Background group commit loop */
+static void *_flusherMain(void *arg)
+{
+    struct journaledDeque *j = arg;
+
+    pthread_mutex_lock(&j->lock);
+    for (;;) {
+        if (j->pending.len == 0 && !j->compactWanted) {
+            if (j->closing)
+                break;
+            pthread_cond_wait(&j->work, &j->lock);
+            continue;
+        }
+
+        //hold a small batch back for up to groupDelayMs
+        if (!j->closing && !j->syncWaiters && !j->compactWanted
+            && j->pending.len < j->opt.groupBytes && j->opt.groupDelayMs > 0) {
+            struct timespec now, deadline = j->firstPending;
+            deadline.tv_sec += j->opt.groupDelayMs / 1000;
+            deadline.tv_nsec += (long)(j->opt.groupDelayMs % 1000) * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (now.tv_sec < deadline.tv_sec
+                || (now.tv_sec == deadline.tv_sec && now.tv_nsec < deadline.tv_nsec)) {
+                pthread_cond_timedwait(&j->work, &j->lock, &deadline);
+                continue;
+            }
+        }
+
+        _flush(j, 1);
+    }
+    pthread_mutex_unlock(&j->lock);
+    return 0;
+}
+
+/* Read a whole file into memory
+
+	ret: 	malloc'd contents and their length in *len, or null if the
+			file does not exist or cannot be read
+*/
+static unsigned char *_readFile(const char *path, long *len)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    struct stat st;
+    unsigned char *data = 0;
+    long got = 0;
+
+    if (fstat(fd, &st) == 0) {
+        data = malloc(st.st_size + 1);
+        assert(data != 0);
+        while (got < st.st_size) {
+            ssize_t n = read(fd, data + got, st.st_size - got);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                break;
+            got += n;
+        }
+    }
+    close(fd);
+
+    *len = got;
+    return data;
+}
+
+/* Load the snapshot, if any, into j->q
+
+	param: 	epoch	receives the epoch it covers, 0 without a snapshot
+	ret: 	0 on success, -1 if the snapshot is truncated or corrupt
+*/
+static int _loadSnapshot(struct journaledDeque *j, unsigned long long *epoch)
+{
+    long len = 0;
+    unsigned char *data = _readFile(j->snapPath, &len);
+    unsigned long long count = 0;
+    int rc = 0;
+
+    *epoch = 0;
+
+    //a file without the magic is not a snapshot of ours
+    if (data != 0 && len >= 4 && memcmp(data, _snapMagic, 4) == 0) {
+        long body = len - JOURNAL_HEADER - 8;
+
+        if (body >= 0)
+            memcpy(&count, data + JOURNAL_HEADER, 8);
+
+        //snapshots are renamed into place whole, one of another length is damaged
+        if (body < 0 || body % sizeof(TYPE) != 0 || count != body / sizeof(TYPE))
+            rc = -1;
+        else {
+            memcpy(epoch, data + 4, 8);
+            for (unsigned long long i = 0; i < count; i++) {
+                TYPE val;
+                memcpy(&val, data + JOURNAL_HEADER + 8 + i * sizeof(TYPE), sizeof(TYPE));
+                addBackCirListDeque(j->q, val);
+            }
+        }
+    }
+    free(data);
+    return rc;
+}
+
+/* Apply log records to j->q
+
+	ret: 	length of the valid prefix; a torn or unknown record ends it
+*/
+static long _replay(struct journaledDeque *j, const unsigned char *data, long len)
+{
+    long at = JOURNAL_HEADER;
+
+    while (at < len) {
+        int op = data[at];
+        TYPE val;
+
+        if (op == JOURNAL_ADD_FRONT || op == JOURNAL_ADD_BACK) {
+            if (at + 1 + (long)sizeof(TYPE) > len)
+                break;
+            memcpy(&val, data + at + 1, sizeof(TYPE));
+            if (op == JOURNAL_ADD_FRONT)
+                addFrontCirListDeque(j->q, val);
+            else
+                addBackCirListDeque(j->q, val);
+            at += 1 + sizeof(TYPE);
+        }
+        else if ((op == JOURNAL_REMOVE_FRONT || op == JOURNAL_REMOVE_BACK)
+                 && !isEmptyCirListDeque(j->q)) {
+            if (op == JOURNAL_REMOVE_FRONT)
+                removeFrontCirListDeque(j->q);
+            else
+                removeBackCirListDeque(j->q);
+            at++;
+        }
+        else
+            break;
+    }
+    return at;
+}
+
+/* Copy a path with a suffix appended */
+static char *_suffixPath(const char *path, const char *suffix)
+{
+    char *s = malloc(strlen(path) + strlen(suffix) + 1);
+    assert(s != 0);
+    strcpy(s, path);
+    strcat(s, suffix);
+    return s;
+}
+
+/* Free a deque that failed to open
+
+	param: 	j		the deque, without its lock, conditions or flusher
+*/
+static void _discardJournal(struct journaledDeque *j)
+{
+    deleteCirListDeque(j->q);
+    free(j->logPath);
+    free(j->snapPath);
+    free(j->tmpPath);
+    free(j);
+}
+
+/* Open a journaled deque, replaying what an earlier run left behind
+
+	param: 	path	the log file, <path>.snap holds the snapshot
+	param: 	opt		durability settings, null for the defaults
+	pre:	path is not null, no other deque has path open
+	post:	the deque holds the contents as of the last durable record
+	ret: 	the deque, or null if the files cannot be opened or the
+			snapshot is damaged
+*/
+struct journaledDeque *openJournaledDeque(const char *path, const struct journalOptions *opt)
+{
+    if (path == 0)
+        _gracefulExit("Passed null path to openJournaledDeque", 1);
+
+    struct journaledDeque *j = calloc(1, sizeof(struct journaledDeque));
+    assert(j != 0);
+
+    if (opt != 0)
+        j->opt = *opt;
+    else {
+        j->opt.syncMode = JOURNAL_SYNC_GROUP;
+        j->opt.groupDelayMs = 0;
+        j->opt.groupBytes = 64 * 1024;
+        j->opt.compactBytes = 4 * 1024 * 1024;
+    }
+    assert(j->opt.syncMode >= JOURNAL_SYNC_ALWAYS && j->opt.syncMode <= JOURNAL_SYNC_ASYNC);
+
+    j->q = createCirListDeque();
+    j->logPath = _suffixPath(path, "");
+    j->snapPath = _suffixPath(path, ".snap");
+    j->tmpPath = _suffixPath(path, ".tmp");
+    j->fd = -1;
+
+    unsigned long long snapEpoch;
+    if (_loadSnapshot(j, &snapEpoch) < 0) {
+        _discardJournal(j);
+        return 0;
+    }
+
+    long len = 0;
+    unsigned char *data = _readFile(j->logPath, &len);
+    unsigned long long logEpoch = 0;
+
+    if (data != 0 && len >= JOURNAL_HEADER && memcmp(data, _logMagic, 4) == 0)
+        memcpy(&logEpoch, data + 4, 8);
+
+    if (logEpoch > snapEpoch) {
+        //cut off a torn tail so new records follow valid ones
+        long valid = _replay(j, data, len);
+        j->fd = open(j->logPath, O_WRONLY | O_APPEND);
+        if (j->fd >= 0 && valid < len && (ftruncate(j->fd, valid) < 0 || fdatasync(j->fd) < 0)) {
+            close(j->fd);
+            j->fd = -1;
+        }
+        j->epoch = logEpoch;
+        j->logBytes = valid;
+    }
+    else {
+        //no log yet, or one the snapshot already covers
+        unsigned char header[JOURNAL_HEADER];
+        j->epoch = snapEpoch + 1;
+        memcpy(header, _logMagic, 4);
+        memcpy(header + 4, &j->epoch, 8);
+        j->fd = _replaceFile(j, j->logPath, header, JOURNAL_HEADER, 0, 0);
+        j->logBytes = JOURNAL_HEADER;
+    }
+    free(data);
+
+    if (j->fd < 0) {
+        _discardJournal(j);
+        return 0;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);   //immune to wall clock jumps
+    pthread_mutex_init(&j->lock, 0);
+    pthread_cond_init(&j->work, &attr);
+    pthread_cond_init(&j->durable, 0);
+    pthread_condattr_destroy(&attr);
+
+    if (j->opt.syncMode != JOURNAL_SYNC_ALWAYS) {
+        int rc = pthread_create(&j->flusher, 0, _flusherMain, j);
+        assert(rc == 0);
+        (void)rc;
+        j->hasFlusher = 1;
+    }
+    return j;
+}
+
+/* Sync what is pending, stop the flusher and free the deque
+
+	param: 	j		the deque
+	pre:	j is not null, no other thread is using j
+	post:	j is freed
+	ret: 	0, or -1 if any log write failed
+*/
+int closeJournaledDeque(struct journaledDeque *j)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to closeJournaledDeque", 2);
+
+    pthread_mutex_lock(&j->lock);
+    j->closing = 1;
+    pthread_mutex_unlock(&j->lock);
+    pthread_cond_signal(&j->work);
+
+    if (j->hasFlusher)
+        pthread_join(j->flusher, 0);    //flushes what is left before exiting
+
+    int rc = j->failed ? -1 : 0;
+    close(j->fd);
+    deleteCirListDeque(j->q);
+    pthread_cond_destroy(&j->durable);
+    pthread_cond_destroy(&j->work);
+    pthread_mutex_destroy(&j->lock);
+    free(j->pending.data);
+    free(j->spare.data);
+    free(j->logPath);
+    free(j->snapPath);
+    free(j->tmpPath);
+    free(j);
+    return rc;
+}
+
+/* Check whether the deque is empty
+
+	param: 	j		the deque
+	pre:	j is not null
+	ret: 	1 if the deque was empty when checked. Otherwise, 0.
+*/
+int isEmptyJournaledDeque(struct journaledDeque *j)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to isEmptyJournaledDeque", 3);
+
+    pthread_mutex_lock(&j->lock);
+    int empty = isEmptyCirListDeque(j->q);
+    pthread_mutex_unlock(&j->lock);
+    return empty;
+}
+
+/* Number of values in the deque
+
+	param: 	j		the deque
+	pre:	j is not null
+	ret: 	the number of values when checked
+*/
+int sizeJournaledDeque(struct journaledDeque *j)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to sizeJournaledDeque", 4);
+
+    pthread_mutex_lock(&j->lock);
+    int size = sizeCirListDeque(j->q);
+    pthread_mutex_unlock(&j->lock);
+    return size;
+}
+
+/* Front value of the deque
+
+	param: 	j		the deque
+	pre:	j is not null and not empty
+	ret: 	the front value
+*/
+TYPE frontJournaledDeque(struct journaledDeque *j)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to frontJournaledDeque", 5);
+
+    pthread_mutex_lock(&j->lock);
+    TYPE val = frontCirListDeque(j->q);
+    pthread_mutex_unlock(&j->lock);
+    return val;
+}
+
+/* Back value of the deque
+
+	param: 	j		the deque
+	pre:	j is not null and not empty
+	ret: 	the back value
+*/
+TYPE backJournaledDeque(struct journaledDeque *j)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to backJournaledDeque", 6);
+
+    pthread_mutex_lock(&j->lock);
+    TYPE val = backCirListDeque(j->q);
+    pthread_mutex_unlock(&j->lock);
+    return val;
+}
+
+/* Apply one update and journal it according to the sync mode
+
+	param: 	j		the deque
+	param: 	op		JOURNAL_* op code
+	param: 	val		value for the adds
+	ret: 	0, or -1 if the journal has failed
+*/
+static int _update(struct journaledDeque *j, int op, TYPE val)
+{
+    pthread_mutex_lock(&j->lock);
+
+    if (j->failed) {
+        pthread_mutex_unlock(&j->lock);
+        return -1;
+    }
+
+    if ((op == JOURNAL_REMOVE_FRONT || op == JOURNAL_REMOVE_BACK) && isEmptyCirListDeque(j->q)) {
+        pthread_mutex_unlock(&j->lock);
+        _gracefulExit("Passed empty journaledDeque to a remove", 7);
+    }
+
+    switch (op) {
+        case JOURNAL_ADD_FRONT:    addFrontCirListDeque(j->q, val); break;
+        case JOURNAL_ADD_BACK:     addBackCirListDeque(j->q, val); break;
+        case JOURNAL_REMOVE_FRONT: removeFrontCirListDeque(j->q); break;
+        case JOURNAL_REMOVE_BACK:  removeBackCirListDeque(j->q); break;
+    }
+
+    int wasEmpty = j->pending.len == 0;
+    int len = (op == JOURNAL_ADD_FRONT || op == JOURNAL_ADD_BACK) ? 1 + sizeof(TYPE) : 1;
+    unsigned char *rec = _reserve(&j->pending, len);
+    rec[0] = op;
+    if (len > 1)
+        memcpy(rec + 1, &val, sizeof(TYPE));
+    j->pending.len += len;
+    unsigned long long seq = ++j->appended;
+
+    if (wasEmpty)
+        clock_gettime(CLOCK_MONOTONIC, &j->firstPending);
+
+    if (j->opt.syncMode == JOURNAL_SYNC_ALWAYS)
+        _flush(j, 0);
+    else {
+        if (wasEmpty || j->pending.len >= j->opt.groupBytes)
+            pthread_cond_signal(&j->work);
+
+        if (j->opt.syncMode == JOURNAL_SYNC_GROUP)
+            while (j->synced < seq && !j->failed)
+                pthread_cond_wait(&j->durable, &j->lock);
+    }
+
+    int rc = j->failed ? -1 : 0;
+    pthread_mutex_unlock(&j->lock);
+    return rc;
+}
+
+/* Add a value to the front of the deque
+
+	param: 	j		the deque
+	param: 	val		value to add
+	pre:	j is not null
+	ret: 	0, or -1 if the journal has failed
+*/
+int addFrontJournaledDeque(struct journaledDeque *j, TYPE val)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to addFrontJournaledDeque", 8);
+
+    return _update(j, JOURNAL_ADD_FRONT, val);
+}
+
+/* Add a value to the back of the deque
+
+	param: 	j		the deque
+	param: 	val		value to add
+	pre:	j is not null
+	ret: 	0, or -1 if the journal has failed
+*/
+int addBackJournaledDeque(struct journaledDeque *j, TYPE val)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to addBackJournaledDeque", 9);
+
+    return _update(j, JOURNAL_ADD_BACK, val);
+}
+
+/* Remove the front value of the deque
+
+	param: 	j		the deque
+	pre:	j is not null and not empty
+	ret: 	0, or -1 if the journal has failed
+*/
+int removeFrontJournaledDeque(struct journaledDeque *j)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to removeFrontJournaledDeque", 10);
+
+    return _update(j, JOURNAL_REMOVE_FRONT, 0);
+}
+
+/* Remove the back value of the deque
+
+	param: 	j		the deque
+	pre:	j is not null and not empty
+	ret: 	0, or -1 if the journal has failed
+*/
+int removeBackJournaledDeque(struct journaledDeque *j)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to removeBackJournaledDeque", 11);
+
+    return _update(j, JOURNAL_REMOVE_BACK, 0);
+}
+
+/* Wait until every operation made so far is durable, skipping groupDelayMs
+
+	param: 	j		the deque
+	pre:	j is not null
+	ret: 	0, or -1 if the journal has failed
+*/
+int syncJournaledDeque(struct journaledDeque *j)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to syncJournaledDeque", 12);
+
+    pthread_mutex_lock(&j->lock);
+    unsigned long long target = j->appended;
+
+    j->syncWaiters++;
+    pthread_cond_signal(&j->work);
+    while (j->synced < target && !j->failed)
+        pthread_cond_wait(&j->durable, &j->lock);
+    j->syncWaiters--;
+
+    int rc = j->failed ? -1 : 0;
+    pthread_mutex_unlock(&j->lock);
+    return rc;
+}
+
+/* Snapshot the contents and start an empty log
+
+	param: 	j		the deque
+	pre:	j is not null
+	post:	the log holds only its header
+	ret: 	0, or -1 if the journal has failed
+*/
+int compactJournaledDeque(struct journaledDeque *j)
+{
+    if (j == 0)
+        _gracefulExit("Passed null journaledDeque ptr to compactJournaledDeque", 13);
+
+    pthread_mutex_lock(&j->lock);
+
+    if (!j->failed) {
+        j->compactWanted = 1;
+        if (j->opt.syncMode == JOURNAL_SYNC_ALWAYS)
+            _flush(j, 0);
+        else {
+            pthread_cond_signal(&j->work);
+            while ((j->compactWanted || j->flushing) && !j->failed)
+                pthread_cond_wait(&j->durable, &j->lock);
+        }
+    }
+
+    int rc = j->failed ? -1 : 0;
+    pthread_mutex_unlock(&j->lock);
+    return rc;
+}
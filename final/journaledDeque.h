@@ -0,0 +1,47 @@
+#ifndef __JOURNALEDDEQUE_H
+#define __JOURNALEDDEQUE_H
+
+#include "cirListDeque.h"
+
+/* Thread-safe cirListDeque whose operations are appended to a write-ahead
+   log and replayed when the deque is reopened */
+struct journaledDeque;
+
+/* when an operation counts as durable */
+# define JOURNAL_SYNC_ALWAYS 0  /* write and fdatasync inside every operation */
+# define JOURNAL_SYNC_GROUP  1  /* operations wait for a batched fdatasync */
+# define JOURNAL_SYNC_ASYNC  2  /* operations return at once, synced within groupDelayMs */
+
+struct journalOptions {
+    int syncMode;       /* one of JOURNAL_SYNC_* */
+    int groupDelayMs;   /* longest a record waits before its batch is synced */
+    int groupBytes;     /* sync early once this many bytes are pending */
+    long compactBytes;  /* snapshot and truncate once the log passes this size, 0 never */
+};
+
+/* opt may be null for JOURNAL_SYNC_GROUP, no delay, 64KB batches and 4MB logs.
+   Opening replays <path>.snap then <path>; returns null if they cannot be opened
+   or the snapshot is truncated or corrupt */
+struct journaledDeque *openJournaledDeque(const char *path, const struct journalOptions *opt);
+
+/* syncs everything still pending, then frees the deque */
+int  closeJournaledDeque(struct journaledDeque *j);
+
+int  isEmptyJournaledDeque(struct journaledDeque *j);
+int  sizeJournaledDeque(struct journaledDeque *j);
+TYPE frontJournaledDeque(struct journaledDeque *j);
+TYPE backJournaledDeque(struct journaledDeque *j);
+
+/* updates return 0, or -1 once a log write has failed */
+int  addFrontJournaledDeque(struct journaledDeque *j, TYPE val);
+int  addBackJournaledDeque(struct journaledDeque *j, TYPE val);
+int  removeFrontJournaledDeque(struct journaledDeque *j);
+int  removeBackJournaledDeque(struct journaledDeque *j);
+
+/* wait until every operation so far is durable */
+int  syncJournaledDeque(struct journaledDeque *j);
+
+/* snapshot the contents and start an empty log */
+int  compactJournaledDeque(struct journaledDeque *j);
+
+#endif
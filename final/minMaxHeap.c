@@ -0,0 +1,305 @@
+/* minMaxHeap.c
+ * min-max heap implementation file.
+ 
+ Description:   Array backed min-max heap. Nodes on even levels (the root is
+                level 0) are no larger than anything below them, nodes on odd
+                levels no smaller, so the minimum is the root and the maximum
+                is one of its two children. Insert and both removals are
+                O(log n), both peeks O(1). All ordering goes through LT.
+ **** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "minMaxHeap.h"
+
+struct minMaxHeap {
+    TYPE *data;     /* heap ordered values */
+    int size;       /* number of values in the heap */
+    int capacity;   /* allocated length of data */
+};
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* Create a heap
+
+	param: 	capacity	initial capacity, grows as needed
+	pre:	capacity > 0
+	post:	an empty heap is allocated
+*/
+struct minMaxHeap *createMinMaxHeap(int capacity)
+{
+    assert(capacity > 0);
+
+    struct minMaxHeap *h = malloc(sizeof(struct minMaxHeap));
+    assert(h != 0);
+    h->data = malloc(sizeof(TYPE) * capacity);
+    assert(h->data != 0);
+    h->size = 0;
+    h->capacity = capacity;
+    return h;
+}
+
+/* Deallocate the heap
+
+	param: 	h		pointer to the heap
+	pre:	h is not null
+	post:	the values and the heap itself are freed
+*/
+void deleteMinMaxHeap(struct minMaxHeap *h)
+{
+    if (h == 0)
+        _gracefulExit("Passed null minMaxHeap ptr to deleteMinMaxHeap", 1);
+
+    free(h->data);
+    free(h);
+}
+
+/* Whether index i is on a min level
+
+	param: 	i		heap index
+	ret: 	1 if the depth of i is even, else 0
+*/
+static int _isMinLevel(int i)
+{
+    int depth = 0;
+    for (i = i + 1; i > 1; i >>= 1)
+        depth++;
+    return (depth & 1) == 0;
+}
+
+static void _swap(TYPE *data, int i, int j)
+{
+    TYPE temp = data[i];
+    data[i] = data[j];
+    data[j] = temp;
+}
+
+/* Whether a is ahead of b in the ordering of a min (isMin = 1) or max level */
+static int _ahead(TYPE a, TYPE b, int isMin)
+{
+    return isMin ? LT(a, b) : LT(b, a);
+}
+
+/* Move data[i] up through grandparents on its own kind of level
+
+	param: 	h		pointer to the heap
+	param: 	i		index of the value to move
+	param: 	isMin	1 if i is on a min level, else 0
+	pre:	data[i] is correctly ordered against its parent
+*/
+static void _bubbleUpLevel(struct minMaxHeap *h, int i, int isMin)
+{
+    while (i > 2) {
+        int grandparent = ((i - 1) / 2 - 1) / 2;
+
+        if (!_ahead(h->data[i], h->data[grandparent], isMin))
+            break;
+        _swap(h->data, i, grandparent);
+        i = grandparent;
+    }
+}
+
+/* Restore heap order after a value is placed at index i */
+static void _bubbleUp(struct minMaxHeap *h, int i)
+{
+    int isMin = _isMinLevel(i);
+
+    if (i == 0)
+        return;
+
+    int parent = (i - 1) / 2;
+
+    //a value out of order with its parent belongs on the other kind of level
+    if (_ahead(h->data[parent], h->data[i], isMin)) {
+        _swap(h->data, i, parent);
+        _bubbleUpLevel(h, parent, !isMin);
+    }
+    else
+        _bubbleUpLevel(h, i, isMin);
+}
+
+/* Restore heap order after a value is placed at index i
+
+	param: 	h		pointer to the heap
+	param: 	i		index of the value to move down
+	param: 	isMin	1 if i is on a min level, else 0
+*/
+static void _trickleDown(struct minMaxHeap *h, int i, int isMin)
+{
+    TYPE *data = h->data;
+
+    while (2 * i + 1 < h->size) {
+        //find the best of the children and grandchildren
+        int best = 2 * i + 1;
+        int candidates[5] = {2 * i + 2, 4 * i + 3, 4 * i + 4, 4 * i + 5, 4 * i + 6};
+
+        for (int c = 0; c < 5 && candidates[c] < h->size; c++)
+            if (_ahead(data[candidates[c]], data[best], isMin))
+                best = candidates[c];
+
+        if (!_ahead(data[best], data[i], isMin))
+            return;
+
+        _swap(data, i, best);
+
+        //a child is on the other kind of level and has nothing below to fix
+        if (best <= 2 * i + 2)
+            return;
+
+        int parent = (best - 1) / 2;
+        if (_ahead(data[parent], data[best], isMin))
+            _swap(data, best, parent);
+        i = best;
+    }
+}
+
+/* Check whether the heap is empty
+
+	param: 	h		pointer to the heap
+	pre:	h is not null
+	ret: 	1 if the heap is empty. Otherwise, 0.
+*/
+int isEmptyMinMaxHeap(struct minMaxHeap *h)
+{
+    if (h == 0)
+        _gracefulExit("Passed null minMaxHeap ptr to isEmptyMinMaxHeap", 2);
+
+    return h->size == 0;
+}
+
+/* Number of values in the heap
+
+	param: 	h		pointer to the heap
+	pre:	h is not null
+	ret: 	the size of the heap
+*/
+int sizeMinMaxHeap(struct minMaxHeap *h)
+{
+    if (h == 0)
+        _gracefulExit("Passed null minMaxHeap ptr to sizeMinMaxHeap", 3);
+
+    return h->size;
+}
+
+/* Add a value to the heap in O(log n)
+
+	param: 	h		pointer to the heap
+	param: 	val		the value to add
+	pre:	h is not null
+	post:	val is in the heap, size increased by 1
+*/
+void addMinMaxHeap(struct minMaxHeap *h, TYPE val)
+{
+    if (h == 0)
+        _gracefulExit("Passed null minMaxHeap ptr to addMinMaxHeap", 4);
+
+    if (h->size == h->capacity) {
+        h->capacity *= 2;
+        h->data = realloc(h->data, sizeof(TYPE) * h->capacity);
+        assert(h->data != 0);
+    }
+
+    h->data[h->size] = val;
+    h->size++;
+    _bubbleUp(h, h->size - 1);
+}
+
+/* Index of the largest value, h is not empty */
+static int _maxIndex(struct minMaxHeap *h)
+{
+    if (h->size == 1)
+        return 0;
+    if (h->size == 2 || !LT(h->data[1], h->data[2]))
+        return 1;
+    return 2;
+}
+
+/* Get the smallest value in the heap
+
+	param: 	h		pointer to the heap
+	pre:	h is not null and h is not empty
+	ret: 	the smallest value under LT
+*/
+TYPE frontMinMaxHeap(struct minMaxHeap *h)
+{
+    if (h == 0)
+        _gracefulExit("Passed null minMaxHeap ptr to frontMinMaxHeap", 5);
+
+    if (h->size < 1)
+        _gracefulExit("Passed empty minMaxHeap to frontMinMaxHeap", 6);
+
+    return h->data[0];
+}
+
+/* Get the largest value in the heap
+
+	param: 	h		pointer to the heap
+	pre:	h is not null and h is not empty
+	ret: 	the largest value under LT
+*/
+TYPE backMinMaxHeap(struct minMaxHeap *h)
+{
+    if (h == 0)
+        _gracefulExit("Passed null minMaxHeap ptr to backMinMaxHeap", 7);
+
+    if (h->size < 1)
+        _gracefulExit("Passed empty minMaxHeap to backMinMaxHeap", 8);
+
+    return h->data[_maxIndex(h)];
+}
+
+/* Remove the smallest value in O(log n)
+
+	param: 	h		pointer to the heap
+	pre:	h is not null and h is not empty
+	post:	size reduced by 1
+*/
+void removeFrontMinMaxHeap(struct minMaxHeap *h)
+{
+    if (h == 0)
+        _gracefulExit("Passed null minMaxHeap ptr to removeFrontMinMaxHeap", 9);
+
+    if (h->size < 1)
+        _gracefulExit("Passed empty minMaxHeap to removeFrontMinMaxHeap", 10);
+
+    h->size--;
+    h->data[0] = h->data[h->size];
+    _trickleDown(h, 0, 1);
+}
+
+/* Remove the largest value in O(log n)
+
+	param: 	h		pointer to the heap
+	pre:	h is not null and h is not empty
+	post:	size reduced by 1
+*/
+void removeBackMinMaxHeap(struct minMaxHeap *h)
+{
+    if (h == 0)
+        _gracefulExit("Passed null minMaxHeap ptr to removeBackMinMaxHeap", 11);
+
+    if (h->size < 1)
+        _gracefulExit("Passed empty minMaxHeap to removeBackMinMaxHeap", 12);
+
+    int i = _maxIndex(h);
+
+    h->size--;
+    h->data[i] = h->data[h->size];
+    if (i < h->size)
+        _trickleDown(h, i, i == 0);
+}
@@ -0,0 +1,22 @@
+#ifndef __MINMAXHEAP_H
+#define __MINMAXHEAP_H
+
+/* TYPE and LT come from the deque header so both containers order alike */
+#include "cirListDeque.h"
+
+/* Double ended priority queue: front is the smallest element and back is
+   the largest, both under LT */
+struct minMaxHeap;
+
+struct minMaxHeap *createMinMaxHeap(int capacity);
+void deleteMinMaxHeap(struct minMaxHeap *h);
+
+int  isEmptyMinMaxHeap(struct minMaxHeap *h);
+int  sizeMinMaxHeap(struct minMaxHeap *h);
+void addMinMaxHeap(struct minMaxHeap *h, TYPE val);
+TYPE frontMinMaxHeap(struct minMaxHeap *h);
+TYPE backMinMaxHeap(struct minMaxHeap *h);
+void removeFrontMinMaxHeap(struct minMaxHeap *h);
+void removeBackMinMaxHeap(struct minMaxHeap *h);
+
+#endif
@@ -0,0 +1,566 @@
+/* nodeCache.c
+ * per-thread node cache implementation file.
+ 
+ Description:   Each thread gets one cache per pool. A cache owns the slabs
+                it carved, keeps a private free list for its own nodes and a
+                lock-free "remote" stack that other threads push freed nodes
+                onto. A thread freeing a node it does not own collects it in
+                a batch for that owner and pushes the whole chain with one
+                compare-and-swap once NODE_REMOTE_BATCH nodes have gathered
+                (or the owner changes, or the thread exits). The owner takes
+                its entire remote stack with one exchange when its private
+                list runs dry, so the stack needs no ABA protection.
+
+                Slabs are NODE_SLAB_SIZE aligned, which finds a node's owner
+                from its address without a per-node header. The cache of an
+                exiting thread is parked and adopted by the next new thread,
+                so nodes still in use keep a live owner.
+
+                trimNodeCache finds slabs whose nodes are all free, takes
+                them off the free lists and returns their pages to the OS
+                with madvise. The slab keeps its address range and header
+                and is reused, faulting in fresh pages, before any new slab
+                is allocated.
+
+                In huge page mode slabs are carved from NODE_ARENA_SIZE arenas
+                instead of being allocated one by one, so a few TLB entries
+                cover millions of nodes. An arena is mapped with MAP_HUGETLB
+                when the system has huge pages reserved, else mapped 2MB
+                aligned and advised MADV_HUGEPAGE for transparent huge pages,
+                else (no mmap) slabs fall back to posix_memalign. Arenas are
+                aligned to their size, so slabs keep NODE_SLAB_SIZE alignment.
+                Trimming a slab of a transparent huge page splits that page;
+                hugetlb pages cannot be returned piecewise, so their slabs go
+                dormant without releasing memory and still count as resident.
+**** */
+
+#include "nodeCache.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+# define NODE_SLAB_SIZE     (64 * 1024)
+# define NODE_SLAB_HEADER   64          /* keeps the first node cache line aligned */
+# define NODE_REMOTE_BATCH  64
+# define NODE_MAX_POOLS     16
+# define NODE_ARENA_SIZE    (2 * 1024 * 1024)   /* one huge page */
+
+struct freeNode {
+    struct freeNode *next;
+};
+
+struct nodeCache;
+
+/* Header at the start of every slab */
+struct nodeSlab {
+    struct nodeCache *owner;    /* cache the slab's nodes are returned to, null while dormant */
+    struct nodeSlab *next;      /* all slabs of the pool */
+    struct nodeSlab *nextDormant;
+    int freeCount;              /* scratch count of free nodes while trimming */
+    int unbacked;               /* dormant with its pages past the first returned */
+};
+
+/* One thread's view of a pool */
+struct nodeCache {
+    struct nodePool *pool;
+    struct freeNode *local;                 /* owner-only free list */
+    _Atomic(struct freeNode *) remote;      /* nodes freed by other threads */
+
+    /* foreign nodes waiting to go back to batchOwner */
+    struct nodeCache *batchOwner;
+    struct freeNode *batchHead;
+    struct freeNode *batchTail;
+    int batchCount;
+
+    struct nodeCache *nextParked;
+};
+
+struct nodePool {
+    int id;
+    size_t nodeSize;
+    int nodesPerSlab;
+    pthread_key_t key;          /* runs _releaseCache at thread exit */
+    pthread_mutex_t lock;       /* guards parked and slabs */
+    struct nodeCache *parked;   /* caches of exited threads */
+    struct nodeSlab *slabs;
+    struct nodeSlab *dormant;   /* trimmed slabs waiting for reuse, guarded by lock */
+    char *arena;                /* uncarved rest of the current arena, guarded by lock */
+    size_t arenaLeft;
+    atomic_long slabCount;
+    atomic_long unbackedCount;  /* dormant slabs whose pages were returned */
+};
+
+static atomic_int _poolCount;
+static struct nodePool *_pools[NODE_MAX_POOLS];
+static __thread struct nodeCache *_caches[NODE_MAX_POOLS];
+static atomic_int _hugePages;
+static atomic_int _arenaBacking;
+
+/*
+	_flushBatch
+	param: c the calling thread's cache
+	pre: c is not null
+	post: the batched foreign nodes are on their owner's remote stack
+*/
+static void _flushBatch(struct nodeCache *c)
+{
+    if (c->batchCount == 0)
+        return;
+
+    struct nodeCache *owner = c->batchOwner;
+    struct freeNode *old = atomic_load_explicit(&owner->remote, memory_order_relaxed);
+
+    do {
+        c->batchTail->next = old;
+    } while (!atomic_compare_exchange_weak_explicit(&owner->remote, &old, c->batchHead,
+                                                    memory_order_release, memory_order_relaxed));
+
+    c->batchOwner = 0;
+    c->batchHead = c->batchTail = 0;
+    c->batchCount = 0;
+}
+
+/*
+	_releaseCache
+	param: arg the exiting thread's cache
+	pre: called by pthread at thread exit
+	post: pending frees are flushed and the cache is parked for adoption
+*/
+static void _releaseCache(void *arg)
+{
+    struct nodeCache *c = arg;
+    struct nodePool *pool = c->pool;
+
+    _flushBatch(c);
+
+    pthread_mutex_lock(&pool->lock);
+    c->nextParked = pool->parked;
+    pool->parked = c;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+	_myCache
+	param: pool the pool
+	pre: pool is not null
+	post: the calling thread has a cache for pool
+	ret: the calling thread's cache
+*/
+static struct nodeCache *_myCache(struct nodePool *pool)
+{
+    struct nodeCache *c = _caches[pool->id];
+
+    if (c != 0)
+        return c;
+
+    //adopt a parked cache before making a new one
+    pthread_mutex_lock(&pool->lock);
+    c = pool->parked;
+    if (c != 0)
+        pool->parked = c->nextParked;
+    pthread_mutex_unlock(&pool->lock);
+
+    if (c == 0) {
+        c = calloc(1, sizeof(struct nodeCache));
+        assert(c != 0);
+        c->pool = pool;
+        atomic_init(&c->remote, 0);
+    }
+
+    _caches[pool->id] = c;
+    pthread_setspecific(pool->key, c);
+    return c;
+}
+
+/*
+	_mapArena
+	param: none
+	pre: none
+	post: an arena is mapped, on huge pages if the system allows
+	ret: the NODE_ARENA_SIZE aligned arena, or null if mmap failed
+*/
+static void *_mapArena()
+{
+    void *mem;
+
+# ifdef MAP_HUGETLB
+    mem = mmap(0, NODE_ARENA_SIZE, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mem != MAP_FAILED) {
+        atomic_store(&_arenaBacking, NODE_PAGES_HUGETLB);
+        return mem;
+    }
+# endif
+
+    //map twice the size and cut it down to an aligned arena
+    mem = mmap(0, 2 * NODE_ARENA_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+        return 0;
+
+    char *start = (char *)(((uintptr_t)mem + NODE_ARENA_SIZE - 1) & ~(uintptr_t)(NODE_ARENA_SIZE - 1));
+    if (start > (char *)mem)
+        munmap(mem, start - (char *)mem);
+    munmap(start + NODE_ARENA_SIZE, (char *)mem + NODE_ARENA_SIZE - start);
+
+    int backing = NODE_PAGES_REGULAR;
+# ifdef MADV_HUGEPAGE
+    if (madvise(start, NODE_ARENA_SIZE, MADV_HUGEPAGE) == 0)
+        backing = NODE_PAGES_THP;
+# endif
+    atomic_store(&_arenaBacking, backing);
+    return start;
+}
+
+/*
+	_arenaSlab
+	param: pool the pool
+	pre: pool->lock is held
+	post: a slab is carved from the pool's arena, mapping a new arena first
+	      when the current one is used up
+	ret: the slab, or null if no arena could be mapped
+*/
+static void *_arenaSlab(struct nodePool *pool)
+{
+    if (pool->arenaLeft == 0) {
+        pool->arena = _mapArena();
+        if (pool->arena == 0)
+            return 0;
+        pool->arenaLeft = NODE_ARENA_SIZE;
+    }
+
+    void *mem = pool->arena;
+    pool->arena += NODE_SLAB_SIZE;
+    pool->arenaLeft -= NODE_SLAB_SIZE;
+    return mem;
+}
+
+/*
+	_newSlab
+	param: c the calling thread's cache
+	pre: c->local is empty
+	post: the nodes of a new slab owned by c are on c->local
+*/
+static void _newSlab(struct nodeCache *c)
+{
+    struct nodePool *pool = c->pool;
+    void *mem = 0;
+
+    //a trimmed slab comes back before a new one is allocated
+    pthread_mutex_lock(&pool->lock);
+    struct nodeSlab *slab = pool->dormant;
+    if (slab != 0) {
+        pool->dormant = slab->nextDormant;
+        slab->owner = c;
+        if (slab->unbacked)
+            atomic_fetch_sub(&pool->unbackedCount, 1);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (slab != 0)
+        mem = slab;
+    else {
+        if (atomic_load_explicit(&_hugePages, memory_order_relaxed)) {
+            pthread_mutex_lock(&pool->lock);
+            mem = _arenaSlab(pool);
+            pthread_mutex_unlock(&pool->lock);
+        }
+        if (mem == 0) {
+            int rc = posix_memalign(&mem, NODE_SLAB_SIZE, NODE_SLAB_SIZE);
+            assert(rc == 0 && mem != 0);
+            (void)rc;
+        }
+
+        slab = mem;
+        slab->owner = c;
+        slab->unbacked = 0;
+
+        pthread_mutex_lock(&pool->lock);
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pthread_mutex_unlock(&pool->lock);
+        atomic_fetch_add(&pool->slabCount, 1);
+    }
+
+    //thread the nodes front to back so allocation walks the slab in order
+    char *node = (char *)mem + NODE_SLAB_HEADER;
+    struct freeNode *prev = 0;
+
+    for (int i = 0; i < pool->nodesPerSlab; i++) {
+        struct freeNode *f = (struct freeNode *)(node + (size_t)i * pool->nodeSize);
+        f->next = 0;
+        if (prev == 0)
+            c->local = f;
+        else
+            prev->next = f;
+        prev = f;
+    }
+}
+
+/*
+	createNodePool
+	param: nodeSize size of every node handed out by the pool
+	pre: 0 < nodeSize <= NODE_SLAB_SIZE / 8
+	post: an empty pool is allocated; pools live until the process exits
+	ret: the new pool
+*/
+struct nodePool *createNodePool(size_t nodeSize)
+{
+    assert(nodeSize > 0 && nodeSize <= NODE_SLAB_SIZE / 8);
+
+    struct nodePool *pool = malloc(sizeof(struct nodePool));
+    assert(pool != 0);
+
+    pool->id = atomic_fetch_add(&_poolCount, 1);
+    assert(pool->id < NODE_MAX_POOLS);
+
+    //room for the free list link, rounded to pointer alignment
+    if (nodeSize < sizeof(struct freeNode))
+        nodeSize = sizeof(struct freeNode);
+    pool->nodeSize = (nodeSize + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    pool->nodesPerSlab = (int)((NODE_SLAB_SIZE - NODE_SLAB_HEADER) / pool->nodeSize);
+
+    pthread_key_create(&pool->key, _releaseCache);
+    pthread_mutex_init(&pool->lock, 0);
+    pool->parked = 0;
+    pool->slabs = 0;
+    pool->dormant = 0;
+    pool->arena = 0;
+    pool->arenaLeft = 0;
+    atomic_init(&pool->slabCount, 0);
+    atomic_init(&pool->unbackedCount, 0);
+    _pools[pool->id] = pool;
+    return pool;
+}
+
+/*
+	allocNode
+	param: pool the pool
+	pre: pool is not null
+	post: none
+	ret: an uninitialized node of the pool's node size
+*/
+void *allocNode(struct nodePool *pool)
+{
+    assert(pool != 0);
+
+    struct nodeCache *c = _myCache(pool);
+
+    if (c->local == 0) {
+        //reclaim everything other threads returned, else carve a new slab
+        c->local = atomic_exchange_explicit(&c->remote, 0, memory_order_acquire);
+        if (c->local == 0)
+            _newSlab(c);
+    }
+
+    struct freeNode *f = c->local;
+    c->local = f->next;
+    return f;
+}
+
+/*
+	freeNode
+	param: pool the pool node came from
+	param: node the node to free
+	pre: node was returned by allocNode(pool) and not freed since
+	post: node can be handed out again by its owning cache
+*/
+void freeNode(struct nodePool *pool, void *node)
+{
+    assert(pool != 0);
+
+    if (node == 0)
+        return;
+
+    struct nodeCache *c = _myCache(pool);
+    struct nodeSlab *slab = (struct nodeSlab *)((uintptr_t)node & ~(uintptr_t)(NODE_SLAB_SIZE - 1));
+    struct freeNode *f = node;
+
+    if (slab->owner == c) {
+        f->next = c->local;
+        c->local = f;
+        return;
+    }
+
+    //foreign node, batch it for its owner
+    if (c->batchOwner != slab->owner)
+        _flushBatch(c);
+
+    f->next = c->batchHead;
+    c->batchHead = f;
+    if (c->batchTail == 0)
+        c->batchTail = f;
+    c->batchOwner = slab->owner;
+
+    if (++c->batchCount >= NODE_REMOTE_BATCH)
+        _flushBatch(c);
+}
+
+/*
+	flushNodeCache
+	param: none
+	pre: none
+	post: the calling thread has no batched foreign frees in any pool
+*/
+void flushNodeCache()
+{
+    int pools = atomic_load(&_poolCount);
+
+    for (int i = 0; i < pools && i < NODE_MAX_POOLS; i++)
+        if (_caches[i] != 0)
+            _flushBatch(_caches[i]);
+}
+
+/*
+	_trimCache
+	param: c a cache no other thread is allocating from
+	pre: c is not null
+	post: the nodes of c's slabs that are entirely free are off c's lists
+	ret: those slabs, chained through nextDormant
+*/
+static struct nodeSlab *_trimCache(struct nodeCache *c)
+{
+    struct nodePool *pool = c->pool;
+    struct freeNode *f, **p;
+    struct nodeSlab *emptied = 0;
+
+    //gather every free node the cache can see onto its local list
+    _flushBatch(c);
+    f = atomic_exchange_explicit(&c->remote, 0, memory_order_acquire);
+    while (f != 0) {
+        struct freeNode *next = f->next;
+        f->next = c->local;
+        c->local = f;
+        f = next;
+    }
+
+    for (f = c->local; f != 0; f = f->next)
+        ((struct nodeSlab *)((uintptr_t)f & ~(uintptr_t)(NODE_SLAB_SIZE - 1)))->freeCount = 0;
+    for (f = c->local; f != 0; f = f->next)
+        ((struct nodeSlab *)((uintptr_t)f & ~(uintptr_t)(NODE_SLAB_SIZE - 1)))->freeCount++;
+
+    //unthread the nodes of full slabs, collecting each slab once
+    p = &c->local;
+    while (*p != 0) {
+        struct nodeSlab *slab = (struct nodeSlab *)((uintptr_t)*p & ~(uintptr_t)(NODE_SLAB_SIZE - 1));
+
+        if (slab->freeCount == pool->nodesPerSlab || slab->freeCount < 0) {
+            if (slab->freeCount > 0) {
+                slab->freeCount = -1;
+                slab->nextDormant = emptied;
+                emptied = slab;
+            }
+            *p = (*p)->next;
+        }
+        else
+            p = &(*p)->next;
+    }
+    return emptied;
+}
+
+/*
+	_retireSlabs
+	param: pool the pool the slabs belong to
+	param: emptied slabs with no node in use, chained through nextDormant
+	pre: pool->lock is held
+	post: the slabs are dormant, with their pages past the first returned
+	      to the OS where madvise allows it
+	ret: bytes returned
+*/
+static size_t _retireSlabs(struct nodePool *pool, struct nodeSlab *emptied)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE), released = 0;
+
+    while (emptied != 0) {
+        struct nodeSlab *slab = emptied;
+        emptied = slab->nextDormant;
+
+        //the header page stays so the slab can be reused; hugetlb refuses
+        slab->unbacked = page < NODE_SLAB_SIZE
+                         && madvise((char *)slab + page, NODE_SLAB_SIZE - page, MADV_DONTNEED) == 0;
+        if (slab->unbacked) {
+            released += NODE_SLAB_SIZE - page;
+            atomic_fetch_add(&pool->unbackedCount, 1);
+        }
+
+        slab->owner = 0;
+        slab->nextDormant = pool->dormant;
+        pool->dormant = slab;
+    }
+    return released;
+}
+
+/*
+	trimNodeCache
+	param: none
+	pre: none
+	post: slabs of the calling thread's caches and of exited threads' caches
+	      whose nodes are all free are returned to the OS; nodes still held
+	      in other live threads' caches are not looked at
+	ret: bytes returned to the OS
+*/
+size_t trimNodeCache()
+{
+    int pools = atomic_load(&_poolCount);
+    size_t released = 0;
+
+    for (int i = 0; i < pools && i < NODE_MAX_POOLS; i++) {
+        struct nodePool *pool = _pools[i];
+        if (pool == 0)
+            continue;
+
+        struct nodeSlab *mine = (_caches[i] != 0) ? _trimCache(_caches[i]) : 0;
+
+        pthread_mutex_lock(&pool->lock);
+        released += _retireSlabs(pool, mine);
+        for (struct nodeCache *c = pool->parked; c != 0; c = c->nextParked)
+            released += _retireSlabs(pool, _trimCache(c));
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return released;
+}
+
+/*
+	residentNodeCache
+	param: none
+	pre: none
+	ret: bytes of every pool's slabs except dormant ones whose pages were
+	     returned
+*/
+size_t residentNodeCache()
+{
+    int pools = atomic_load(&_poolCount);
+    size_t bytes = 0;
+
+    for (int i = 0; i < pools && i < NODE_MAX_POOLS; i++)
+        if (_pools[i] != 0)
+            bytes += (size_t)(atomic_load(&_pools[i]->slabCount) - atomic_load(&_pools[i]->unbackedCount)) * NODE_SLAB_SIZE;
+    return bytes;
+}
+
+/*
+	hugePagesNodeCache
+	param: on 1 to carve new slabs from huge page arenas, 0 to go back to
+	       one aligned allocation per slab
+	pre: none
+	post: slabs created from now on follow the mode
+*/
+void hugePagesNodeCache(int on)
+{
+    atomic_store(&_hugePages, on != 0);
+}
+
+/*
+	pageBackingNodeCache
+	param: none
+	pre: none
+	ret: NODE_PAGES_HUGETLB, NODE_PAGES_THP or NODE_PAGES_REGULAR for the
+	     arena mapped last, NODE_PAGES_REGULAR before any
+*/
+int pageBackingNodeCache()
+{
+    return atomic_load(&_arenaBacking);
+}
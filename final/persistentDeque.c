@@ -0,0 +1,425 @@
+/* persistentDeque.c
+ * persistent deque implementation file.
+ 
+ Description:   Banker's deque over immutable, reference counted cons cells.
+                A version is a front list (front element first) and a rear
+                list (back element first) plus their lengths. Adds and
+                removes cons onto or step past the head of one list and
+                share the rest. When one list grows to more than
+                PD_BALANCE times the other plus one, both are rebuilt with
+                half of the elements each, which keeps every operation
+                amortized O(1) for a single line of versions.
+
+                Cells and versions carry atomic reference counts. A version
+                holds one reference on each list head and every cell holds
+                one on its successor, so releasing the last reference to a
+                version frees exactly the cells no other version reaches.
+ **** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "persistentDeque.h"
+
+# define PD_BALANCE 3
+
+struct pdCell {
+    TYPE value;
+    struct pdCell *next;
+    atomic_int refs;
+};
+
+struct persistentDeque {
+    struct pdCell *front;   /* front element first */
+    struct pdCell *rear;    /* back element first */
+    int frontLen;
+    int rearLen;
+    atomic_int refs;
+};
+
+struct pDequeRoot {
+    struct persistentDeque *current;
+    pthread_mutex_t lock;   /* held only to swap or retain current */
+};
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* New cell owning one reference to next */
+static struct pdCell *_cons(TYPE val, struct pdCell *next)
+{
+    struct pdCell *c = malloc(sizeof(struct pdCell));
+    assert(c != 0);
+    c->value = val;
+    c->next = next;
+    atomic_init(&c->refs, 1);
+    return c;
+}
+
+static struct pdCell *_retainCell(struct pdCell *c)
+{
+    if (c != 0)
+        atomic_fetch_add_explicit(&c->refs, 1, memory_order_relaxed);
+    return c;
+}
+
+/* Drop one reference to c, freeing the run of cells nobody else reaches */
+static void _releaseCells(struct pdCell *c)
+{
+    while (c != 0 && atomic_fetch_sub_explicit(&c->refs, 1, memory_order_acq_rel) == 1) {
+        struct pdCell *next = c->next;
+        free(c);
+        c = next;
+    }
+}
+
+/* Copy the first n cells of list, ending the copy with tail.
+   The copy owns the reference to tail passed in. */
+static struct pdCell *_copyPrefix(struct pdCell *list, int n, struct pdCell *tail)
+{
+    struct pdCell *head = tail, **link = &head;
+
+    for (int i = 0; i < n; i++, list = list->next) {
+        struct pdCell *c = _cons(list->value, tail);
+        *link = c;
+        link = &c->next;
+    }
+    return head;
+}
+
+/* Cells of list from index skip to the end, in reverse order */
+static struct pdCell *_reverseSuffix(struct pdCell *list, int skip)
+{
+    struct pdCell *reversed = 0;
+
+    for (int i = 0; list != 0; i++, list = list->next)
+        if (i >= skip)
+            reversed = _cons(list->value, reversed);
+    return reversed;
+}
+
+/* Build a version from lists whose references the caller hands over,
+   splitting the elements evenly if one side has grown too long */
+static struct persistentDeque *_makeVersion(struct pdCell *front, int frontLen,
+                                            struct pdCell *rear, int rearLen)
+{
+    struct persistentDeque *d = malloc(sizeof(struct persistentDeque));
+    assert(d != 0);
+
+    if (frontLen > PD_BALANCE * rearLen + 1 || rearLen > PD_BALANCE * frontLen + 1) {
+        int total = frontLen + rearLen;
+        int keepFront = (frontLen > rearLen) ? total / 2 : (total + 1) / 2;
+        struct pdCell *newFront, *newRear;
+
+        if (frontLen > rearLen) {
+            //front keeps its first half, the rest moves reversed behind rear
+            newFront = _copyPrefix(front, keepFront, 0);
+            newRear = _copyPrefix(rear, rearLen, _reverseSuffix(front, keepFront));
+        }
+        else {
+            newRear = _copyPrefix(rear, total - keepFront, 0);
+            newFront = _copyPrefix(front, frontLen, _reverseSuffix(rear, total - keepFront));
+        }
+
+        _releaseCells(front);
+        _releaseCells(rear);
+        front = newFront;
+        rear = newRear;
+        frontLen = keepFront;
+        rearLen = total - keepFront;
+    }
+
+    d->front = front;
+    d->rear = rear;
+    d->frontLen = frontLen;
+    d->rearLen = rearLen;
+    atomic_init(&d->refs, 1);
+    return d;
+}
+
+/* Create an empty version
+
+	pre:	none
+	ret: 	an empty deque holding one reference for the caller
+*/
+struct persistentDeque *createPDeque()
+{
+    return _makeVersion(0, 0, 0, 0);
+}
+
+/* Take another reference to a version, O(1). This is a snapshot.
+
+	param: 	d		the version
+	pre:	d is not null
+	ret: 	d
+*/
+struct persistentDeque *retainPDeque(struct persistentDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to retainPDeque", 1);
+
+    atomic_fetch_add_explicit(&d->refs, 1, memory_order_relaxed);
+    return d;
+}
+
+/* Drop a reference to a version
+
+	param: 	d		the version
+	pre:	d is not null, the caller holds a reference to d
+	post:	d and any cells no other version shares are freed once the
+			last reference is dropped
+*/
+void releasePDeque(struct persistentDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to releasePDeque", 2);
+
+    if (atomic_fetch_sub_explicit(&d->refs, 1, memory_order_acq_rel) == 1) {
+        _releaseCells(d->front);
+        _releaseCells(d->rear);
+        free(d);
+    }
+}
+
+/* Check whether a version is empty
+
+	param: 	d		the version
+	pre:	d is not null
+	ret: 	1 if the deque is empty. Otherwise, 0.
+*/
+int isEmptyPDeque(struct persistentDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to isEmptyPDeque", 3);
+
+    return d->frontLen + d->rearLen == 0;
+}
+
+/* Number of values in a version
+
+	param: 	d		the version
+	pre:	d is not null
+	ret: 	the size of the deque
+*/
+int sizePDeque(struct persistentDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to sizePDeque", 4);
+
+    return d->frontLen + d->rearLen;
+}
+
+/* Get the front value of a version
+
+	param: 	d		the version
+	pre:	d is not null and d is not empty
+	ret: 	the front value
+*/
+TYPE frontPDeque(struct persistentDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to frontPDeque", 5);
+
+    if (isEmptyPDeque(d))
+        _gracefulExit("Passed empty persistentDeque to frontPDeque", 6);
+
+    //a balanced deque with an empty front holds a single value in rear
+    return (d->front != 0) ? d->front->value : d->rear->value;
+}
+
+/* Get the back value of a version
+
+	param: 	d		the version
+	pre:	d is not null and d is not empty
+	ret: 	the back value
+*/
+TYPE backPDeque(struct persistentDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to backPDeque", 7);
+
+    if (isEmptyPDeque(d))
+        _gracefulExit("Passed empty persistentDeque to backPDeque", 8);
+
+    return (d->rear != 0) ? d->rear->value : d->front->value;
+}
+
+/* Copy the values of a version out front to back
+
+	param: 	d		the version
+	param: 	vals	receives sizePDeque(d) values
+	pre:	d is not null, vals is not null
+*/
+void toArrayPDeque(struct persistentDeque *d, TYPE *vals)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to toArrayPDeque", 9);
+
+    assert(vals != 0);
+
+    int i = 0;
+    for (struct pdCell *c = d->front; c != 0; c = c->next)
+        vals[i++] = c->value;
+
+    i = d->frontLen + d->rearLen;
+    for (struct pdCell *c = d->rear; c != 0; c = c->next)
+        vals[--i] = c->value;
+}
+
+/* New version with val added at the front
+
+	param: 	d		the version
+	param: 	val		value to add
+	pre:	d is not null
+	ret: 	the new version, d is unchanged
+*/
+struct persistentDeque *addFrontPDeque(struct persistentDeque *d, TYPE val)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to addFrontPDeque", 10);
+
+    return _makeVersion(_cons(val, _retainCell(d->front)), d->frontLen + 1,
+                        _retainCell(d->rear), d->rearLen);
+}
+
+/* New version with val added at the back
+
+	param: 	d		the version
+	param: 	val		value to add
+	pre:	d is not null
+	ret: 	the new version, d is unchanged
+*/
+struct persistentDeque *addBackPDeque(struct persistentDeque *d, TYPE val)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to addBackPDeque", 11);
+
+    return _makeVersion(_retainCell(d->front), d->frontLen,
+                        _cons(val, _retainCell(d->rear)), d->rearLen + 1);
+}
+
+/* New version without the front value
+
+	param: 	d		the version
+	pre:	d is not null and d is not empty
+	ret: 	the new version, d is unchanged
+*/
+struct persistentDeque *removeFrontPDeque(struct persistentDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to removeFrontPDeque", 12);
+
+    if (isEmptyPDeque(d))
+        _gracefulExit("Passed empty persistentDeque to removeFrontPDeque", 13);
+
+    if (d->front == 0)  //the single value lives in rear
+        return _makeVersion(0, 0, 0, 0);
+
+    return _makeVersion(_retainCell(d->front->next), d->frontLen - 1,
+                        _retainCell(d->rear), d->rearLen);
+}
+
+/* New version without the back value
+
+	param: 	d		the version
+	pre:	d is not null and d is not empty
+	ret: 	the new version, d is unchanged
+*/
+struct persistentDeque *removeBackPDeque(struct persistentDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null persistentDeque ptr to removeBackPDeque", 14);
+
+    if (isEmptyPDeque(d))
+        _gracefulExit("Passed empty persistentDeque to removeBackPDeque", 15);
+
+    if (d->rear == 0)   //the single value lives in front
+        return _makeVersion(0, 0, 0, 0);
+
+    return _makeVersion(_retainCell(d->front), d->frontLen,
+                        _retainCell(d->rear->next), d->rearLen - 1);
+}
+
+/* Create a root holding an empty version
+
+	pre:	none
+	post:	the root and its lock are initialized
+*/
+struct pDequeRoot *createPDequeRoot()
+{
+    struct pDequeRoot *root = malloc(sizeof(struct pDequeRoot));
+    assert(root != 0);
+    root->current = createPDeque();
+    pthread_mutex_init(&root->lock, 0);
+    return root;
+}
+
+/* Deallocate a root and drop its reference to the current version
+
+	param: 	root	the root
+	pre:	root is not null, no thread is using root
+*/
+void deletePDequeRoot(struct pDequeRoot *root)
+{
+    if (root == 0)
+        _gracefulExit("Passed null pDequeRoot ptr to deletePDequeRoot", 16);
+
+    releasePDeque(root->current);
+    pthread_mutex_destroy(&root->lock);
+    free(root);
+}
+
+/* Snapshot the current version in O(1). The lock only covers the
+   retain, so a concurrent publish cannot free the version in between.
+
+	param: 	root	the root
+	pre:	root is not null
+	ret: 	the current version, holding one reference for the caller
+*/
+struct persistentDeque *snapshotPDequeRoot(struct pDequeRoot *root)
+{
+    if (root == 0)
+        _gracefulExit("Passed null pDequeRoot ptr to snapshotPDequeRoot", 17);
+
+    pthread_mutex_lock(&root->lock);
+    struct persistentDeque *d = retainPDeque(root->current);
+    pthread_mutex_unlock(&root->lock);
+    return d;
+}
+
+/* Make d the current version
+
+	param: 	root	the root
+	param: 	d		the new version; the caller's reference moves to root
+	pre:	root is not null, d is not null
+	post:	the previous version's root reference is dropped
+*/
+void publishPDequeRoot(struct pDequeRoot *root, struct persistentDeque *d)
+{
+    if (root == 0)
+        _gracefulExit("Passed null pDequeRoot ptr to publishPDequeRoot", 18);
+
+    assert(d != 0);
+
+    pthread_mutex_lock(&root->lock);
+    struct persistentDeque *old = root->current;
+    root->current = d;
+    pthread_mutex_unlock(&root->lock);
+
+    releasePDeque(old);
+}
@@ -0,0 +1,37 @@
+#ifndef __PERSISTENTDEQUE_H
+#define __PERSISTENTDEQUE_H
+
+#include "cirListDeque.h"
+
+/* Immutable deque version. Updates return a new version that shares
+   structure with the old one, so a snapshot is just another reference and
+   any number of threads can read versions without locking. Every version
+   returned to the caller holds one reference that releasePDeque drops. */
+struct persistentDeque;
+
+struct persistentDeque *createPDeque();
+struct persistentDeque *retainPDeque(struct persistentDeque *d);
+void releasePDeque(struct persistentDeque *d);
+
+int  isEmptyPDeque(struct persistentDeque *d);
+int  sizePDeque(struct persistentDeque *d);
+TYPE frontPDeque(struct persistentDeque *d);
+TYPE backPDeque(struct persistentDeque *d);
+void toArrayPDeque(struct persistentDeque *d, TYPE *vals);
+
+/* updates leave d untouched and return a new version */
+struct persistentDeque *addFrontPDeque(struct persistentDeque *d, TYPE val);
+struct persistentDeque *addBackPDeque(struct persistentDeque *d, TYPE val);
+struct persistentDeque *removeFrontPDeque(struct persistentDeque *d);
+struct persistentDeque *removeBackPDeque(struct persistentDeque *d);
+
+/* Shared slot holding the current version: writers publish new versions,
+   readers take O(1) snapshots of whatever is current */
+struct pDequeRoot;
+
+struct pDequeRoot *createPDequeRoot();
+void deletePDequeRoot(struct pDequeRoot *root);
+struct persistentDeque *snapshotPDequeRoot(struct pDequeRoot *root);
+void publishPDequeRoot(struct pDequeRoot *root, struct persistentDeque *d);
+
+#endif
@@ -0,0 +1,341 @@
+/* shardedDeque.c
+ * sharded multi-queue deque implementation file.
+
+ Description:   Relaxed order deque for many threads. The values live in
+                an array of cirListDeque shards, each with its own mutex
+                and on its own cache line. An add goes to the shard of the
+                CPU the thread runs on, trying the next shards when that
+                lock is busy, so producers on different cores never meet.
+                A remove samples two random shards and takes from the one
+                holding more values (power of two choices); the sizes are
+                kept in atomics so choosing needs no lock. If both samples
+                are empty the remaining shards are scanned once, so a
+                remove only fails when every shard was seen empty.
+
+                Values from one shard leave in FIFO order from the front,
+                but shards are drained at different rates, so the order
+                across shards is only approximately FIFO.
+ **** */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "shardedDeque.h"
+
+# define SHARD_LINE   64    /* shards do not share cache lines */
+# define SHARD_PROBES 2     /* busy shards an add skips before waiting */
+
+struct _shard {
+    _Alignas(SHARD_LINE) pthread_mutex_t lock;
+    struct cirListDeque *q;
+    atomic_int size;        /* read without the lock to pick shards */
+};
+
+struct shardedDeque {
+    struct _shard *shards;
+    int count;
+};
+
+static atomic_uint _threadCount;
+static __thread unsigned int _threadId;     /* 1 based, 0 until first use */
+static __thread unsigned int _seed;
+
+/* Prints custom error message and exits w/ custom error code
+
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+
+    //pre-conditions
+    assert(message != 0);
+
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* Next value of the calling thread's xorshift generator
+
+	ret: 	a pseudo random number, never 0
+*/
+static unsigned int _random()
+{
+    if (_seed == 0) {
+        if (_threadId == 0)
+            _threadId = atomic_fetch_add(&_threadCount, 1) + 1;
+        _seed = _threadId * 2654435761u | 1;
+    }
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return _seed;
+}
+
+/* Index of the shard local to the calling thread
+
+	param: 	s		pointer to the deque
+	ret: 	the shard of the current CPU, or of the thread where the CPU
+			is unknown
+*/
+static int _localShard(struct shardedDeque *s)
+{
+    int cpu = sched_getcpu();
+
+    if (cpu < 0) {
+        if (_threadId == 0)
+            _threadId = atomic_fetch_add(&_threadCount, 1) + 1;
+        cpu = (int)_threadId;
+    }
+    return cpu % s->count;
+}
+
+/* Create an empty sharded deque
+
+	param: 	shards	number of shards, <= 0 for one per CPU
+	pre:	none
+	post:	every shard is allocated, empty and unlocked
+*/
+struct shardedDeque *createShardedDeque(int shards)
+{
+    if (shards <= 0)
+        shards = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (shards <= 0)
+        shards = 1;
+
+    struct shardedDeque *s = malloc(sizeof(struct shardedDeque));
+    assert(s != 0);
+
+    void *mem = 0;
+    int rc = posix_memalign(&mem, SHARD_LINE, sizeof(struct _shard) * shards);
+    assert(rc == 0 && mem != 0);
+    (void)rc;
+
+    s->shards = mem;
+    s->count = shards;
+    for (int i = 0; i < shards; i++) {
+        pthread_mutex_init(&s->shards[i].lock, 0);
+        s->shards[i].q = createCirListDeque();
+        atomic_init(&s->shards[i].size, 0);
+    }
+    return s;
+}
+
+/* Deallocate the deque and any values left in it
+
+	param: 	s		pointer to the deque
+	pre:	s is not null, no thread is using s
+	post:	s is freed
+*/
+void deleteShardedDeque(struct shardedDeque *s)
+{
+    if (s == 0)
+        _gracefulExit("Passed null shardedDeque ptr to deleteShardedDeque", 1);
+
+    for (int i = 0; i < s->count; i++) {
+        deleteCirListDeque(s->shards[i].q);
+        pthread_mutex_destroy(&s->shards[i].lock);
+    }
+    free(s->shards);
+    free(s);
+}
+
+/* Check whether every shard is empty
+
+	param: 	s		pointer to the deque
+	pre:	s is not null
+	ret: 	1 if each shard was empty when checked. Otherwise, 0.
+*/
+int isEmptyShardedDeque(struct shardedDeque *s)
+{
+    if (s == 0)
+        _gracefulExit("Passed null shardedDeque ptr to isEmptyShardedDeque", 2);
+
+    for (int i = 0; i < s->count; i++)
+        if (atomic_load_explicit(&s->shards[i].size, memory_order_relaxed) != 0)
+            return 0;
+    return 1;
+}
+
+/* Number of values in the deque
+
+	param: 	s		pointer to the deque
+	pre:	s is not null
+	ret: 	sum of the shard sizes, each read at a slightly different time
+*/
+int sizeShardedDeque(struct shardedDeque *s)
+{
+    if (s == 0)
+        _gracefulExit("Passed null shardedDeque ptr to sizeShardedDeque", 3);
+
+    int size = 0;
+    for (int i = 0; i < s->count; i++)
+        size += atomic_load_explicit(&s->shards[i].size, memory_order_relaxed);
+    return size;
+}
+
+/* Number of shards
+
+	param: 	s		pointer to the deque
+	pre:	s is not null
+	ret: 	the shard count chosen at creation
+*/
+int shardsShardedDeque(struct shardedDeque *s)
+{
+    if (s == 0)
+        _gracefulExit("Passed null shardedDeque ptr to shardsShardedDeque", 4);
+
+    return s->count;
+}
+
+/* Lock a shard for an add: the local one if free, else one of the next
+   SHARD_PROBES if free, else wait for the local one
+
+	param: 	s		pointer to the deque
+	ret: 	the locked shard
+*/
+static struct _shard *_lockForAdd(struct shardedDeque *s)
+{
+    int home = _localShard(s);
+
+    for (int i = 0; i <= SHARD_PROBES && i < s->count; i++) {
+        struct _shard *sh = &s->shards[(home + i) % s->count];
+        if (pthread_mutex_trylock(&sh->lock) == 0)
+            return sh;
+    }
+
+    pthread_mutex_lock(&s->shards[home].lock);
+    return &s->shards[home];
+}
+
+/* Add a value at the back of the local shard
+
+	param: 	s		pointer to the deque
+	param: 	val		value to add
+	pre:	s is not null
+	post:	val is in one of the shards
+*/
+void addBackShardedDeque(struct shardedDeque *s, TYPE val)
+{
+    if (s == 0)
+        _gracefulExit("Passed null shardedDeque ptr to addBackShardedDeque", 5);
+
+    struct _shard *sh = _lockForAdd(s);
+    addBackCirListDeque(sh->q, val);
+    atomic_fetch_add_explicit(&sh->size, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&sh->lock);
+}
+
+/* Add a value at the front of the local shard
+
+	param: 	s		pointer to the deque
+	param: 	val		value to add
+	pre:	s is not null
+	post:	val is in one of the shards
+*/
+void addFrontShardedDeque(struct shardedDeque *s, TYPE val)
+{
+    if (s == 0)
+        _gracefulExit("Passed null shardedDeque ptr to addFrontShardedDeque", 6);
+
+    struct _shard *sh = _lockForAdd(s);
+    addFrontCirListDeque(sh->q, val);
+    atomic_fetch_add_explicit(&sh->size, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&sh->lock);
+}
+
+/* Take a value from one end of a shard, if it has one
+
+	param: 	sh		the shard
+	param: 	back	1 for the back end, 0 for the front
+	param: 	val		receives the value
+	ret: 	1 if a value was taken, 0 if the shard was empty
+*/
+static int _takeFrom(struct _shard *sh, int back, TYPE *val)
+{
+    int taken = 0;
+
+    pthread_mutex_lock(&sh->lock);
+    if (!isEmptyCirListDeque(sh->q)) {
+        if (back) {
+            *val = backCirListDeque(sh->q);
+            removeBackCirListDeque(sh->q);
+        }
+        else {
+            *val = frontCirListDeque(sh->q);
+            removeFrontCirListDeque(sh->q);
+        }
+        atomic_fetch_sub_explicit(&sh->size, 1, memory_order_relaxed);
+        taken = 1;
+    }
+    pthread_mutex_unlock(&sh->lock);
+    return taken;
+}
+
+/* Remove a value from the fuller of two random shards, scanning the
+   rest once if both are empty
+
+	param: 	s		pointer to the deque
+	param: 	back	1 for the back end, 0 for the front
+	param: 	val		receives the value
+	ret: 	1 if a value was removed, 0 if every shard was seen empty
+*/
+static int _remove(struct shardedDeque *s, int back, TYPE *val)
+{
+    int a = _random() % s->count, b = _random() % s->count;
+
+    if (atomic_load_explicit(&s->shards[b].size, memory_order_relaxed)
+        > atomic_load_explicit(&s->shards[a].size, memory_order_relaxed))
+        a = b;
+
+    if (atomic_load_explicit(&s->shards[a].size, memory_order_relaxed) > 0
+        && _takeFrom(&s->shards[a], back, val))
+        return 1;
+
+    //both samples empty or raced empty, look at every shard once
+    for (int i = 1; i <= s->count; i++) {
+        struct _shard *sh = &s->shards[(a + i) % s->count];
+        if (atomic_load_explicit(&sh->size, memory_order_relaxed) > 0 && _takeFrom(sh, back, val))
+            return 1;
+    }
+    return 0;
+}
+
+/* Remove a value from the front of a shard
+
+	param: 	s		pointer to the deque
+	param: 	val		receives the value
+	pre:	s is not null, val is not null
+	ret: 	1 if a value was removed, 0 if every shard was seen empty
+*/
+int removeFrontShardedDeque(struct shardedDeque *s, TYPE *val)
+{
+    if (s == 0)
+        _gracefulExit("Passed null shardedDeque ptr to removeFrontShardedDeque", 7);
+
+    assert(val != 0);
+    return _remove(s, 0, val);
+}
+
+/* Remove a value from the back of a shard
+
+	param: 	s		pointer to the deque
+	param: 	val		receives the value
+	pre:	s is not null, val is not null
+	ret: 	1 if a value was removed, 0 if every shard was seen empty
+*/
+int removeBackShardedDeque(struct shardedDeque *s, TYPE *val)
+{
+    if (s == 0)
+        _gracefulExit("Passed null shardedDeque ptr to removeBackShardedDeque", 8);
+
+    assert(val != 0);
+    return _remove(s, 1, val);
+}
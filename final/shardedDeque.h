@@ -0,0 +1,28 @@
+#ifndef __SHARDEDDEQUE_H
+#define __SHARDEDDEQUE_H
+
+#include "cirListDeque.h"
+
+/* Thread-safe deque made of many cirListDeque shards, each behind its own
+   lock. Adds go to the shard of the calling CPU and removes take from the
+   fuller of two random shards, so ordering is only approximately FIFO
+   (or LIFO from the back) while threads rarely contend on one lock. */
+struct shardedDeque;
+
+/* shards <= 0 makes one shard per CPU */
+struct shardedDeque *createShardedDeque(int shards);
+void deleteShardedDeque(struct shardedDeque *s);
+
+/* exact when no other thread is using s, a snapshot otherwise */
+int  isEmptyShardedDeque(struct shardedDeque *s);
+int  sizeShardedDeque(struct shardedDeque *s);
+int  shardsShardedDeque(struct shardedDeque *s);
+
+void addBackShardedDeque(struct shardedDeque *s, TYPE val);
+void addFrontShardedDeque(struct shardedDeque *s, TYPE val);
+
+/* remove return 1 and store the value in *val, or 0 if every shard was empty */
+int  removeFrontShardedDeque(struct shardedDeque *s, TYPE *val);
+int  removeBackShardedDeque(struct shardedDeque *s, TYPE *val);
+
+#endif
@@ -0,0 +1,101 @@
+/* shardedDequeBench.c
+ * sharded deque scaling benchmark.
+
+ Description:   T threads each run OPS add/remove pairs against one shared
+                deque, for T = 1, 2, 4, ... up to the core count (or the
+                count given on the command line). Reports operations per
+                second for the sharded deque and, as the baseline, for a
+                single cirListDeque behind one lock (blockingCirListDeque
+                polled with a zero timeout).
+                  gcc -O2 shardedDequeBench.c shardedDeque.c blockingCirListDeque.c cirListDeque.c -lpthread
+                  gcc -O2 -DNODE_CACHE shardedDequeBench.c shardedDeque.c blockingCirListDeque.c cirListDeque.c nodeCache.c -lpthread
+                Run:
+                  ./a.out [maxThreads]
+**** */
+
+#include "shardedDeque.h"
+#include "blockingCirListDeque.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+# define OPS     1000000    /* add/remove pairs per thread */
+# define PREFILL 1024       /* values queued before timing, so removes rarely miss */
+
+/*Function to get number of milliseconds of wall time*/
+double getMilliseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+struct shardedDeque *sharded;
+struct blockingCirListDeque *single;
+
+void *churnSharded(void *arg)
+{
+    TYPE v;
+    (void)arg;
+
+    for (int i = 0; i < OPS; i++) {
+        addBackShardedDeque(sharded, i);
+        removeFrontShardedDeque(sharded, &v);
+    }
+    return 0;
+}
+
+void *churnSingle(void *arg)
+{
+    TYPE v;
+    (void)arg;
+
+    for (int i = 0; i < OPS; i++) {
+        addBackBlockingCirListDeque(single, i);
+        removeFrontBlockingCirListDeque(single, &v, 0);
+    }
+    return 0;
+}
+
+/* Millions of operations per second of n threads running churn */
+double run(void *(*churn)(void *), int n)
+{
+    pthread_t *tids = malloc(sizeof(pthread_t) * n);
+
+    double t1 = getMilliseconds();
+    for (int i = 0; i < n; i++)
+        pthread_create(&tids[i], 0, churn, 0);
+    for (int i = 0; i < n; i++)
+        pthread_join(tids[i], 0);
+    double t2 = getMilliseconds();
+
+    free(tids);
+    return 2.0 * OPS * n / (t2 - t1) / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int max = (argc > 1) ? atoi(argv[1]) : cores;
+
+    if (max <= 0) {
+        printf("usage: %s [maxThreads]\n", argv[0]);
+        return 1;
+    }
+
+    sharded = createShardedDeque(0);
+    single = createBlockingCirListDeque();
+    for (int i = 0; i < PREFILL; i++) {
+        addBackShardedDeque(sharded, i);
+        addBackBlockingCirListDeque(single, i);
+    }
+
+    printf("%d cores, %d shards, %d add/remove pairs per thread\n", cores, shardsShardedDeque(sharded), OPS);
+    printf("%8s %16s %16s\n", "threads", "sharded Mops/s", "one lock Mops/s");
+    for (int n = 1; n <= max; n = (n < max && 2 * n > max) ? max : 2 * n)
+        printf("%8d %16.2f %16.2f\n", n, run(churnSharded, n), run(churnSingle, n));
+
+    deleteShardedDeque(sharded);
+    deleteBlockingCirListDeque(single);
+    return 0;
+}
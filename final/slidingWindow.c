@@ -0,0 +1,371 @@
+/* slidingWindow.c
+ * sliding window aggregation implementation file.
+ 
+ Description:   Min and max use monotonic cirListDeques: a new value first
+                pops every back value it beats, so the front is always the
+                window's extreme, and each value enters and leaves at most
+                once. Each extreme deque is paired with a deque of sequence
+                numbers so an expiring value is recognised at the front.
+
+                Count, sum, mean, variance and the custom aggregate use the
+                Two-Stacks algorithm. New values go on the back stack with
+                running aggregates. Expiry pops the front stack, which is
+                refilled by flipping the back stack when it runs dry, so
+                each value is combined a constant number of times and
+                order is kept for non-commutative combines. Mean and
+                variance are merged with Chan's parallel update, which
+                avoids the cancellation of sum-of-squares.
+
+                The timestamps of the live values are kept in FIFO order in
+                a cirListDeque for time based expiry.
+ **** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "slidingWindow.h"
+
+/* aggregate of a run of consecutive values */
+struct windowAgg {
+    double n;
+    double sum;
+    double mean;
+    double m2;          /* sum of squared deviations from mean */
+    double custom;
+};
+
+struct windowStack {
+    struct windowAgg *own;      /* the single value of each entry */
+    struct windowAgg *run;      /* aggregate up to and including each entry */
+    int size;
+    int capacity;
+};
+
+struct slidingWindow {
+    int mode;
+    double span;
+    windowCombine combine;
+    double identity;
+
+    struct windowStack front;   /* oldest value on top */
+    struct windowStack back;    /* newest value on top */
+
+    struct cirListDeque *times;     /* timestamps, oldest first */
+    struct cirListDeque *minVals;   /* increasing from the front */
+    struct cirListDeque *minSeqs;
+    struct cirListDeque *maxVals;   /* decreasing from the front */
+    struct cirListDeque *maxSeqs;
+    double nextSeq;                 /* sequence number of the next value */
+    int size;
+};
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* Aggregate of the values of a followed by the values of b */
+static struct windowAgg _combine(struct slidingWindow *w, struct windowAgg a, struct windowAgg b)
+{
+    struct windowAgg r;
+
+    if (a.n == 0)
+        return b;
+    if (b.n == 0)
+        return a;
+
+    double delta = b.mean - a.mean;
+    r.n = a.n + b.n;
+    r.sum = a.sum + b.sum;
+    r.mean = a.mean + delta * b.n / r.n;
+    r.m2 = a.m2 + b.m2 + delta * delta * a.n * b.n / r.n;
+    r.custom = (w->combine != 0) ? w->combine(a.custom, b.custom) : w->identity;
+    return r;
+}
+
+static struct windowAgg _empty(struct slidingWindow *w)
+{
+    struct windowAgg e = {0, 0, 0, 0, w->identity};
+    return e;
+}
+
+static void _pushStack(struct windowStack *s, struct windowAgg own, struct windowAgg run)
+{
+    if (s->size == s->capacity) {
+        s->capacity = s->capacity ? 2 * s->capacity : 64;
+        s->own = realloc(s->own, sizeof(struct windowAgg) * s->capacity);
+        s->run = realloc(s->run, sizeof(struct windowAgg) * s->capacity);
+        assert(s->own != 0 && s->run != 0);
+    }
+    s->own[s->size] = own;
+    s->run[s->size] = run;
+    s->size++;
+}
+
+/* Aggregate over the whole window */
+static struct windowAgg _query(struct slidingWindow *w)
+{
+    struct windowAgg f = w->front.size ? w->front.run[w->front.size - 1] : _empty(w);
+    struct windowAgg b = w->back.size ? w->back.run[w->back.size - 1] : _empty(w);
+    return _combine(w, f, b);
+}
+
+/* Remove the oldest value from every structure */
+static void _evictOldest(struct slidingWindow *w)
+{
+    double seq = w->nextSeq - w->size;
+
+    if (w->front.size == 0) {
+        //flip: newest goes in first so the oldest ends on top
+        while (w->back.size > 0) {
+            struct windowAgg own = w->back.own[--w->back.size];
+            struct windowAgg run = w->front.size
+                ? _combine(w, own, w->front.run[w->front.size - 1]) : own;
+            _pushStack(&w->front, own, run);
+        }
+    }
+    w->front.size--;
+
+    if (frontCirListDeque(w->minSeqs) == seq) {
+        removeFrontCirListDeque(w->minSeqs);
+        removeFrontCirListDeque(w->minVals);
+    }
+    if (frontCirListDeque(w->maxSeqs) == seq) {
+        removeFrontCirListDeque(w->maxSeqs);
+        removeFrontCirListDeque(w->maxVals);
+    }
+    removeFrontCirListDeque(w->times);
+    w->size--;
+}
+
+/* Create an empty window
+
+	param: 	mode		WINDOW_COUNT or WINDOW_TIME
+	param: 	span		number of values, or time interval, kept
+	param: 	combine		associative combine for aggregateSlidingWindow, may be null
+	param: 	identity	identity value of combine
+	pre:	span > 0
+	post:	an empty window is allocated
+*/
+struct slidingWindow *createSlidingWindow(int mode, double span,
+                                          windowCombine combine, double identity)
+{
+    assert(mode == WINDOW_COUNT || mode == WINDOW_TIME);
+    assert(span > 0);
+
+    struct slidingWindow *w = calloc(1, sizeof(struct slidingWindow));
+    assert(w != 0);
+
+    w->mode = mode;
+    w->span = span;
+    w->combine = combine;
+    w->identity = identity;
+    w->times = createCirListDeque();
+    w->minVals = createCirListDeque();
+    w->minSeqs = createCirListDeque();
+    w->maxVals = createCirListDeque();
+    w->maxSeqs = createCirListDeque();
+    return w;
+}
+
+/* Deallocate the window
+
+	param: 	w		pointer to the window
+	pre:	w is not null
+	post:	w and its deques are freed
+*/
+void deleteSlidingWindow(struct slidingWindow *w)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to deleteSlidingWindow", 1);
+
+    free(w->front.own);
+    free(w->front.run);
+    free(w->back.own);
+    free(w->back.run);
+    deleteCirListDeque(w->times);
+    deleteCirListDeque(w->minVals);
+    deleteCirListDeque(w->minSeqs);
+    deleteCirListDeque(w->maxVals);
+    deleteCirListDeque(w->maxSeqs);
+    free(w);
+}
+
+/* Add the newest value and expire what falls out of the window
+
+	param: 	w		pointer to the window
+	param: 	time	timestamp of val, ignored in WINDOW_COUNT mode
+	param: 	val		the value
+	pre:	w is not null, time is not before the previous push
+	post:	val is in the window
+*/
+void pushSlidingWindow(struct slidingWindow *w, double time, double val)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to pushSlidingWindow", 2);
+
+    double seq = w->nextSeq++;
+    struct windowAgg own = {1, val, val, 0, (w->combine != 0) ? val : w->identity};
+    struct windowAgg run = w->back.size ? _combine(w, w->back.run[w->back.size - 1], own) : own;
+    _pushStack(&w->back, own, run);
+
+    //drop the values the new one makes irrelevant
+    while (!isEmptyCirListDeque(w->minVals) && !LT(backCirListDeque(w->minVals), val)) {
+        removeBackCirListDeque(w->minVals);
+        removeBackCirListDeque(w->minSeqs);
+    }
+    addBackCirListDeque(w->minVals, val);
+    addBackCirListDeque(w->minSeqs, seq);
+
+    while (!isEmptyCirListDeque(w->maxVals) && !LT(val, backCirListDeque(w->maxVals))) {
+        removeBackCirListDeque(w->maxVals);
+        removeBackCirListDeque(w->maxSeqs);
+    }
+    addBackCirListDeque(w->maxVals, val);
+    addBackCirListDeque(w->maxSeqs, seq);
+
+    addBackCirListDeque(w->times, time);
+    w->size++;
+
+    if (w->mode == WINDOW_COUNT) {
+        while (w->size > w->span)
+            _evictOldest(w);
+    }
+    else
+        expireSlidingWindow(w, time);
+}
+
+/* Expire values at or before now - span without adding a value
+
+	param: 	w		pointer to the window
+	param: 	now		the current time
+	pre:	w is not null
+	post:	in WINDOW_TIME mode only values newer than now - span remain
+*/
+void expireSlidingWindow(struct slidingWindow *w, double now)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to expireSlidingWindow", 3);
+
+    if (w->mode != WINDOW_TIME)
+        return;
+
+    while (w->size > 0 && frontCirListDeque(w->times) <= now - w->span)
+        _evictOldest(w);
+}
+
+/* Number of values in the window
+
+	param: 	w		pointer to the window
+	pre:	w is not null
+*/
+int sizeSlidingWindow(struct slidingWindow *w)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to sizeSlidingWindow", 4);
+
+    return w->size;
+}
+
+/* Smallest value in the window
+
+	param: 	w		pointer to the window
+	pre:	w is not null and the window is not empty
+*/
+double minSlidingWindow(struct slidingWindow *w)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to minSlidingWindow", 5);
+
+    if (w->size < 1)
+        _gracefulExit("Passed empty slidingWindow to minSlidingWindow", 6);
+
+    return frontCirListDeque(w->minVals);
+}
+
+/* Largest value in the window
+
+	param: 	w		pointer to the window
+	pre:	w is not null and the window is not empty
+*/
+double maxSlidingWindow(struct slidingWindow *w)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to maxSlidingWindow", 7);
+
+    if (w->size < 1)
+        _gracefulExit("Passed empty slidingWindow to maxSlidingWindow", 8);
+
+    return frontCirListDeque(w->maxVals);
+}
+
+/* Sum of the values in the window, 0 when empty
+
+	param: 	w		pointer to the window
+	pre:	w is not null
+*/
+double sumSlidingWindow(struct slidingWindow *w)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to sumSlidingWindow", 9);
+
+    return _query(w).sum;
+}
+
+/* Mean of the values in the window
+
+	param: 	w		pointer to the window
+	pre:	w is not null and the window is not empty
+*/
+double meanSlidingWindow(struct slidingWindow *w)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to meanSlidingWindow", 10);
+
+    if (w->size < 1)
+        _gracefulExit("Passed empty slidingWindow to meanSlidingWindow", 11);
+
+    return _query(w).mean;
+}
+
+/* Population variance of the values in the window
+
+	param: 	w		pointer to the window
+	pre:	w is not null and the window is not empty
+*/
+double varianceSlidingWindow(struct slidingWindow *w)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to varianceSlidingWindow", 12);
+
+    if (w->size < 1)
+        _gracefulExit("Passed empty slidingWindow to varianceSlidingWindow", 13);
+
+    struct windowAgg a = _query(w);
+    return a.m2 / a.n;
+}
+
+/* Custom aggregate of the values in the window, oldest to newest
+
+	param: 	w		pointer to the window
+	pre:	w is not null
+	ret: 	identity when the window is empty or no combine was given
+*/
+double aggregateSlidingWindow(struct slidingWindow *w)
+{
+    if (w == 0)
+        _gracefulExit("Passed null slidingWindow ptr to aggregateSlidingWindow", 14);
+
+    return _query(w).custom;
+}
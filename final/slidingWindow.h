@@ -0,0 +1,35 @@
+#ifndef __SLIDINGWINDOW_H
+#define __SLIDINGWINDOW_H
+
+#include "cirListDeque.h"
+
+/* Rolling min/max/sum/mean/variance and a caller supplied associative
+   aggregate over the most recent values of a stream, amortized O(1) per
+   value pushed or expired */
+struct slidingWindow;
+
+/* expiry modes */
+# define WINDOW_COUNT 0     /* keep the last span values */
+# define WINDOW_TIME  1     /* keep values with time > newest time - span */
+
+/* associative combine for the custom aggregate, older value on the left */
+typedef double (*windowCombine)(double older, double newer);
+
+/* combine may be null, then aggregateSlidingWindow returns identity */
+struct slidingWindow *createSlidingWindow(int mode, double span,
+                                          windowCombine combine, double identity);
+void deleteSlidingWindow(struct slidingWindow *w);
+
+/* time is ignored in WINDOW_COUNT mode and must not decrease otherwise */
+void pushSlidingWindow(struct slidingWindow *w, double time, double val);
+void expireSlidingWindow(struct slidingWindow *w, double now);
+
+int    sizeSlidingWindow(struct slidingWindow *w);
+double minSlidingWindow(struct slidingWindow *w);
+double maxSlidingWindow(struct slidingWindow *w);
+double sumSlidingWindow(struct slidingWindow *w);
+double meanSlidingWindow(struct slidingWindow *w);
+double varianceSlidingWindow(struct slidingWindow *w);
+double aggregateSlidingWindow(struct slidingWindow *w);
+
+#endif
@@ -0,0 +1,65 @@
+/* slidingWindowBench.c
+ * sliding window throughput benchmark.
+ 
+ Description:   Streams random doubles through count based windows of
+                growing size and reports values per second for the
+                slidingWindow engine and for rescanning the window on
+                every tick.
+                  gcc -O2 slidingWindowBench.c slidingWindow.c cirListDeque.c
+**** */
+
+#include "slidingWindow.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+# define STREAM 2000000
+
+/*Function to get number of milliseconds of processor time*/
+double getMilliseconds() {
+   return 1000.0 * clock() / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char* argv[]) {
+    double *vals = malloc(sizeof(double) * STREAM);
+    double sink = 0;
+
+    srand(261);
+    for (int i = 0; i < STREAM; i++)
+        vals[i] = rand() / (double)RAND_MAX;
+
+    for (int span = 16; span <= 4096; span *= 4) {
+        struct slidingWindow *w = createSlidingWindow(WINDOW_COUNT, span, 0, 0);
+
+        double t1 = getMilliseconds();
+        for (int i = 0; i < STREAM; i++) {
+            pushSlidingWindow(w, 0, vals[i]);
+            sink += minSlidingWindow(w) + maxSlidingWindow(w) + varianceSlidingWindow(w);
+        }
+        double t2 = getMilliseconds();
+        deleteSlidingWindow(w);
+
+        //rescan min, max and variance of the window on each tick
+        int ticks = STREAM / span * 16;
+        double t3 = getMilliseconds();
+        for (int i = span; i < span + ticks; i++) {
+            double mn = vals[i - span], mx = mn, sum = 0, var = 0;
+            for (int j = i - span; j < i; j++) {
+                if (vals[j] < mn) mn = vals[j];
+                if (vals[j] > mx) mx = vals[j];
+                sum += vals[j];
+            }
+            for (int j = i - span; j < i; j++)
+                var += (vals[j] - sum / span) * (vals[j] - sum / span);
+            sink += mn + mx + var / span;
+        }
+        double t4 = getMilliseconds();
+
+        printf("window %4d: engine %7.2f Mvalues/s, rescan %7.2f Mvalues/s\n", span,
+               STREAM / (t2 - t1) / 1000.0, ticks / (t4 - t3) / 1000.0);
+    }
+
+    printf("(checksum %g)\n", sink);
+    free(vals);
+    return 0;
+}
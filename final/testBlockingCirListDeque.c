@@ -0,0 +1,142 @@
+/* testBlockingCirListDeque.c
+ * blockingCirListDeque testing file.
+ 
+ Description:   Tests timeouts, draining and shutdown of the blocking deque
+                with a producer thread feeding sleeping consumers, and
+                producers waiting on a full bounded deque
+                used assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "blockingCirListDeque.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+# define ITEMS 100000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+ 	pre:	predicate is a boolean encoded int
+	post:	none
+*/
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+double getMilliseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+struct consumer {
+    struct blockingCirListDeque *b;
+    double sum;
+    int count;
+    int ordered;
+};
+
+/* Drains batches until the deque is closed and empty */
+void *consume(void *arg)
+{
+    struct consumer *c = arg;
+    TYPE batch[256];
+    int n;
+
+    c->sum = 0;
+    c->count = 0;
+    c->ordered = 1;
+    while ((n = drainBlockingCirListDeque(c->b, batch, 256, BLOCKING_FOREVER)) != BLOCKING_CLOSED) {
+        for (int i = 0; i < n; i++) {
+            if (batch[i] != c->count)
+                c->ordered = 0;
+            c->sum += batch[i];
+            c->count++;
+        }
+    }
+    return 0;
+}
+
+/* Closes the deque after a short delay */
+void *closeLater(void *arg)
+{
+    struct timespec ts = {0, 20 * 1000000L};
+
+    nanosleep(&ts, 0);
+    closeBlockingCirListDeque(arg);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Creating blocking deque...\n");
+    struct blockingCirListDeque *b = createBlockingCirListDeque();
+    TYPE v;
+
+    assertTrue(removeFrontBlockingCirListDeque(b, &v, 0) == BLOCKING_TIMEOUT,
+               "polling an empty deque returns BLOCKING_TIMEOUT");
+    double t1 = getMilliseconds();
+    int rc = removeBackBlockingCirListDeque(b, &v, 50);
+    double t2 = getMilliseconds();
+    assertTrue(rc == BLOCKING_TIMEOUT && t2 - t1 >= 45,
+               "waiting 50ms on an empty deque times out after ~50ms");
+
+    printf("\nAdding 1, 2 to the back and 0 to the front...\n");
+    addBackBlockingCirListDeque(b, 1);
+    addBackBlockingCirListDeque(b, 2);
+    addFrontBlockingCirListDeque(b, 0);
+    assertTrue(sizeBlockingCirListDeque(b) == 3, "sizeBlockingCirListDeque(b) == 3");
+    assertTrue(removeBackBlockingCirListDeque(b, &v, 0) == BLOCKING_OK && v == 2,
+               "removeBackBlockingCirListDeque(b) == 2");
+    TYPE batch[8];
+    assertTrue(drainBlockingCirListDeque(b, batch, 8, 0) == 2 && batch[0] == 0 && batch[1] == 1,
+               "drainBlockingCirListDeque(b) takes {0, 1}");
+    assertTrue(isEmptyBlockingCirListDeque(b), "isEmptyBlockingCirListDeque == true");
+
+    printf("\nOne producer feeding a sleeping consumer %d items, then closing...\n", ITEMS);
+    struct consumer c = {b, 0, 0, 0};
+    pthread_t t;
+    pthread_create(&t, 0, consume, &c);
+    for (int i = 0; i < ITEMS; i++)
+        addBackBlockingCirListDeque(b, i);
+    closeBlockingCirListDeque(b);
+    pthread_join(t, 0);
+    assertTrue(c.count == ITEMS && c.ordered, "consumer received every value in order");
+    assertTrue(c.sum == (double)ITEMS * (ITEMS - 1) / 2, "sum of received values matches");
+
+    assertTrue(!addBackBlockingCirListDeque(b, 7), "adding to a closed deque fails");
+    assertTrue(removeFrontBlockingCirListDeque(b, &v, BLOCKING_FOREVER) == BLOCKING_CLOSED,
+               "removing from a closed, empty deque returns BLOCKING_CLOSED");
+
+    deleteBlockingCirListDeque(b);
+
+    printf("\nOne producer feeding a bounded deque of 16 values %d items...\n", ITEMS);
+    b = createBoundedBlockingCirListDeque(16);
+    c.b = b;
+    pthread_create(&t, 0, consume, &c);
+    for (int i = 0; i < ITEMS; i++)
+        addBackBlockingCirListDeque(b, i);
+    closeBlockingCirListDeque(b);
+    pthread_join(t, 0);
+    assertTrue(c.count == ITEMS && c.ordered, "producer waited for room, nothing was dropped");
+    deleteBlockingCirListDeque(b);
+
+    b = createBoundedBlockingCirListDeque(1);
+    addBackBlockingCirListDeque(b, 1);
+    pthread_create(&t, 0, closeLater, b);
+    assertTrue(!addBackBlockingCirListDeque(b, 2), "closing wakes a producer waiting on a full deque");
+    pthread_join(t, 0);
+    deleteBlockingCirListDeque(b);
+
+	return 0;
+}
@@ -0,0 +1,117 @@
+/* testByteDeque.c
+ * byteDeque testing file.
+ 
+ Description:   Tests byte record framing at both ends, across arena
+                boundaries and with records larger than an arena
+                used assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "byteDeque.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+# define OPS 20000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+ 	pre:	predicate is a boolean encoded int
+	post:	none
+*/
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+/* Record number id is id % 300 bytes long, every byte equal to id */
+int recordLen(int id) { return id % 300; }
+
+void fillRecord(unsigned char *buf, int id)
+{
+    memset(buf, id & 0xff, recordLen(id));
+}
+
+int viewMatches(struct byteView v, int id)
+{
+    if (v.len != recordLen(id))
+        return 0;
+    for (int i = 0; i < v.len; i++)
+        if (v.data[i] != (id & 0xff))
+            return 0;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Creating byte deque with 256 byte arenas...\n");
+    struct byteDeque *d = createByteDeque(256);
+    assertTrue(isEmptyByteDeque(d), "isEmptyByteDeque == true");
+
+    addBackByteDeque(d, "hello", 5);
+    addFrontByteDeque(d, "", 0);
+    addBackByteDeque(d, "world!", 6);
+    struct byteView v = backByteDeque(d);
+    assertTrue(v.len == 6 && memcmp(v.data, "world!", 6) == 0, "backByteDeque(d) == \"world!\"");
+    v = frontByteDeque(d);
+    assertTrue(v.len == 0, "frontByteDeque(d) is the empty record");
+    removeFrontByteDeque(d);
+    v = frontByteDeque(d);
+    assertTrue(v.len == 5 && memcmp(v.data, "hello", 5) == 0, "frontByteDeque(d) == \"hello\"");
+    removeBackByteDeque(d);
+    removeBackByteDeque(d);
+    assertTrue(isEmptyByteDeque(d), "isEmptyByteDeque == true");
+
+    printf("\nRunning %d random adds and removes, records up to 299 bytes...\n", OPS);
+    int *ids = malloc(sizeof(int) * 2 * OPS);
+    int lo = OPS, hi = OPS, ok = 1;     //ids[lo .. hi-1] are the expected records
+    unsigned char buf[300];
+    srand(261);
+    for (int i = 0; i < OPS; i++) {
+        int op = rand() % 4;
+        if (hi == lo || op < 2) {
+            fillRecord(buf, i);
+            if (op % 2) {
+                addFrontByteDeque(d, buf, recordLen(i));
+                ids[--lo] = i;
+            }
+            else {
+                addBackByteDeque(d, buf, recordLen(i));
+                ids[hi++] = i;
+            }
+        }
+        else if (op == 2) {
+            removeFrontByteDeque(d);
+            lo++;
+        }
+        else {
+            removeBackByteDeque(d);
+            hi--;
+        }
+        if (sizeByteDeque(d) != hi - lo)
+            ok = 0;
+        else if (hi > lo && (!viewMatches(frontByteDeque(d), ids[lo])
+                             || !viewMatches(backByteDeque(d), ids[hi - 1])))
+            ok = 0;
+    }
+    assertTrue(ok, "front and back views always match the expected records");
+
+    while (!isEmptyByteDeque(d)) {
+        if (!viewMatches(frontByteDeque(d), ids[lo++]))
+            ok = 0;
+        removeFrontByteDeque(d);
+    }
+    assertTrue(ok && lo == hi, "draining from the front returns every record in order");
+
+    free(ids);
+    deleteByteDeque(d);
+
+	return 0;
+}
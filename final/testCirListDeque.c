@@ -10,6 +10,12 @@
 #include "cirListDeque.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+# ifdef TRACE_OPS
+#include "opTrace.h"
+# endif
 
 /*	Testing function, takes predicate, and message and prints the message
     and if the test passed or failed, ie if the predicate expression evaluated
@@ -29,6 +35,24 @@ void assertTrue(int predicate, char *message)
         printf("FAILED\n");
 }
 
+/*	exportWriter that appends the exported bytes to a fixed size capture
+    buffer, used to check the output of exportCirListDeque()
+	param: 	ctx pointer to the capture buffer
+	param: 	buf bytes to append
+	param: 	len number of bytes
+	pre:	the capture buffer has room for len more bytes
+	post:	buf is appended to the capture buffer
+*/
+struct capture { char data[256]; int len; };
+int captureWriter(void *ctx, const char *buf, int len)
+{
+    struct capture *c = ctx;
+    memcpy(c->data + c->len, buf, len);
+    c->len += len;
+    c->data[c->len] = '\0';
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     
     printf("Creating circular list deque...\n");
@@ -131,8 +155,249 @@ int main(int argc, char* argv[]) {
     printCirListDeque(q);
 
     deleteCirListDeque(q);
-    
-	return 0;
-}
 
 
+    printf("\nNow testing exportCirListDeque()\n");
+    printf("Creating deque -1.5, 0, 3.25, 0.000001, 1e300 using addBackCirListDeque()...\n");
+    q = createCirListDeque();
+    struct capture c;
+
+    c.len = 0;
+    assertTrue(exportCirListDeque(q, EXPORT_TEXT, captureWriter, &c) == 0 && c.len == 0,
+               "exportCirListDeque(empty, EXPORT_TEXT) writes nothing");
+    addBackCirListDeque(q, -1.5);
+    addBackCirListDeque(q, 0);
+    addBackCirListDeque(q, 3.25);
+    addBackCirListDeque(q, 0.000001);
+    addBackCirListDeque(q, 1e300);
+
+    c.len = 0;
+    exportCirListDeque(q, EXPORT_TEXT, captureWriter, &c);
+    assertTrue(strcmp(c.data, "-1.5\n0\n3.25\n0.000001\n1.0000000000000001e+300\n") == 0,
+               "exportCirListDeque(q, EXPORT_TEXT) == \"-1.5\\n0\\n3.25\\n0.000001\\n1e300\\n\"");
+    c.len = 0;
+    exportCirListDeque(q, EXPORT_CSV, captureWriter, &c);
+    assertTrue(strncmp(c.data, "index,value\n0,-1.5\n1,0\n2,3.25\n", 30) == 0,
+               "exportCirListDeque(q, EXPORT_CSV) has one row per value");
+    c.len = 0;
+    exportCirListDeque(q, EXPORT_BINARY, captureWriter, &c);
+    assertTrue(c.len == 5 * sizeof(TYPE) && ((TYPE *)c.data)[2] == 3.25,
+               "exportCirListDeque(q, EXPORT_BINARY) == raw values");
+
+    deleteCirListDeque(q);
+
+
+    printf("\nNow testing compactCirListDeque() and compactStepCirListDeque()\n");
+    printf("Adding 0 - 1999 to alternating ends...\n");
+    q = createCirListDeque();
+    double ref[2000];
+    int lo = 1000, hi = 1000;     //ref[lo .. hi-1] mirrors q
+    for (int i = 0; i < 2000; i++) {
+        if (i % 2) {
+            addFrontCirListDeque(q, i);
+            ref[--lo] = i;
+        }
+        else {
+            addBackCirListDeque(q, i);
+            ref[hi++] = i;
+        }
+    }
+    compactCirListDeque(q);
+    int ok = sizeCirListDeque(q) == 2000 && frontCirListDeque(q) == 1999 && backCirListDeque(q) == 1998;
+    assertTrue(ok, "compactCirListDeque keeps the ends and size");
+
+    printf("Stepping 10 links at a time while removing from both ends...\n");
+    int steps = 0;
+    while (compactStepCirListDeque(q, 10)) {
+        removeFrontCirListDeque(q);
+        removeBackCirListDeque(q);
+        lo++;
+        hi--;
+        if (++steps == 20) {
+            reverseCirListDeque(q);     //abandons the pass, the next step starts over
+            for (int i = lo, j = hi - 1; i < j; i++, j--) {
+                double t = ref[i];
+                ref[i] = ref[j];
+                ref[j] = t;
+            }
+        }
+    }
+    assertTrue(steps > 20, "reverseCirListDeque restarts the pass");
+
+    ok = sizeCirListDeque(q) == hi - lo;
+    while (ok && !isEmptyCirListDeque(q)) {
+        ok = frontCirListDeque(q) == ref[lo++];
+        removeFrontCirListDeque(q);
+    }
+    assertTrue(ok, "compactStepCirListDeque keeps the order");
+    addBackCirListDeque(q, 1);
+    assertTrue(compactStepCirListDeque(q, 1) == 0 && frontCirListDeque(q) == 1,
+               "an emptied deque can be refilled and compacted");
+
+    deleteCirListDeque(q);
+
+
+    printf("\nNow testing createBoundedCirListDeque() and copyLastCirListDeque()\n");
+    printf("Adding 0 - 99 to the back of an overwriting deque of 8...\n");
+    q = createBoundedCirListDeque(8, BOUNDED_OVERWRITE);
+    for (int i = 0; i < 100; i++)
+        addBackCirListDeque(q, i);
+    ok = sizeCirListDeque(q) == 8 && isFullCirListDeque(q)
+         && frontCirListDeque(q) == 92 && backCirListDeque(q) == 99;
+    assertTrue(ok, "the deque keeps the newest 8 values, 92 .. 99");
+    addFrontCirListDeque(q, -1);
+    assertTrue(frontCirListDeque(q) == -1 && backCirListDeque(q) == 98,
+               "addFront to a full deque drops the back");
+
+    double last[8];
+    ok = copyLastCirListDeque(q, last, 3) == 3 && last[0] == 96 && last[1] == 97 && last[2] == 98;
+    assertTrue(ok, "copyLastCirListDeque(q, 3) == {96, 97, 98}");
+    ok = copyLastCirListDeque(q, last, 100) == 8 && last[0] == -1 && last[7] == 98;
+    assertTrue(ok, "copyLastCirListDeque copies at most the size");
+
+    reverseCirListDeque(q);
+    compactCirListDeque(q);
+    while (!isEmptyCirListDeque(q))
+        removeBackCirListDeque(q);
+    assertTrue(!isFullCirListDeque(q) && tryAddBackCirListDeque(q, 5) && frontCirListDeque(q) == 5,
+               "the pool links are reused after emptying");
+    deleteCirListDeque(q);
+
+    q = createBoundedCirListDeque(2, BOUNDED_REJECT);
+    ok = tryAddBackCirListDeque(q, 1) && tryAddFrontCirListDeque(q, 0)
+         && !tryAddBackCirListDeque(q, 2) && !tryAddFrontCirListDeque(q, -1);
+    assertTrue(ok && frontCirListDeque(q) == 0 && backCirListDeque(q) == 1,
+               "a full rejecting deque refuses adds and keeps its contents");
+    deleteCirListDeque(q);
+
+    q = createCirListDeque();
+    ok = !isFullCirListDeque(q);
+    for (int i = 0; i < 1000; i++)
+        ok = ok && tryAddBackCirListDeque(q, i);
+    assertTrue(ok && !isFullCirListDeque(q), "an unbounded deque is never full");
+    deleteCirListDeque(q);
+
+
+    printf("\nNow testing mergeCirListDeques() and the streaming cirListDequeMerge\n");
+    printf("Filling 32 sorted deques, deque j holding j + 32i / 10 for i = 0 - 99...\n");
+    struct cirListDeque *runs[32];
+    double merged[3200];
+    for (int j = 0; j < 32; j++) {
+        runs[j] = createCirListDeque();
+        for (int i = 0; i < 100; i++) {
+            addBackCirListDeque(runs[j], (j + 32 * i) / 10.0);
+            merged[j + 32 * i] = (j + 32 * i) / 10.0;
+        }
+    }
+    compactCirListDeque(runs[7]);       //its slab has to follow the links
+
+    struct cirListDequeMerge *m = createCirListDequeMerge(runs, 32);
+    double v;
+    int read = 0;
+    ok = 1;
+    while (nextCirListDequeMerge(m, &v))
+        ok = ok && read < 3200 && v == merged[read++];
+    deleteCirListDequeMerge(m);
+    assertTrue(ok && read == 3200, "the streaming merge reads every value in order");
+    assertTrue(sizeCirListDeque(runs[0]) == 100, "the streaming merge leaves the deques alone");
+
+    q = createCirListDeque();
+    mergeCirListDeques(q, runs, 32);
+    ok = sizeCirListDeque(q) == 3200;
+    for (int i = 0; i < 3200 && ok; i++) {
+        ok = frontCirListDeque(q) == merged[i];
+        removeFrontCirListDeque(q);
+    }
+    assertTrue(ok, "mergeCirListDeques relinks every value in order");
+    ok = 1;
+    for (int j = 0; j < 32; j++) {
+        ok = ok && isEmptyCirListDeque(runs[j]);
+        addBackCirListDeque(runs[j], j);
+        deleteCirListDeque(runs[j]);
+    }
+    assertTrue(ok, "the merged deques are empty and stay usable");
+    deleteCirListDeque(q);
+
+    m = createCirListDequeMerge(0, 0);
+    assertTrue(!nextCirListDequeMerge(m, &v), "merging no deques reads nothing");
+    deleteCirListDequeMerge(m);
+
+
+    printf("\nNow testing footprintCirListDeque() and shrinkCirListDeque()\n");
+    printf("Adding 0 - 99999 to the back, compacting and removing the front 90000...\n");
+    struct memoryFootprint fp, after;
+    q = createCirListDeque();
+    for (int i = 0; i < 100000; i++)
+        addBackCirListDeque(q, i);
+    footprintCirListDeque(q, &fp);
+    assertTrue(fp.payload == 100000 * sizeof(double) && fp.overhead >= 100000 * 2 * sizeof(void *)
+               && fp.reserved == 0, "footprint counts values, link pointers and nothing reserved");
+    compactCirListDeque(q);
+    for (int i = 0; i < 90000; i++)
+        removeFrontCirListDeque(q);
+    footprintCirListDeque(q, &fp);
+    assertTrue(fp.payload == 10000 * sizeof(double) && fp.reserved >= 90000 * (sizeof(double) + 2 * sizeof(void *)),
+               "the emptied part of the slab shows as reserved");
+    size_t released = shrinkCirListDeque(q);
+    footprintCirListDeque(q, &after);
+    assertTrue(after.reserved < fp.reserved && released >= fp.reserved - after.reserved,
+               "shrinkCirListDeque returns the dead slab pages");
+    assertTrue(frontCirListDeque(q) == 90000 && backCirListDeque(q) == 99999 && sizeCirListDeque(q) == 10000,
+               "shrinking keeps the values");
+    deleteCirListDeque(q);
+
+    q = createBoundedCirListDeque(1000, BOUNDED_REJECT);
+    for (int i = 0; i < 10; i++)
+        addBackCirListDeque(q, i);
+    footprintCirListDeque(q, &fp);
+    assertTrue(fp.payload == 10 * sizeof(double) && fp.reserved >= 990 * (sizeof(double) + 2 * sizeof(void *)),
+               "a bounded deque's free links show as reserved");
+    deleteCirListDeque(q);
+
+
+# ifdef TRACE_OPS
+    printf("\nNow testing traceCirListDeque()\n");
+    char tracePath[] = "/tmp/traceXXXXXX";
+    close(mkstemp(tracePath));
+    struct opTrace *t = openOpTrace(tracePath);
+    q = createCirListDeque();
+    traceCirListDeque(q, t);
+    addBackCirListDeque(q, 1.5);
+    addFrontCirListDeque(q, -2.25);
+    backCirListDeque(q);
+    removeFrontCirListDeque(q);
+    traceCirListDeque(q, 0);
+    removeBackCirListDeque(q);      //not recorded
+    assertTrue(closeOpTrace(t) == 0, "closeOpTrace(t) == 0");
+
+    struct traceOp *ops;
+    ok = loadOpTrace(tracePath, &ops) == 4
+         && ops[0].op == TRACE_ADD_BACK && ops[0].value == 1.5
+         && ops[1].op == TRACE_ADD_FRONT && ops[1].value == -2.25
+         && ops[2].op == TRACE_BACK && ops[3].op == TRACE_REMOVE_FRONT;
+    assertTrue(ok, "the trace holds each call once, in order, with its value");
+    free(ops);
+    deleteCirListDeque(q);
+
+    printf("Tracing adds to a full bounded deque of capacity 2...\n");
+    t = openOpTrace(tracePath);
+    q = createBoundedCirListDeque(2, BOUNDED_OVERWRITE);
+    traceCirListDeque(q, t);
+    addBackCirListDeque(q, 1);
+    addBackCirListDeque(q, 2);
+    addBackCirListDeque(q, 3);      //evicts 1
+    tryAddFrontCirListDeque(q, 0);  //evicts 3
+    traceCirListDeque(q, 0);
+    assertTrue(closeOpTrace(t) == 0, "closeOpTrace(t) == 0");
+
+    ok = loadOpTrace(tracePath, &ops) == 6
+         && ops[2].op == TRACE_REMOVE_FRONT && ops[3].op == TRACE_ADD_BACK && ops[3].value == 3
+         && ops[4].op == TRACE_REMOVE_BACK && ops[5].op == TRACE_ADD_FRONT && ops[5].value == 0;
+    assertTrue(ok, "evictions are traced as removes ahead of the add that caused them");
+    free(ops);
+    unlink(tracePath);
+    deleteCirListDeque(q);
+# endif
+
+	return 0;
+}
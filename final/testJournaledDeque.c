@@ -0,0 +1,241 @@
+/* testJournaledDeque.c
+ * journaledDeque testing file.
+
+ Description:   Tests replay, compaction, torn tails and stale logs of the
+                journaled deque, and compares the throughput of syncing
+                every operation against group commit
+                used assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "journaledDeque.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+# define OPS      2000
+# define THREADS  8
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+ 	pre:	predicate is a boolean encoded int
+	post:	none
+*/
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+double getMilliseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+long fileSize(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+/* Copy src over dst */
+void copyFile(const char *src, const char *dst)
+{
+    char buf[4096];
+    size_t n;
+    FILE *in = fopen(src, "rb"), *out = fopen(dst, "wb");
+
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+        fwrite(buf, 1, n, out);
+    fclose(in);
+    fclose(out);
+}
+
+/* Pops everything and checks it reads first, first + 1, ... first + n - 1 */
+int drainsInOrder(struct journaledDeque *j, int first, int n)
+{
+    int ok = sizeJournaledDeque(j) == n;
+
+    for (int i = 0; i < n && ok; i++) {
+        ok = frontJournaledDeque(j) == first + i;
+        removeFrontJournaledDeque(j);
+    }
+    return ok && isEmptyJournaledDeque(j);
+}
+
+struct adder {
+    struct journaledDeque *j;
+    int count;
+};
+
+void *addMany(void *arg)
+{
+    struct adder *a = arg;
+
+    for (int i = 0; i < a->count; i++)
+        addBackJournaledDeque(a->j, 1);
+    return 0;
+}
+
+/* Ops per second of THREADS threads adding to a fresh log */
+double throughput(const char *path, int mode)
+{
+    struct journalOptions opt = {mode, 0, 64 * 1024, 0};
+    pthread_t tids[THREADS];
+    struct adder a;
+    char snap[256];
+
+    snprintf(snap, sizeof(snap), "%s.snap", path);
+    unlink(path);
+    unlink(snap);
+
+    a.j = openJournaledDeque(path, &opt);
+    a.count = OPS / THREADS;
+
+    double t1 = getMilliseconds();
+    for (int i = 0; i < THREADS; i++)
+        pthread_create(&tids[i], 0, addMany, &a);
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(tids[i], 0);
+    double t2 = getMilliseconds();
+
+    closeJournaledDeque(a.j);
+    return a.count * THREADS / ((t2 - t1) / 1000.0);
+}
+
+int main(int argc, char* argv[]) {
+    char dir[] = "/tmp/journalXXXXXX";
+    char path[256], snap[256], saved[256];
+    struct journalOptions opt = {JOURNAL_SYNC_ALWAYS, 0, 64 * 1024, 0};
+
+    if (mkdtemp(dir) == 0) {
+        printf("cannot create a scratch directory\n");
+        return 1;
+    }
+    snprintf(path, sizeof(path), "%s/deque.log", dir);
+    snprintf(snap, sizeof(snap), "%s/deque.log.snap", dir);
+    snprintf(saved, sizeof(saved), "%s/saved.log", dir);
+
+    printf("Opening a new journal, syncing every operation...\n");
+    struct journaledDeque *j = openJournaledDeque(path, &opt);
+    assertTrue(j != 0 && isEmptyJournaledDeque(j), "new journal is empty");
+
+    for (int i = 0; i < 100; i++)
+        addBackJournaledDeque(j, i);
+    addFrontJournaledDeque(j, -1);
+    removeFrontJournaledDeque(j);
+    removeBackJournaledDeque(j);
+    assertTrue(closeJournaledDeque(j) == 0, "closeJournaledDeque == 0");
+
+    j = openJournaledDeque(path, &opt);
+    assertTrue(drainsInOrder(j, 0, 99), "replay restores 0 .. 98");
+    closeJournaledDeque(j);
+
+    printf("\nGroup commit with a delay, then sync...\n");
+    opt.syncMode = JOURNAL_SYNC_ASYNC;
+    opt.groupDelayMs = 50;
+    j = openJournaledDeque(path, &opt);
+    assertTrue(isEmptyJournaledDeque(j), "drained journal replays empty");
+    for (int i = 0; i < 1000; i++)
+        addBackJournaledDeque(j, i);
+    assertTrue(syncJournaledDeque(j) == 0, "syncJournaledDeque == 0");
+    assertTrue(fileSize(path) >= 1000 * (1 + (long)sizeof(TYPE)), "synced records are in the log");
+    closeJournaledDeque(j);
+    copyFile(path, saved);
+
+    printf("\nCompacting...\n");
+    opt.syncMode = JOURNAL_SYNC_GROUP;
+    opt.groupDelayMs = 0;
+    j = openJournaledDeque(path, &opt);
+    assertTrue(sizeJournaledDeque(j) == 1000, "replay restores 1000 values");
+    assertTrue(compactJournaledDeque(j) == 0, "compactJournaledDeque == 0");
+    assertTrue(fileSize(path) < 64, "log is truncated");
+    assertTrue(fileSize(snap) >= 1000 * (long)sizeof(TYPE), "snapshot holds the values");
+    addBackJournaledDeque(j, 1000);
+    removeFrontJournaledDeque(j);
+    closeJournaledDeque(j);
+
+    j = openJournaledDeque(path, &opt);
+    assertTrue(drainsInOrder(j, 1, 1000), "snapshot plus log restores 1 .. 1000");
+    closeJournaledDeque(j);
+
+    printf("\nAutomatic compaction...\n");
+    opt.compactBytes = 4096;
+    j = openJournaledDeque(path, &opt);
+    for (int i = 0; i < 5000; i++) {
+        addBackJournaledDeque(j, i);
+        if (i % 2)
+            removeFrontJournaledDeque(j);
+    }
+    closeJournaledDeque(j);
+    assertTrue(fileSize(path) <= 4096 + 64, "log stays near compactBytes");
+
+    j = openJournaledDeque(path, &opt);
+    assertTrue(drainsInOrder(j, 2500, 2500), "restores 2500 .. 4999");
+    for (int i = 0; i < 10; i++)
+        addBackJournaledDeque(j, i);
+    closeJournaledDeque(j);
+
+    printf("\nTorn record at the end of the log...\n");
+    FILE *fp = fopen(path, "ab");
+    fputc(2, fp);                   //an add with only half its value
+    fwrite("abc", 1, 3, fp);
+    fclose(fp);
+    j = openJournaledDeque(path, &opt);
+    assertTrue(sizeJournaledDeque(j) == 10, "torn record is dropped");
+    addBackJournaledDeque(j, 10);
+    closeJournaledDeque(j);
+    j = openJournaledDeque(path, &opt);
+    assertTrue(drainsInOrder(j, 0, 11), "records after the cut replay");
+    closeJournaledDeque(j);
+
+    printf("\nCrash between writing the snapshot and the new log...\n");
+    opt.compactBytes = 0;
+    j = openJournaledDeque(path, &opt);
+    for (int i = 0; i < 50; i++)
+        addBackJournaledDeque(j, i);
+    closeJournaledDeque(j);
+    copyFile(path, saved);
+    j = openJournaledDeque(path, &opt);
+    compactJournaledDeque(j);
+    closeJournaledDeque(j);
+    copyFile(saved, path);          //the log the snapshot already covers
+    j = openJournaledDeque(path, &opt);
+    assertTrue(drainsInOrder(j, 0, 50), "stale log is not replayed twice");
+    closeJournaledDeque(j);
+
+    printf("\nDamaging the snapshot...\n");
+    unsigned long long huge = ~0ull;
+    FILE *f = fopen(snap, "r+b");
+    fseek(f, 12, SEEK_SET);         //the value count follows the header
+    fwrite(&huge, sizeof(huge), 1, f);
+    fclose(f);
+    assertTrue(openJournaledDeque(path, &opt) == 0, "a snapshot with a wrong count is refused");
+    assertTrue(truncate(snap, fileSize(snap) - 3) == 0 && openJournaledDeque(path, &opt) == 0,
+               "a truncated snapshot is refused");
+
+    printf("\n%d threads adding %d values...\n", THREADS, OPS);
+    double always = throughput(path, JOURNAL_SYNC_ALWAYS);
+    double group = throughput(path, JOURNAL_SYNC_GROUP);
+    printf("sync every op: %.0f ops/s, group commit: %.0f ops/s\n", always, group);
+    j = openJournaledDeque(path, &opt);
+    assertTrue(sizeJournaledDeque(j) == OPS, "every group committed add replays");
+    closeJournaledDeque(j);
+
+    unlink(path);
+    unlink(snap);
+    unlink(saved);
+    rmdir(dir);
+    return 0;
+}
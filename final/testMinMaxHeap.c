@@ -0,0 +1,94 @@
+/* testMinMaxHeap.c
+ * minMaxHeap testing file.
+ 
+ Description:   Tests the min-max heap against a sorted copy of its input
+                used assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "minMaxHeap.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+# define COUNT 5000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+ 	pre:	predicate is a boolean encoded int
+	post:	none
+*/
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+int compareValues(const void *a, const void *b)
+{
+    TYPE x = *(const TYPE *)a, y = *(const TYPE *)b;
+    return LT(x, y) ? -1 : (LT(y, x) ? 1 : 0);
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Creating min-max heap with capacity 1...\n");
+    struct minMaxHeap *h = createMinMaxHeap(1);
+    assertTrue(isEmptyMinMaxHeap(h), "isEmptyMinMaxHeap == true");
+
+    printf("\nAdding 5, 1, 9...\n");
+    addMinMaxHeap(h, 5);
+    assertTrue(frontMinMaxHeap(h) == 5 && backMinMaxHeap(h) == 5,
+               "one element is both front and back");
+    addMinMaxHeap(h, 1);
+    addMinMaxHeap(h, 9);
+    assertTrue(frontMinMaxHeap(h) == 1, "frontMinMaxHeap(h) == 1");
+    assertTrue(backMinMaxHeap(h) == 9, "backMinMaxHeap(h) == 9");
+    removeBackMinMaxHeap(h);
+    assertTrue(backMinMaxHeap(h) == 5, "after removeBackMinMaxHeap, backMinMaxHeap(h) == 5");
+    removeFrontMinMaxHeap(h);
+    removeFrontMinMaxHeap(h);
+    assertTrue(isEmptyMinMaxHeap(h), "isEmptyMinMaxHeap == true");
+
+    printf("\nAdding %d random values with duplicates, then removing\n", COUNT);
+    printf("alternately from the front and the back...\n");
+    TYPE sorted[COUNT];
+    srand(261);
+    for (int i = 0; i < COUNT; i++) {
+        sorted[i] = rand() % 1000;
+        addMinMaxHeap(h, sorted[i]);
+    }
+    qsort(sorted, COUNT, sizeof(TYPE), compareValues);
+    assertTrue(sizeMinMaxHeap(h) == COUNT, "sizeMinMaxHeap(h) == COUNT");
+
+    int ok = 1, lo = 0, hi = COUNT - 1;
+    while (!isEmptyMinMaxHeap(h)) {
+        if (frontMinMaxHeap(h) != sorted[lo] || backMinMaxHeap(h) != sorted[hi])
+            ok = 0;
+        if ((lo + hi) % 2) {
+            removeFrontMinMaxHeap(h);
+            lo++;
+        }
+        else {
+            removeBackMinMaxHeap(h);
+            hi--;
+        }
+        //re-add copies of the current front and back, then remove them again
+        if (lo < hi && lo % 7 == 0) {
+            addMinMaxHeap(h, sorted[lo]);
+            addMinMaxHeap(h, sorted[hi]);
+            removeFrontMinMaxHeap(h);
+            removeBackMinMaxHeap(h);
+        }
+    }
+    assertTrue(ok, "front and back always match the sorted values");
+
+    deleteMinMaxHeap(h);
+
+	return 0;
+}
@@ -0,0 +1,142 @@
+/* testPersistentDeque.c
+ * persistentDeque testing file.
+ 
+ Description:   Tests that updates produce correct new versions while older
+                versions and snapshots keep their contents, then reads
+                snapshots on a second thread while the writer keeps going
+                used assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "persistentDeque.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+# define OPS 20000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+ 	pre:	predicate is a boolean encoded int
+	post:	none
+*/
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+struct pDequeRoot *root;
+int writerDone;
+
+/* Every snapshot published by the writer holds 0, 1, 2, ... in order */
+void *reader(void *arg)
+{
+    int *consistent = arg;
+    TYPE *vals = malloc(sizeof(TYPE) * OPS);
+
+    *consistent = 1;
+    while (!__atomic_load_n(&writerDone, __ATOMIC_ACQUIRE)) {
+        struct persistentDeque *snap = snapshotPDequeRoot(root);
+        int n = sizePDeque(snap);
+        toArrayPDeque(snap, vals);
+        for (int i = 1; i < n; i++)
+            if (vals[i] != vals[i - 1] + 1)
+                *consistent = 0;
+        releasePDeque(snap);
+    }
+    free(vals);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Creating persistent deque...\n");
+    struct persistentDeque *empty = createPDeque();
+    assertTrue(isEmptyPDeque(empty), "isEmptyPDeque == true");
+
+    struct persistentDeque *one = addBackPDeque(empty, 1);
+    struct persistentDeque *two = addFrontPDeque(one, 0);
+    struct persistentDeque *three = addBackPDeque(two, 2);
+    assertTrue(frontPDeque(three) == 0 && backPDeque(three) == 2 && sizePDeque(three) == 3,
+               "{0, 1, 2} has front 0, back 2, size 3");
+    assertTrue(sizePDeque(two) == 2 && backPDeque(two) == 1 && isEmptyPDeque(empty),
+               "older versions are unchanged");
+
+    struct persistentDeque *snap = retainPDeque(three);
+    struct persistentDeque *popped = removeFrontPDeque(three);
+    releasePDeque(three);
+    assertTrue(frontPDeque(popped) == 1 && frontPDeque(snap) == 0,
+               "snapshot keeps the front value after removeFrontPDeque");
+    releasePDeque(snap);
+    releasePDeque(popped);
+    releasePDeque(two);
+    releasePDeque(one);
+
+    printf("\nRunning %d random adds and removes against an array...\n", OPS);
+    TYPE ref[2 * OPS + 1], vals[2 * OPS + 1];
+    int lo = OPS, hi = OPS, ok = 1;     //ref[lo .. hi-1] is the expected content
+    struct persistentDeque *d = empty, *n;
+    srand(261);
+    for (int i = 0; i < OPS; i++) {
+        int op = rand() % 4;
+        if (hi - lo == 0 || op < 2) {
+            if (op % 2) {
+                n = addFrontPDeque(d, i);
+                ref[--lo] = i;
+            }
+            else {
+                n = addBackPDeque(d, i);
+                ref[hi++] = i;
+            }
+        }
+        else if (op == 2) {
+            n = removeFrontPDeque(d);
+            lo++;
+        }
+        else {
+            n = removeBackPDeque(d);
+            hi--;
+        }
+        releasePDeque(d);
+        d = n;
+
+        if (sizePDeque(d) != hi - lo)
+            ok = 0;
+        else if (hi > lo && (frontPDeque(d) != ref[lo] || backPDeque(d) != ref[hi - 1]))
+            ok = 0;
+    }
+    toArrayPDeque(d, vals);
+    for (int i = 0; i < hi - lo; i++)
+        if (vals[i] != ref[lo + i])
+            ok = 0;
+    assertTrue(ok, "every version matches the array");
+    releasePDeque(d);
+
+    printf("\nWriter publishing versions while a reader takes snapshots...\n");
+    root = createPDequeRoot();
+    int consistent;
+    pthread_t t;
+    pthread_create(&t, 0, reader, &consistent);
+    d = snapshotPDequeRoot(root);
+    int next = 0;
+    for (int i = 0; i < OPS; i++) {
+        n = (i % 3 == 2) ? removeFrontPDeque(d) : addBackPDeque(d, next++);
+        releasePDeque(d);
+        d = n;
+        publishPDequeRoot(root, retainPDeque(d));
+    }
+    __atomic_store_n(&writerDone, 1, __ATOMIC_RELEASE);
+    pthread_join(t, 0);
+    assertTrue(consistent, "every snapshot the reader saw was consistent");
+    releasePDeque(d);
+    deletePDequeRoot(root);
+
+	return 0;
+}
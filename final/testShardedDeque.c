@@ -0,0 +1,117 @@
+/* testShardedDeque.c
+ * shardedDeque testing file.
+
+ Description:   Tests the deque API on one and on many shards, and that
+                concurrent producers and consumers deliver every value
+                exactly once
+                used assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "shardedDeque.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+# define THREADS 8
+# define VALUES  20000     /* per producer */
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+ 	pre:	predicate is a boolean encoded int
+	post:	none
+*/
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+struct shardedDeque *shared;
+int seen[THREADS * VALUES];
+int done;
+
+/* Adds VALUES values starting at the thread's offset */
+void *produce(void *arg)
+{
+    int first = *(int *)arg;
+
+    for (int i = first; i < first + VALUES; i++)
+        addBackShardedDeque(shared, i);
+    return 0;
+}
+
+/* Removes values until the producers are done and the deque is empty */
+void *consume(void *arg)
+{
+    TYPE v;
+    (void)arg;
+
+    while (1) {
+        if (removeFrontShardedDeque(shared, &v))
+            __atomic_fetch_add(&seen[(int)v], 1, __ATOMIC_RELAXED);
+        else if (__atomic_load_n(&done, __ATOMIC_ACQUIRE))
+            return 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TYPE v;
+
+    printf("One shard...\n");
+    struct shardedDeque *s = createShardedDeque(1);
+    assertTrue(isEmptyShardedDeque(s) && !removeFrontShardedDeque(s, &v), "new deque is empty");
+    for (int i = 0; i < 10; i++)
+        addBackShardedDeque(s, i);
+    addFrontShardedDeque(s, -1);
+    int fifo = removeFrontShardedDeque(s, &v) && v == -1;
+    for (int i = 0; i < 9; i++)
+        fifo = fifo && removeFrontShardedDeque(s, &v) && v == i;
+    assertTrue(fifo, "a single shard is an exact deque from the front");
+    assertTrue(removeBackShardedDeque(s, &v) && v == 9 && isEmptyShardedDeque(s), "and from the back");
+    deleteShardedDeque(s);
+
+    printf("\n16 shards...\n");
+    s = createShardedDeque(16);
+    assertTrue(shardsShardedDeque(s) == 16, "shardsShardedDeque == 16");
+    for (int i = 0; i < 1000; i++)
+        addBackShardedDeque(s, i);
+    assertTrue(sizeShardedDeque(s) == 1000, "sizeShardedDeque == 1000");
+    int sum = 0, count = 0;
+    while (removeFrontShardedDeque(s, &v)) {
+        sum += (int)v;
+        count++;
+    }
+    assertTrue(count == 1000 && sum == 999 * 1000 / 2 && isEmptyShardedDeque(s),
+               "every value comes out once, then removes fail");
+    deleteShardedDeque(s);
+
+    printf("\n%d producers and %d consumers on %d shards...\n", THREADS, THREADS, THREADS);
+    shared = createShardedDeque(THREADS);
+    pthread_t producers[THREADS], consumers[THREADS];
+    int firsts[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        firsts[i] = i * VALUES;
+        pthread_create(&consumers[i], 0, consume, 0);
+        pthread_create(&producers[i], 0, produce, &firsts[i]);
+    }
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(producers[i], 0);
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(consumers[i], 0);
+
+    int once = 1;
+    for (int i = 0; i < THREADS * VALUES; i++)
+        once = once && seen[i] == 1;
+    assertTrue(once && isEmptyShardedDeque(shared), "each value is delivered exactly once");
+    deleteShardedDeque(shared);
+
+	return 0;
+}
@@ -0,0 +1,105 @@
+/* testSlidingWindow.c
+ * slidingWindow testing file.
+ 
+ Description:   Tests count and time based windows against a brute force
+                rescan of the stream
+                used assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "slidingWindow.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+# define STREAM 20000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+ 	pre:	predicate is a boolean encoded int
+	post:	none
+*/
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+/* custom aggregate under test, a running maximum */
+double keepLargest(double older, double newer) { return (newer > older) ? newer : older; }
+
+int close(double a, double b) { return fabs(a - b) <= 1e-6 * (1 + fabs(a) + fabs(b)); }
+
+/* Brute force checks over vals[from .. to-1] */
+int matches(struct slidingWindow *w, double *vals, int from, int to)
+{
+    double mn = vals[from], mx = vals[from], sum = 0, mean, var = 0;
+
+    for (int i = from; i < to; i++) {
+        if (vals[i] < mn) mn = vals[i];
+        if (vals[i] > mx) mx = vals[i];
+        sum += vals[i];
+    }
+    mean = sum / (to - from);
+    for (int i = from; i < to; i++)
+        var += (vals[i] - mean) * (vals[i] - mean);
+    var /= (to - from);
+
+    return sizeSlidingWindow(w) == to - from
+        && minSlidingWindow(w) == mn && maxSlidingWindow(w) == mx
+        && aggregateSlidingWindow(w) == mx
+        && close(sumSlidingWindow(w), sum) && close(meanSlidingWindow(w), mean)
+        && close(varianceSlidingWindow(w), var);
+}
+
+int main(int argc, char* argv[]) {
+
+    double *vals = malloc(sizeof(double) * STREAM);
+    double *times = malloc(sizeof(double) * STREAM);
+    srand(261);
+    for (int i = 0; i < STREAM; i++) {
+        vals[i] = rand() % 1000 - 500 + (rand() % 100) / 100.0;
+        times[i] = (i == 0) ? 0 : times[i - 1] + rand() % 5;   //repeated timestamps too
+    }
+
+    printf("Count window of 100 values over a stream of %d values...\n", STREAM);
+    struct slidingWindow *w = createSlidingWindow(WINDOW_COUNT, 100, keepLargest, -1e300);
+    assertTrue(sizeSlidingWindow(w) == 0 && sumSlidingWindow(w) == 0
+               && aggregateSlidingWindow(w) == -1e300, "empty window");
+    int ok = 1;
+    for (int i = 0; i < STREAM; i++) {
+        pushSlidingWindow(w, 0, vals[i]);
+        if (i % 37 == 0 || i == STREAM - 1)
+            ok = ok && matches(w, vals, (i >= 100) ? i - 99 : 0, i + 1);
+    }
+    assertTrue(ok, "min, max, sum, mean, variance and aggregate match a rescan");
+    deleteSlidingWindow(w);
+
+    printf("\nTime window of span 50 over the same stream...\n");
+    w = createSlidingWindow(WINDOW_TIME, 50, keepLargest, -1e300);
+    ok = 1;
+    int from = 0;
+    for (int i = 0; i < STREAM; i++) {
+        pushSlidingWindow(w, times[i], vals[i]);
+        while (times[from] <= times[i] - 50)
+            from++;
+        if (i % 37 == 0 || i == STREAM - 1)
+            ok = ok && matches(w, vals, from, i + 1);
+    }
+    assertTrue(ok, "min, max, sum, mean, variance and aggregate match a rescan");
+
+    expireSlidingWindow(w, times[STREAM - 1] + 50);
+    assertTrue(sizeSlidingWindow(w) == 0, "expireSlidingWindow(w, last + span) empties the window");
+    deleteSlidingWindow(w);
+
+    free(vals);
+    free(times);
+
+	return 0;
+}
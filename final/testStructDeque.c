@@ -0,0 +1,130 @@
+/* testStructDeque.c
+ * struct payload testing file.
+
+ Description:   Builds cirListDeque.c in this translation unit with a struct
+                TYPE and a KEY hook, and tests that the deque, bounded,
+                compaction, merge and export paths carry whole records and
+                order them by key
+                Build:
+                  gcc testStructDeque.c
+                used assertTrue function from assignment 2 skeleton code
+**** */
+
+struct sample {
+    long stamp;     /* key */
+    float level;
+    char source[72];    /* makes a sample longer than an export row */
+};
+
+# define TYPE       struct sample
+# define TYPE_SIZE  sizeof(struct sample)
+# define KEY(A)     ((A).stamp)
+
+#include "cirListDeque.c"
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+ 	pre:	predicate is a boolean encoded int
+	post:	none
+*/
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+struct sample sample(long stamp, float level)
+{
+    struct sample s = {stamp, level, ""};
+    return s;
+}
+
+/* Collects what an export writes */
+struct capture {
+    char text[256 * 1024];
+    int len;
+};
+
+int capture(void *ctx, const char *buf, int len)
+{
+    struct capture *c = ctx;
+    if (c->len + len >= (int)sizeof(c->text))
+        return -1;
+    memcpy(c->text + c->len, buf, len);
+    c->len += len;
+    c->text[c->len] = 0;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Adding samples 1 - 1000 to the back and compacting...\n");
+    struct cirListDeque *q = createCirListDeque();
+    for (int i = 1; i <= 1000; i++)
+        addBackCirListDeque(q, sample(i, i / 4.0f));
+    compactCirListDeque(q);
+    assertTrue(frontCirListDeque(q).stamp == 1 && backCirListDeque(q).level == 250.0f,
+               "front and back return whole samples after compaction");
+    deleteCirListDeque(q);
+
+    printf("\nBounded deque of 8 samples, overwriting...\n");
+    struct sample last[8];
+    q = createBoundedCirListDeque(8, BOUNDED_OVERWRITE);
+    for (int i = 0; i < 20; i++)
+        addBackCirListDeque(q, sample(i, -i));
+    assertTrue(copyLastCirListDeque(q, last, 8) == 8 && last[0].stamp == 12 && last[7].level == -19.0f,
+               "copyLastCirListDeque copies the newest samples");
+    deleteCirListDeque(q);
+
+    printf("\nMerging three streams by stamp...\n");
+    struct cirListDeque *qs[3] = {createCirListDeque(), createCirListDeque(), createCirListDeque()};
+    for (int i = 0; i < 300; i++)
+        addBackCirListDeque(qs[i % 3], sample(i, i % 3));
+    struct cirListDequeMerge *m = createCirListDequeMerge(qs, 3);
+    struct sample s;
+    int ordered = 1, read = 0;
+    while (nextCirListDequeMerge(m, &s)) {
+        ordered = ordered && s.stamp == read && s.level == read % 3;
+        read++;
+    }
+    deleteCirListDequeMerge(m);
+    assertTrue(ordered && read == 300, "the merge orders by key and keeps the payloads");
+    for (int i = 0; i < 3; i++)
+        deleteCirListDeque(qs[i]);
+
+    printf("\nExporting as CSV...\n");
+    static struct capture c;
+    q = createCirListDeque();
+    addBackCirListDeque(q, sample(7, 0.5f));
+    addBackCirListDeque(q, sample(9, 0.25f));
+    assertTrue(exportCirListDeque(q, EXPORT_CSV, capture, &c) == 0 && strstr(c.text, "0,7\n1,9\n") != 0,
+               "text export writes the key");
+    deleteCirListDeque(q);
+
+    printf("\nExporting 2000 samples of %d bytes as binary...\n", (int)sizeof(struct sample));
+    q = createCirListDeque();
+    for (int i = 0; i < 2000; i++) {
+        s = sample(i, i / 8.0f);
+        snprintf(s.source, sizeof(s.source), "sensor %d", i % 7);
+        addBackCirListDeque(q, s);
+    }
+    c.len = 0;
+    int exact = exportCirListDeque(q, EXPORT_BINARY, capture, &c) == 0 && c.len == 2000 * (int)sizeof(struct sample);
+    for (int i = 0; i < 2000 && exact; i++) {
+        char source[72];
+        memcpy(&s, c.text + (size_t)i * sizeof(struct sample), sizeof(struct sample));
+        snprintf(source, sizeof(source), "sensor %d", i % 7);
+        exact = s.stamp == i && s.level == i / 8.0f && strcmp(s.source, source) == 0;
+    }
+    assertTrue(exact, "binary export writes whole samples longer than a text row");
+    deleteCirListDeque(q);
+
+	return 0;
+}
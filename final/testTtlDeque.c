@@ -0,0 +1,205 @@
+/* testTtlDeque.c
+ * ttlDeque testing file.
+
+ Description:   Tests expiry with mixed TTLs, clock jumps across every
+                wheel level, removal and renewal against a brute force
+                model, and times expiring a few values among many
+                used assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "ttlDeque.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+# define MODEL   2000
+# define ROUNDS  3000
+# define LIVE    1000000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+ 	pre:	predicate is a boolean encoded int
+	post:	none
+*/
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+double getMilliseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* brute force model: the value i is live while handle[i] is not null */
+struct model {
+    struct ttlEntry *handle[MODEL];
+    unsigned long expiry[MODEL];
+    unsigned long lastExpiry;   /* expiries must be reported in order */
+    int expired;
+    int wrong;                  /* expired early, late, twice or out of order */
+};
+
+void onExpire(void *ctx, TYPE val, unsigned long expiry)
+{
+    struct model *m = ctx;
+    int i = (int)val;
+
+    if (m->handle[i] == 0 || m->expiry[i] != expiry || expiry < m->lastExpiry)
+        m->wrong++;
+    m->handle[i] = 0;
+    m->lastExpiry = expiry;
+    m->expired++;
+}
+
+/* ttl spread over every wheel level and the overflow list */
+unsigned long randomTtl()
+{
+    switch (rand() % 4) {
+        case 0:  return 1 + rand() % 64;
+        case 1:  return 1 + rand() % 5000;
+        case 2:  return 1 + (unsigned long)rand() * 97 % 20000000;
+        default: return 1 + (unsigned long)rand() * 4099 % 3000000000UL;
+    }
+}
+
+/* Counts calls and re-adds each value once with a short ttl */
+struct rearm {
+    struct ttlDeque *d;
+    int calls;
+};
+
+void rearmOnce(void *ctx, TYPE val, unsigned long expiry)
+{
+    struct rearm *r = ctx;
+    (void)expiry;
+
+    r->calls++;
+    if (val < 100)
+        addBackTtlDeque(r->d, val + 100, 10);
+}
+
+int main(int argc, char* argv[]) {
+    double t1, t2;
+    int n;
+
+    printf("Adding values with ttl 30, 10, 20 to the back...\n");
+    struct ttlDeque *d = createTtlDeque(1000, 0, 0);
+    addBackTtlDeque(d, 1, 30);
+    addBackTtlDeque(d, 2, 10);
+    struct ttlEntry *e = addBackTtlDeque(d, 3, 20);
+    assertTrue(sizeTtlDeque(d) == 3 && frontTtlDeque(d) == 1 && backTtlDeque(d) == 3,
+               "values keep deque order, not expiry order");
+    assertTrue(expiryTtlEntry(e) == 1020 && valueTtlEntry(e) == 3, "expiryTtlEntry == now + ttl");
+    assertTrue(advanceTtlDeque(d, 1009) == 0, "nothing expires before its time");
+    assertTrue(advanceTtlDeque(d, 1010) == 1 && frontTtlDeque(d) == 1 && backTtlDeque(d) == 3,
+               "the middle value expires at 1010");
+    renewTtlDeque(d, e, 100);
+    assertTrue(advanceTtlDeque(d, 1100) == 1 && sizeTtlDeque(d) == 1 && frontTtlDeque(d) == 3,
+               "a renewed value outlives an older one");
+    assertTrue(advanceTtlDeque(d, 50) == 0 && nowTtlDeque(d) == 1100, "the clock never goes back");
+    removeFrontTtlDeque(d);
+    assertTrue(isEmptyTtlDeque(d) && advanceTtlDeque(d, 5000) == 0, "a removed value never expires");
+    deleteTtlDeque(d);
+
+    printf("\nRandom adds, removes, renewals and clock jumps against a brute force model...\n");
+    struct model *m = calloc(1, sizeof(struct model));
+    d = createTtlDeque(0, onExpire, m);
+    unsigned long now = 0;
+    int ok = 1;
+    srand(7);
+    for (int round = 0; round < ROUNDS && ok; round++) {
+        for (int k = 0; k < 5; k++) {
+            int i = rand() % MODEL;
+            if (m->handle[i] == 0) {
+                unsigned long ttl = randomTtl();
+                m->handle[i] = (rand() % 2) ? addBackTtlDeque(d, i, ttl) : addFrontTtlDeque(d, i, ttl);
+                m->expiry[i] = now + ttl;
+            }
+            else if (rand() % 3 == 0) {
+                removeTtlDeque(d, m->handle[i]);
+                m->handle[i] = 0;
+            }
+            else {
+                unsigned long ttl = randomTtl();
+                renewTtlDeque(d, m->handle[i], ttl);
+                m->expiry[i] = now + ttl;
+            }
+        }
+
+        //mostly small steps, sometimes far across the levels
+        now += (rand() % 10 == 0) ? (unsigned long)rand() * 31 % 100000000 : (unsigned long)(rand() % 200);
+        m->lastExpiry = 0;
+        advanceTtlDeque(d, now);
+
+        int live = 0;
+        for (int i = 0; i < MODEL; i++) {
+            if (m->handle[i] != 0) {
+                live++;
+                ok = ok && m->expiry[i] > now;
+            }
+        }
+        ok = ok && live == sizeTtlDeque(d) && m->wrong == 0;
+    }
+    assertTrue(ok, "each value expires exactly when the model says, in expiry order");
+    assertTrue(m->expired > ROUNDS, "the run expired values on every level");
+
+    advanceTtlDeque(d, (unsigned long)-1);
+    assertTrue(isEmptyTtlDeque(d) && m->wrong == 0, "advancing to the end of time expires everything");
+    deleteTtlDeque(d);
+    free(m);
+
+    printf("\nRe-adding from the expiry callback...\n");
+    struct rearm r = {0, 0};
+    d = createTtlDeque(0, rearmOnce, &r);
+    r.d = d;
+    for (int i = 0; i < 100; i++)
+        addBackTtlDeque(d, i, 1 + i % 7);
+    assertTrue(advanceTtlDeque(d, 7) == 100 && sizeTtlDeque(d) == 100, "each expired value was re-added");
+    assertTrue(advanceTtlDeque(d, 1000) == 100 && r.calls == 200 && isEmptyTtlDeque(d),
+               "re-added values expire on a later advance");
+    deleteTtlDeque(d);
+
+    printf("\nFar future values and large clock jumps...\n");
+    d = createTtlDeque(0, 0, 0);
+    for (int i = 0; i <= 1000; i++)
+        addBackTtlDeque(d, i, (1UL << 52) + (unsigned long)i * 12345);
+    t1 = getMilliseconds();
+    n = advanceTtlDeque(d, 1UL << 51);
+    t2 = getMilliseconds();
+    printf("jumping 2^51 ticks past 1001 far values took %.3f ms\n", t2 - t1);
+    assertTrue(n == 0 && sizeTtlDeque(d) == 1001 && t2 - t1 < 100,
+               "a jump with nothing due does not walk the spans in between");
+    assertTrue(advanceTtlDeque(d, (1UL << 52) + 1000 * 12345) == 1001 && isEmptyTtlDeque(d),
+               "far values expire when their time comes");
+
+    addBackTtlDeque(d, 1, (unsigned long)-1);     //expiry saturates at the end of time
+    addBackTtlDeque(d, 2, 1UL << 62);
+    t1 = getMilliseconds();
+    n = advanceTtlDeque(d, (unsigned long)-1);
+    t2 = getMilliseconds();
+    assertTrue(n == 2 && isEmptyTtlDeque(d) && t2 - t1 < 100, "a saturated expiry is reached in one jump");
+    deleteTtlDeque(d);
+
+    printf("\nExpiring 1000 of %d values...\n", LIVE);
+    d = createTtlDeque(0, 0, 0);
+    for (int i = 0; i < LIVE; i++)
+        addBackTtlDeque(d, i, (i % 1000 == 0) ? 1 + i % 50 : 1000000 + i);
+    t1 = getMilliseconds();
+    n = advanceTtlDeque(d, 100);
+    t2 = getMilliseconds();
+    printf("advanceTtlDeque removed %d values in %.3f ms\n", n, t2 - t1);
+    assertTrue(n == LIVE / 1000 && sizeTtlDeque(d) == LIVE - n, "only the short lived values expired");
+    deleteTtlDeque(d);
+
+	return 0;
+}
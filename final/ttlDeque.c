@@ -0,0 +1,543 @@
+/* ttlDeque.c
+ * time-to-live deque implementation file.
+
+ Description:   Every value sits on two lists: a circular doubly linked
+                list with a sentinel keeping deque order, and a slot of a
+                hierarchical timing wheel keyed by its expiry.
+
+                The wheel has WHEEL_LEVELS levels of WHEEL_SLOTS slots. A
+                value goes on the lowest level whose span still contains
+                its expiry given the current time: level 0 slots hold a
+                single tick, level 1 slots WHEEL_SLOTS ticks, and so on.
+                Expiries past the top level wait on an overflow list, which
+                keeps a lower bound of its expiries so the clock jumps
+                straight to the first top level span one of them falls in.
+
+                Advancing the clock jumps straight to the next occupied
+                slot using a bitmap per level rather than stepping tick
+                by tick. A level 0 slot expires as a whole; a higher slot
+                is cascaded, its values moving down to finer levels. Each
+                value cascades at most WHEEL_LEVELS times, so the work is
+                proportional to the values expired, not to the values
+                kept or the ticks skipped. The overflow list is scanned
+                only when one of its values comes within the wheel's span.
+ **** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdint.h>
+#include <limits.h>
+#include "ttlDeque.h"
+
+# define WHEEL_BITS   6
+# define WHEEL_SLOTS  (1 << WHEEL_BITS)     /* slots per level, one bit each in a uint64_t */
+# define WHEEL_LEVELS 5                     /* 2^30 ticks before the overflow list */
+# define WHEEL_OVERFLOW (WHEEL_LEVELS * WHEEL_SLOTS)
+
+struct ttlEntry {
+    TYPE value;
+    unsigned long expiry;
+    struct ttlEntry *next;      /* deque order */
+    struct ttlEntry *prev;
+    struct ttlEntry *slotNext;  /* other values of the same wheel slot */
+    struct ttlEntry *slotPrev;
+    int slot;                   /* index into wheel, WHEEL_OVERFLOW past the top level */
+};
+
+struct ttlDeque {
+    struct ttlEntry sentinel;   /* next is the front, prev the back */
+    int size;
+    unsigned long now;
+    ttlExpired onExpire;
+    void *ctx;
+    int firing;                 /* inside onExpire, removals are not allowed */
+
+    struct ttlEntry *wheel[WHEEL_OVERFLOW + 1];
+    uint64_t occupied[WHEEL_LEVELS];    /* bit s set when slot s of the level has values */
+    unsigned long overflowMin;          /* no overflow expiry is earlier, ULONG_MAX when empty */
+};
+
+/* Prints custom error message and exits w/ custom error code
+
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+
+    //pre-conditions
+    assert(message != 0);
+
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* Index of the lowest set bit of a non-zero word */
+static int _lowestBit(uint64_t bits)
+{
+# ifdef __GNUC__
+    return __builtin_ctzll(bits);
+# else
+    int i = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        i++;
+    }
+    return i;
+# endif
+}
+
+
+/* ************************************************************************
+	Wheel Functions
+************************************************************************ */
+
+/* Slot for an expiry: the lowest level on which it and the current time
+   share every higher bit */
+static int _slotFor(struct ttlDeque *d, unsigned long expiry)
+{
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        int above = WHEEL_BITS * (level + 1);
+        if ((expiry >> above) == (d->now >> above))
+            return level * WHEEL_SLOTS + (int)((expiry >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+    }
+    return WHEEL_OVERFLOW;
+}
+
+/* File an entry in the wheel by its expiry
+
+	param: 	d		pointer to the deque
+	param: 	e		entry on no wheel slot
+	pre:	e->expiry > d->now
+*/
+static void _fileEntry(struct ttlDeque *d, struct ttlEntry *e)
+{
+    assert(e->expiry > d->now);
+
+    int slot = _slotFor(d, e->expiry);
+
+    e->slot = slot;
+    e->slotPrev = 0;
+    e->slotNext = d->wheel[slot];
+    if (e->slotNext != 0)
+        e->slotNext->slotPrev = e;
+    d->wheel[slot] = e;
+
+    if (slot < WHEEL_OVERFLOW)
+        d->occupied[slot / WHEEL_SLOTS] |= (uint64_t)1 << (slot % WHEEL_SLOTS);
+    else if (e->expiry < d->overflowMin)
+        d->overflowMin = e->expiry;
+}
+
+/* Take an entry off its wheel slot */
+static void _unfileEntry(struct ttlDeque *d, struct ttlEntry *e)
+{
+    if (e->slotPrev != 0)
+        e->slotPrev->slotNext = e->slotNext;
+    else
+        d->wheel[e->slot] = e->slotNext;
+    if (e->slotNext != 0)
+        e->slotNext->slotPrev = e->slotPrev;
+
+    if (e->slot < WHEEL_OVERFLOW && d->wheel[e->slot] == 0)
+        d->occupied[e->slot / WHEEL_SLOTS] &= ~((uint64_t)1 << (e->slot % WHEEL_SLOTS));
+
+    //a removal leaves overflowMin a lower bound, which stays correct
+    if (e->slot == WHEEL_OVERFLOW && d->wheel[WHEEL_OVERFLOW] == 0)
+        d->overflowMin = ULONG_MAX;
+}
+
+/* Find the earliest time after d->now at which a slot needs handling
+
+	param: 	d		pointer to the deque
+	param: 	slot	receives the slot to handle at that time
+	ret: 	the time, or ULONG_MAX if the wheel is empty
+*/
+static unsigned long _nextEvent(struct ttlDeque *d, int *slot)
+{
+    //a lower level's next slot always comes before any higher level's
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        int shift = WHEEL_BITS * level;
+        int pos = (int)((d->now >> shift) & (WHEEL_SLOTS - 1));
+        uint64_t later = d->occupied[level] & ~(((uint64_t)2 << pos) - 1);
+
+        if (later != 0) {
+            int s = _lowestBit(later);
+            unsigned long base = d->now >> (shift + WHEEL_BITS) << (shift + WHEEL_BITS);
+
+            *slot = level * WHEEL_SLOTS + s;
+            return base | ((unsigned long)s << shift);
+        }
+    }
+
+    if (d->wheel[WHEEL_OVERFLOW] != 0) {
+        int top = WHEEL_BITS * WHEEL_LEVELS;
+        unsigned long start = d->overflowMin >> top << top;
+        unsigned long following = ((d->now >> top) + 1) << top;
+
+        //the span the earliest overflow expiry falls in, never before the next span
+        *slot = WHEEL_OVERFLOW;
+        return (start > following) ? start : following;
+    }
+    return ULONG_MAX;
+}
+
+
+/* ************************************************************************
+	Deque Functions
+************************************************************************ */
+
+/* Create an empty deque
+
+	param: 	now			current time in ticks
+	param: 	onExpire	called for each value advanceTtlDeque removes, or null
+	param: 	ctx			passed to onExpire
+	pre:	none
+	post:	an empty deque with its clock at now
+*/
+struct ttlDeque *createTtlDeque(unsigned long now, ttlExpired onExpire, void *ctx)
+{
+    struct ttlDeque *d = malloc(sizeof(struct ttlDeque));
+    assert(d != 0);
+
+    d->sentinel.next = &d->sentinel;
+    d->sentinel.prev = &d->sentinel;
+    d->size = 0;
+    d->now = now;
+    d->onExpire = onExpire;
+    d->ctx = ctx;
+    d->firing = 0;
+
+    for (int i = 0; i <= WHEEL_OVERFLOW; i++)
+        d->wheel[i] = 0;
+    for (int i = 0; i < WHEEL_LEVELS; i++)
+        d->occupied[i] = 0;
+    d->overflowMin = ULONG_MAX;
+    return d;
+}
+
+/* Deallocate the deque and every value left in it, without calling onExpire
+
+	param: 	d		pointer to the deque
+	pre:	d is not null
+	post:	d and its entries are freed
+*/
+void deleteTtlDeque(struct ttlDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to deleteTtlDeque", 1);
+
+    struct ttlEntry *current = d->sentinel.next;
+    while (current != &d->sentinel) {
+        struct ttlEntry *next = current->next;
+        free(current);
+        current = next;
+    }
+    free(d);
+}
+
+/* Check whether the deque is empty
+
+	param: 	d		pointer to the deque
+	pre:	d is not null
+	ret: 	1 if the deque is empty. Otherwise, 0.
+*/
+int isEmptyTtlDeque(struct ttlDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to isEmptyTtlDeque", 2);
+
+    return d->size == 0;
+}
+
+/* Number of unexpired values in the deque
+
+	param: 	d		pointer to the deque
+	pre:	d is not null
+	ret: 	the size of the deque
+*/
+int sizeTtlDeque(struct ttlDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to sizeTtlDeque", 3);
+
+    return d->size;
+}
+
+/* Current time of the deque's clock
+
+	param: 	d		pointer to the deque
+	pre:	d is not null
+	ret: 	the time last passed to advanceTtlDeque or createTtlDeque
+*/
+unsigned long nowTtlDeque(struct ttlDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to nowTtlDeque", 4);
+
+    return d->now;
+}
+
+/* Create an entry expiring ttl ticks from now and link it after pos */
+static struct ttlEntry *_addEntryAfter(struct ttlDeque *d, struct ttlEntry *pos,
+                                       TYPE val, unsigned long ttl)
+{
+    assert(ttl > 0);
+
+    struct ttlEntry *e = malloc(sizeof(struct ttlEntry));
+    assert(e != 0);
+
+    e->value = val;
+    e->expiry = (ttl > ULONG_MAX - d->now) ? ULONG_MAX : d->now + ttl;
+
+    e->prev = pos;
+    e->next = pos->next;
+    pos->next->prev = e;
+    pos->next = e;
+    d->size++;
+
+    _fileEntry(d, e);
+    return e;
+}
+
+/* Unlink an entry from the deque and the wheel and free it */
+static void _removeEntry(struct ttlDeque *d, struct ttlEntry *e)
+{
+    assert(!d->firing);
+
+    _unfileEntry(d, e);
+    e->prev->next = e->next;
+    e->next->prev = e->prev;
+    d->size--;
+    free(e);
+}
+
+/* Add a value to the back of the deque
+
+	param: 	d		pointer to the deque
+	param: 	val		value to add
+	param: 	ttl		ticks from now until the value expires
+	pre:	d is not null, ttl > 0
+	post:	val is at the back of the deque
+	ret: 	the value's handle, valid until it expires or is removed
+*/
+struct ttlEntry *addBackTtlDeque(struct ttlDeque *d, TYPE val, unsigned long ttl)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to addBackTtlDeque", 5);
+
+    return _addEntryAfter(d, d->sentinel.prev, val, ttl);
+}
+
+/* Add a value to the front of the deque
+
+	param: 	d		pointer to the deque
+	param: 	val		value to add
+	param: 	ttl		ticks from now until the value expires
+	pre:	d is not null, ttl > 0
+	post:	val is at the front of the deque
+	ret: 	the value's handle, valid until it expires or is removed
+*/
+struct ttlEntry *addFrontTtlDeque(struct ttlDeque *d, TYPE val, unsigned long ttl)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to addFrontTtlDeque", 6);
+
+    return _addEntryAfter(d, &d->sentinel, val, ttl);
+}
+
+/* Get the value at the front of the deque
+
+	param: 	d		pointer to the deque
+	pre:	d is not null and d is not empty
+	ret: 	the front value
+*/
+TYPE frontTtlDeque(struct ttlDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to frontTtlDeque", 7);
+
+    if (d->size < 1)
+        _gracefulExit("Passed empty ttlDeque to frontTtlDeque", 8);
+
+    return d->sentinel.next->value;
+}
+
+/* Get the value at the back of the deque
+
+	param: 	d		pointer to the deque
+	pre:	d is not null and d is not empty
+	ret: 	the back value
+*/
+TYPE backTtlDeque(struct ttlDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to backTtlDeque", 9);
+
+    if (d->size < 1)
+        _gracefulExit("Passed empty ttlDeque to backTtlDeque", 10);
+
+    return d->sentinel.prev->value;
+}
+
+/* Remove the front value before it expires
+
+	param: 	d		pointer to the deque
+	pre:	d is not null and d is not empty
+	post:	the front is removed, onExpire is not called
+*/
+void removeFrontTtlDeque(struct ttlDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to removeFrontTtlDeque", 11);
+
+    if (d->size < 1)
+        _gracefulExit("Passed empty ttlDeque to removeFrontTtlDeque", 12);
+
+    _removeEntry(d, d->sentinel.next);
+}
+
+/* Remove the back value before it expires
+
+	param: 	d		pointer to the deque
+	pre:	d is not null and d is not empty
+	post:	the back is removed, onExpire is not called
+*/
+void removeBackTtlDeque(struct ttlDeque *d)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to removeBackTtlDeque", 13);
+
+    if (d->size < 1)
+        _gracefulExit("Passed empty ttlDeque to removeBackTtlDeque", 14);
+
+    _removeEntry(d, d->sentinel.prev);
+}
+
+/* Remove a value anywhere in the deque before it expires
+
+	param: 	d		pointer to the deque
+	param: 	e		handle returned when the value was added
+	pre:	d is not null, e is a live entry of d
+	post:	e is removed and freed, onExpire is not called
+*/
+void removeTtlDeque(struct ttlDeque *d, struct ttlEntry *e)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to removeTtlDeque", 15);
+
+    assert(e != 0);
+    _removeEntry(d, e);
+}
+
+/* Give a value a new expiry, ttl ticks from now, keeping its place in the deque
+
+	param: 	d		pointer to the deque
+	param: 	e		handle returned when the value was added
+	param: 	ttl		ticks from now until the value expires
+	pre:	d is not null, e is a live entry of d, ttl > 0, not called from onExpire
+	post:	e expires at now + ttl
+*/
+void renewTtlDeque(struct ttlDeque *d, struct ttlEntry *e, unsigned long ttl)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to renewTtlDeque", 16);
+
+    assert(e != 0 && ttl > 0);
+    assert(!d->firing);     //e may be on the slot being expired
+
+    _unfileEntry(d, e);
+    e->expiry = (ttl > ULONG_MAX - d->now) ? ULONG_MAX : d->now + ttl;
+    _fileEntry(d, e);
+}
+
+/* Value of an entry
+
+	param: 	e		handle returned when the value was added
+	pre:	e is a live entry
+	ret: 	its value
+*/
+TYPE valueTtlEntry(struct ttlEntry *e)
+{
+    if (e == 0)
+        _gracefulExit("Passed null ttlEntry ptr to valueTtlEntry", 18);
+
+    return e->value;
+}
+
+/* Expiry time of an entry
+
+	param: 	e		handle returned when the value was added
+	pre:	e is a live entry
+	ret: 	the tick at which it expires
+*/
+unsigned long expiryTtlEntry(struct ttlEntry *e)
+{
+    if (e == 0)
+        _gracefulExit("Passed null ttlEntry ptr to expiryTtlEntry", 19);
+
+    return e->expiry;
+}
+
+/* Move the clock forward and remove every value that has expired. The
+   clock visits only the times at which a slot needs handling, so each
+   call costs O(expired values + cascaded values + WHEEL_LEVELS), plus a
+   scan of the overflow list each time one of its values enters the wheel.
+
+	param: 	d		pointer to the deque
+	param: 	now		new current time, earlier times leave the clock alone
+	pre:	d is not null, not called from onExpire
+	post:	values with expiry <= now are removed, oldest expiry first,
+			and onExpire is called for each
+	ret: 	number of values removed
+*/
+int advanceTtlDeque(struct ttlDeque *d, unsigned long now)
+{
+    if (d == 0)
+        _gracefulExit("Passed null ttlDeque ptr to advanceTtlDeque", 17);
+
+    assert(!d->firing);
+
+    int expired = 0, slot = 0;
+    unsigned long next;
+
+    while (now > d->now && (next = _nextEvent(d, &slot)) <= now) {
+        struct ttlEntry *e = d->wheel[slot];
+
+        //take the whole slot, then expire or refile each value
+        d->now = next;
+        d->wheel[slot] = 0;
+        if (slot < WHEEL_OVERFLOW)
+            d->occupied[slot / WHEEL_SLOTS] &= ~((uint64_t)1 << (slot % WHEEL_SLOTS));
+        else
+            d->overflowMin = ULONG_MAX;     //recomputed by the values refiled there
+
+        while (e != 0) {
+            struct ttlEntry *following = e->slotNext;
+
+            if (e->expiry <= d->now) {
+                e->prev->next = e->next;
+                e->next->prev = e->prev;
+                d->size--;
+                expired++;
+
+                if (d->onExpire != 0) {
+                    d->firing = 1;
+                    d->onExpire(d->ctx, e->value, e->expiry);
+                    d->firing = 0;
+                }
+                free(e);
+            }
+            else
+                _fileEntry(d, e);
+
+            e = following;
+        }
+    }
+
+    if (now > d->now)
+        d->now = now;
+    return expired;
+}
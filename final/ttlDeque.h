@@ -0,0 +1,47 @@
+#ifndef __TTLDEQUE_H
+#define __TTLDEQUE_H
+
+#include "cirListDeque.h"
+
+/* Deque whose values each carry an expiry time. Expiries are indexed in a
+   hierarchical timing wheel, so advancing the clock removes the expired
+   values in time proportional to their number, whatever their order in
+   the deque. Time is counted in caller defined integer ticks. */
+struct ttlDeque;
+
+/* handle of one value, valid until it expires or is removed */
+struct ttlEntry;
+
+/* called once for each value removed by advanceTtlDeque. It may add
+   values but must not remove or renew any, or advance the clock */
+typedef void (*ttlExpired)(void *ctx, TYPE val, unsigned long expiry);
+
+/* onExpire may be null */
+struct ttlDeque *createTtlDeque(unsigned long now, ttlExpired onExpire, void *ctx);
+void deleteTtlDeque(struct ttlDeque *d);
+
+int  isEmptyTtlDeque(struct ttlDeque *d);
+int  sizeTtlDeque(struct ttlDeque *d);
+unsigned long nowTtlDeque(struct ttlDeque *d);
+
+/* the value expires ttl ticks from now, ttl > 0 */
+struct ttlEntry *addBackTtlDeque(struct ttlDeque *d, TYPE val, unsigned long ttl);
+struct ttlEntry *addFrontTtlDeque(struct ttlDeque *d, TYPE val, unsigned long ttl);
+
+TYPE frontTtlDeque(struct ttlDeque *d);
+TYPE backTtlDeque(struct ttlDeque *d);
+void removeFrontTtlDeque(struct ttlDeque *d);
+void removeBackTtlDeque(struct ttlDeque *d);
+
+/* remove a value before it expires, or push its expiry to ttl from now */
+void removeTtlDeque(struct ttlDeque *d, struct ttlEntry *e);
+void renewTtlDeque(struct ttlDeque *d, struct ttlEntry *e, unsigned long ttl);
+
+TYPE valueTtlEntry(struct ttlEntry *e);
+unsigned long expiryTtlEntry(struct ttlEntry *e);
+
+/* move the clock to now and remove every value with expiry <= now;
+   returns the number removed */
+int  advanceTtlDeque(struct ttlDeque *d, unsigned long now);
+
+#endif
@@ -0,0 +1,532 @@
+/* compList.c
+ * compressed integer list implementation file.
+ 
+ Description:   Values live in blocks of up to COMP_BLOCK. The two end
+                blocks are plain arrays so adds and removes at either end
+                are O(1). When an end block fills up it is encoded and
+                moves into a doubly linked chain of sealed blocks: the first
+                value is stored as is, followed by zigzag varint deltas, so
+                runs of increasing IDs take about one byte per value. A
+                removal that empties an end block decodes the neighbouring
+                sealed block into it.
+
+                Every sealed block records its first, last, smallest and
+                largest value. front/back never decode a sealed block, and
+                containsCompList skips every block whose [min, max] range
+                cannot hold the value before decoding the rest on the fly.
+**** */
+
+#include "compList.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+# define COMP_BLOCK   128
+# define COMP_VARINT  10    /* longest varint of a 64 bit value */
+
+/* Sealed, encoded block */
+struct compBlock {
+    struct compBlock *prev;
+    struct compBlock *next;
+    int count;
+    int bytes;              /* length of data */
+    TYPE first;
+    TYPE last;
+    TYPE min;
+    TYPE max;
+    unsigned char data[];   /* varint deltas of values 1 .. count-1 */
+};
+
+/* Plain end block, values in vals[start .. end-1] */
+struct compBuffer {
+    TYPE vals[COMP_BLOCK];
+    int start;
+    int end;
+};
+
+struct compList {
+    struct compBuffer head;
+    struct compBlock *first;    /* sealed blocks between head and tail */
+    struct compBlock *last;
+    struct compBuffer tail;
+    int size;
+    long sealedBytes;
+};
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* Append the zigzag varint of a delta at p, returns bytes written */
+static int _putDelta(unsigned char *p, int64_t delta)
+{
+    uint64_t z = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+    int n = 0;
+
+    while (z >= 0x80) {
+        p[n++] = (unsigned char)(z | 0x80);
+        z >>= 7;
+    }
+    p[n++] = (unsigned char)z;
+    return n;
+}
+
+/* Read one zigzag varint delta at *p and advance *p past it */
+static int64_t _getDelta(const unsigned char **p)
+{
+    uint64_t z = 0;
+    int shift = 0;
+    const unsigned char *q = *p;
+
+    while (*q & 0x80) {
+        z |= (uint64_t)(*q++ & 0x7f) << shift;
+        shift += 7;
+    }
+    z |= (uint64_t)*q++ << shift;
+    *p = q;
+    return (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+}
+
+/* Encode vals[0 .. count-1] into a new sealed block, count > 0 */
+static struct compBlock *_seal(struct compList *lst, const TYPE *vals, int count)
+{
+    unsigned char tmp[COMP_BLOCK * COMP_VARINT];
+    int bytes = 0;
+    TYPE mn = vals[0], mx = vals[0];
+
+    for (int i = 1; i < count; i++) {
+        bytes += _putDelta(tmp + bytes, (int64_t)((uint64_t)vals[i] - (uint64_t)vals[i - 1]));
+        if (vals[i] < mn)
+            mn = vals[i];
+        if (vals[i] > mx)
+            mx = vals[i];
+    }
+
+    struct compBlock *b = malloc(sizeof(struct compBlock) + bytes);
+    assert(b != 0);
+    memcpy(b->data, tmp, bytes);
+    b->prev = b->next = 0;
+    b->count = count;
+    b->bytes = bytes;
+    b->first = vals[0];
+    b->last = vals[count - 1];
+    b->min = mn;
+    b->max = mx;
+
+    lst->sealedBytes += sizeof(struct compBlock) + bytes;
+    return b;
+}
+
+/* Decode a sealed block into vals, returns the count */
+static int _unseal(struct compBlock *b, TYPE *vals)
+{
+    const unsigned char *p = b->data;
+    uint64_t v = (uint64_t)b->first;
+
+    vals[0] = b->first;
+    for (int i = 1; i < b->count; i++) {
+        v += (uint64_t)_getDelta(&p);
+        vals[i] = (TYPE)v;
+    }
+    return b->count;
+}
+
+/* Unlink a sealed block from the chain and free it */
+static void _unlinkBlock(struct compList *lst, struct compBlock *b)
+{
+    if (b->prev != 0)
+        b->prev->next = b->next;
+    else
+        lst->first = b->next;
+
+    if (b->next != 0)
+        b->next->prev = b->prev;
+    else
+        lst->last = b->prev;
+
+    lst->sealedBytes -= sizeof(struct compBlock) + b->bytes;
+    free(b);
+}
+
+/* Link b into the chain after prev, or first when prev is null */
+static void _linkBlockAfter(struct compList *lst, struct compBlock *prev, struct compBlock *b)
+{
+    b->prev = prev;
+    b->next = (prev != 0) ? prev->next : lst->first;
+
+    if (b->next != 0)
+        b->next->prev = b;
+    else
+        lst->last = b;
+
+    if (prev != 0)
+        prev->next = b;
+    else
+        lst->first = b;
+}
+
+/*
+ createCompList
+ param: none
+ pre: none
+ post: an empty list is allocated
+ */
+struct compList *createCompList()
+{
+    struct compList *lst = malloc(sizeof(struct compList));
+    assert(lst != 0);
+
+    lst->head.start = lst->head.end = COMP_BLOCK;  //head grows downwards
+    lst->tail.start = lst->tail.end = 0;           //tail grows upwards
+    lst->first = lst->last = 0;
+    lst->size = 0;
+    lst->sealedBytes = 0;
+    return lst;
+}
+
+/*
+	deleteCompList
+	param: lst the list
+	pre: lst is not null
+	post: every block and lst itself are freed
+*/
+void deleteCompList(struct compList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to deleteCompList", 1);
+
+    while (lst->first != 0)
+        _unlinkBlock(lst, lst->first);
+    free(lst);
+}
+
+/*
+	isEmptyCompList
+	param: lst the list
+	pre: lst is not null
+	ret: 1 if the list is empty, else 0
+*/
+int isEmptyCompList(struct compList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to isEmptyCompList", 2);
+
+    return lst->size == 0;
+}
+
+/*
+	sizeCompList
+	param: lst the list
+	pre: lst is not null
+	ret: number of values in the list
+*/
+int sizeCompList(struct compList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to sizeCompList", 3);
+
+    return lst->size;
+}
+
+/*
+	addBackCompList
+	param: lst the list
+	param: e the element to be added
+	pre: lst is not null
+	post: e is the back of the list, increased size by 1
+*/
+void addBackCompList(struct compList *lst, TYPE e)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to addBackCompList", 4);
+
+    struct compBuffer *t = &lst->tail;
+
+    if (t->end == COMP_BLOCK) {
+        if (t->start > 0) {     //make room by sliding down
+            memmove(t->vals, t->vals + t->start, sizeof(TYPE) * (t->end - t->start));
+            t->end -= t->start;
+            t->start = 0;
+        }
+        else {                  //full, seal it
+            _linkBlockAfter(lst, lst->last, _seal(lst, t->vals, COMP_BLOCK));
+            t->start = t->end = 0;
+        }
+    }
+    t->vals[t->end++] = e;
+    lst->size++;
+}
+
+/*
+	addFrontCompList
+	param: lst the list
+	param: e the element to be added
+	pre: lst is not null
+	post: e is the front of the list, increased size by 1
+*/
+void addFrontCompList(struct compList *lst, TYPE e)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to addFrontCompList", 5);
+
+    struct compBuffer *h = &lst->head;
+
+    if (h->start == 0) {
+        if (h->end < COMP_BLOCK) {  //make room by sliding up
+            memmove(h->vals + COMP_BLOCK - h->end, h->vals, sizeof(TYPE) * h->end);
+            h->start = COMP_BLOCK - h->end;
+            h->end = COMP_BLOCK;
+        }
+        else {                      //full, seal it
+            _linkBlockAfter(lst, 0, _seal(lst, h->vals, COMP_BLOCK));
+            h->start = h->end = COMP_BLOCK;
+        }
+    }
+    h->vals[--h->start] = e;
+    lst->size++;
+}
+
+/*
+	frontCompList
+	param: lst the list
+	pre: lst is not null and not empty
+	ret: the front value, read without decoding any block
+*/
+TYPE frontCompList(struct compList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to frontCompList", 6);
+
+    if (lst->size == 0)
+        _gracefulExit("Passed empty compList to frontCompList", 7);
+
+    if (lst->head.start < lst->head.end)
+        return lst->head.vals[lst->head.start];
+    if (lst->first != 0)
+        return lst->first->first;
+    return lst->tail.vals[lst->tail.start];
+}
+
+/*
+	backCompList
+	param: lst the list
+	pre: lst is not null and not empty
+	ret: the back value, read without decoding any block
+*/
+TYPE backCompList(struct compList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to backCompList", 8);
+
+    if (lst->size == 0)
+        _gracefulExit("Passed empty compList to backCompList", 9);
+
+    if (lst->tail.start < lst->tail.end)
+        return lst->tail.vals[lst->tail.end - 1];
+    if (lst->last != 0)
+        return lst->last->last;
+    return lst->head.vals[lst->head.end - 1];
+}
+
+/*
+	removeFrontCompList
+	param: lst the list
+	pre: lst is not null and not empty
+	post: size reduced by 1
+*/
+void removeFrontCompList(struct compList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to removeFrontCompList", 10);
+
+    if (lst->size == 0)
+        _gracefulExit("Passed empty compList to removeFrontCompList", 11);
+
+    struct compBuffer *h = &lst->head;
+
+    if (h->start == h->end && lst->first != 0) {
+        //refill the head from the first sealed block
+        h->start = 0;
+        h->end = _unseal(lst->first, h->vals);
+        _unlinkBlock(lst, lst->first);
+    }
+
+    if (h->start < h->end)
+        h->start++;
+    else
+        lst->tail.start++;
+    lst->size--;
+}
+
+/*
+	removeBackCompList
+	param: lst the list
+	pre: lst is not null and not empty
+	post: size reduced by 1
+*/
+void removeBackCompList(struct compList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to removeBackCompList", 12);
+
+    if (lst->size == 0)
+        _gracefulExit("Passed empty compList to removeBackCompList", 13);
+
+    struct compBuffer *t = &lst->tail;
+
+    if (t->start == t->end && lst->last != 0) {
+        //refill the tail from the last sealed block
+        t->start = 0;
+        t->end = _unseal(lst->last, t->vals);
+        _unlinkBlock(lst, lst->last);
+    }
+
+    if (t->start < t->end)
+        t->end--;
+    else
+        lst->head.end--;
+    lst->size--;
+}
+
+/*
+	addCompList
+	param: lst the list
+	param: v the value to add
+	pre: lst is not null
+	post: v is at the back, where increasing IDs compress best
+*/
+void addCompList(struct compList *lst, TYPE v)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to addCompList", 14);
+
+    addBackCompList(lst, v);
+}
+
+/* Index of e in buffer b, or -1 */
+static int _findInBuffer(struct compBuffer *b, TYPE e)
+{
+    for (int i = b->start; i < b->end; i++)
+        if (EQ(b->vals[i], e))
+            return i;
+    return -1;
+}
+
+/* Position of e in sealed block b, decoding on the fly, or -1 */
+static int _findInBlock(struct compBlock *b, TYPE e)
+{
+    if (e < b->min || e > b->max)
+        return -1;
+
+    const unsigned char *p = b->data;
+    uint64_t v = (uint64_t)b->first;
+
+    if (EQ(b->first, e))
+        return 0;
+    for (int i = 1; i < b->count; i++) {
+        v += (uint64_t)_getDelta(&p);
+        if (EQ((TYPE)v, e))
+            return i;
+    }
+    return -1;
+}
+
+/*
+	containsCompList
+	param: lst the list
+	param: e the value to look for
+	pre: lst is not null
+	ret: 1 if e is in the list, else 0
+*/
+int containsCompList(struct compList *lst, TYPE e)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to containsCompList", 15);
+
+    if (_findInBuffer(&lst->head, e) >= 0)
+        return 1;
+
+    for (struct compBlock *b = lst->first; b != 0; b = b->next)
+        if (_findInBlock(b, e) >= 0)
+            return 1;
+
+    return _findInBuffer(&lst->tail, e) >= 0;
+}
+
+/*
+	removeCompList
+	param: lst the list
+	param: e the value to remove
+	pre: lst is not null
+	post: the first occurrence of e, if any, is removed
+	ret: 1 if a value was removed, else 0
+*/
+int removeCompList(struct compList *lst, TYPE e)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to removeCompList", 16);
+
+    struct compBuffer *h = &lst->head, *t = &lst->tail;
+    int i = _findInBuffer(h, e);
+
+    if (i >= 0) {
+        memmove(h->vals + h->start + 1, h->vals + h->start, sizeof(TYPE) * (i - h->start));
+        h->start++;
+        lst->size--;
+        return 1;
+    }
+
+    for (struct compBlock *b = lst->first; b != 0; b = b->next) {
+        i = _findInBlock(b, e);
+        if (i < 0)
+            continue;
+
+        //re-encode the block without e
+        TYPE vals[COMP_BLOCK];
+        int count = _unseal(b, vals);
+        memmove(vals + i, vals + i + 1, sizeof(TYPE) * (count - i - 1));
+
+        if (count > 1)
+            _linkBlockAfter(lst, b, _seal(lst, vals, count - 1));
+        _unlinkBlock(lst, b);
+        lst->size--;
+        return 1;
+    }
+
+    i = _findInBuffer(t, e);
+    if (i >= 0) {
+        memmove(t->vals + i, t->vals + i + 1, sizeof(TYPE) * (t->end - i - 1));
+        t->end--;
+        lst->size--;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+	memoryCompList
+	param: lst the list
+	pre: lst is not null
+	ret: bytes of heap memory held by the list and its sealed blocks
+*/
+long memoryCompList(struct compList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null compList ptr to memoryCompList", 17);
+
+    return (long)sizeof(struct compList) + lst->sealedBytes;
+}
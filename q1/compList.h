@@ -0,0 +1,31 @@
+#ifndef __COMPLIST_H
+#define __COMPLIST_H
+
+#include "linkedList.h"
+
+/* Integer list stored as delta + varint encoded blocks. TYPE must be an
+   integer type of at most 64 bits. */
+struct compList;
+
+struct compList *createCompList();
+void deleteCompList(struct compList *lst);
+
+/* Deque Interface */
+int  isEmptyCompList(struct compList *lst);
+int  sizeCompList(struct compList *lst);
+void addBackCompList(struct compList *lst, TYPE e);
+void addFrontCompList(struct compList *lst, TYPE e);
+TYPE frontCompList(struct compList *lst);
+TYPE backCompList(struct compList *lst);
+void removeFrontCompList(struct compList *lst);
+void removeBackCompList(struct compList *lst);
+
+/* Bag Interface, addCompList appends at the back */
+void addCompList(struct compList *lst, TYPE v);
+int  containsCompList(struct compList *lst, TYPE e);
+int  removeCompList(struct compList *lst, TYPE e);
+
+/* bytes of heap memory held by the list */
+long memoryCompList(struct compList *lst);
+
+#endif
@@ -0,0 +1,63 @@
+/* compactBench.c
+ * linkedList compaction benchmark.
+ 
+ Description:   Builds lists whose links are scattered over the heap by
+                interleaving them with throwaway allocations of random
+                size, then times full scans (containsList of a missing
+                value) before and after compactList.
+                  gcc -O2 compactBench.c linkedList.c
+**** */
+
+#include "linkedList.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+# define SCANS 20
+
+/*Function to get number of milliseconds of processor time*/
+double getMilliseconds() {
+   return 1000.0 * clock() / CLOCKS_PER_SEC;
+}
+
+/* Time SCANS full traversals, returns ns per link */
+double scan(struct linkedList *l, int n)
+{
+    double t1 = getMilliseconds();
+    for (int i = 0; i < SCANS; i++)
+        containsList(l, -1);
+    double t2 = getMilliseconds();
+    return (t2 - t1) * 1e6 / ((double)SCANS * n);
+}
+
+int main(int argc, char* argv[]) {
+    srand(40);
+
+    for (int n = 1 << 14; n <= 1 << 21; n <<= 2) {
+        struct linkedList *l = createLinkedList();
+        void **junk = malloc(sizeof(void *) * n);
+
+        //every link lands between blocks that are later freed at random
+        for (int i = 0; i < n; i++) {
+            if (rand() % 2)
+                addFrontList(l, i);
+            else
+                addBackList(l, i);
+            junk[i] = malloc(16 + rand() % 512);
+        }
+        for (int i = 0; i < n; i++)
+            free(junk[i]);
+        free(junk);
+
+        double before = scan(l, n);
+        double t1 = getMilliseconds();
+        compactList(l);
+        double t2 = getMilliseconds();
+        double after = scan(l, n);
+
+        printf("%8d links: scattered %.2f ns/link, compacted %.2f ns/link (%.1fx), compactList %.1f ms\n",
+               n, before, after, before / after, t2 - t1);
+        deleteLinkedList(l);
+    }
+    return 0;
+}
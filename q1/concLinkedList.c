@@ -0,0 +1,409 @@
+/* concLinkedList.c
+ * two-lock concurrent deque implementation file.
+ 
+ Description:   Thread-safe deque on a doubly linked list with front and back
+                sentinels, in the style of the Michael-Scott two-lock queue.
+                Front operations only touch firstLink and the first couple of
+                links, back operations only lastLink and the last couple, so
+                each end gets its own lock.
+
+                While the deque holds at least CONC_SLACK elements an
+                operation on one end cannot share a link field with an
+                operation on the other end, and only its own lock is taken.
+                Below that both locks are taken, always front then back.
+
+                Sizes are only changed with the end lock held and after the
+                links are in place, so an in-flight operation on the other
+                end can make a size read stale only in the safe direction
+                (see _lockEnd).
+**** */
+
+#include "concLinkedList.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+# define CONC_SLACK 3
+
+/* Double Link */
+struct DLink {
+	TYPE value;
+	struct DLink * next;
+	struct DLink * prev;
+};
+
+/* Double Linked List with Head and Tail Sentinels and a lock per end */
+struct concLinkedList {
+    atomic_int size;
+    struct DLink *firstLink;
+    struct DLink *lastLink;
+    pthread_mutex_t frontLock;
+    pthread_mutex_t backLock;
+};
+
+# ifdef NODE_CACHE
+#include "nodeCache.h"
+#include <pthread.h>
+
+static struct nodePool *_linkPool;
+static pthread_once_t _linkPoolOnce = PTHREAD_ONCE_INIT;
+
+static void _initLinkPool() {
+    _linkPool = createNodePool(sizeof(struct DLink));
+}
+# endif
+
+/* Allocate a link, from the calling thread's node cache when built with
+   -DNODE_CACHE and from malloc otherwise */
+static struct DLink *_allocLink() {
+# ifdef NODE_CACHE
+    pthread_once(&_linkPoolOnce, _initLinkPool);
+    return allocNode(_linkPool);
+# else
+    return malloc(sizeof(struct DLink));
+# endif
+}
+
+/* Free a link allocated by _allocLink */
+static void _freeLink(struct DLink *l) {
+# ifdef NODE_CACHE
+    freeNode(_linkPool, l);
+# else
+    free(l);
+# endif
+}
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/*
+ createConcLinkedList
+ param: none
+ pre: none
+ post: firstLink and lastLink reference sentinels, both locks initialized
+ */
+struct concLinkedList *createConcLinkedList()
+{
+    struct concLinkedList *lst = malloc(sizeof(struct concLinkedList));
+    struct DLink *first = _allocLink();
+    struct DLink *last = _allocLink();
+    assert(lst != 0 && first != 0 && last != 0);
+
+    first->next = last;
+    first->prev = 0;
+    last->next = 0;
+    last->prev = first;
+
+    lst->firstLink = first;
+    lst->lastLink = last;
+    atomic_init(&lst->size, 0);
+    pthread_mutex_init(&lst->frontLock, 0);
+    pthread_mutex_init(&lst->backLock, 0);
+
+    return lst;
+}
+
+/*
+	deleteConcLinkedList
+	param: lst the deque
+	pre: lst is not null
+	pre: no other thread is using lst
+	post: all links, the locks and lst itself are freed
+*/
+void deleteConcLinkedList(struct concLinkedList *lst)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null concLinkedList ptr to deleteConcLinkedList", 1);
+
+    struct DLink *current = lst->firstLink, *next;
+
+    while (current != 0) {
+        next = current->next;
+        _freeLink(current);
+        current = next;
+    }
+
+    pthread_mutex_destroy(&lst->frontLock);
+    pthread_mutex_destroy(&lst->backLock);
+    free(lst);
+}
+
+/*
+	_lockEnd
+	param: lst the deque
+	param: front 1 to lock for a front operation, 0 for a back operation
+	pre: lst is not null, the calling thread holds neither lock
+	post: the lock for the requested end is held, and the other end's lock
+	      too if the deque is small enough for the ends to overlap
+	ret: 1 if both locks are held, else 0
+
+	Once the fast path is taken at most one operation on the other end can
+	be in flight, and it also saw at least CONC_SLACK elements. Two removes
+	on a three element deque then share only the middle link, and they write
+	different fields of it.
+*/
+static int _lockEnd(struct concLinkedList *lst, int front)
+{
+    if (front) {
+        pthread_mutex_lock(&lst->frontLock);
+        if (atomic_load(&lst->size) >= CONC_SLACK)
+            return 0;
+        pthread_mutex_lock(&lst->backLock);
+        return 1;
+    }
+
+    pthread_mutex_lock(&lst->backLock);
+    if (atomic_load(&lst->size) >= CONC_SLACK)
+        return 0;
+
+    //keep the front then back lock order
+    pthread_mutex_unlock(&lst->backLock);
+    pthread_mutex_lock(&lst->frontLock);
+    pthread_mutex_lock(&lst->backLock);
+    return 1;
+}
+
+/*
+	_unlockEnd
+	param: lst the deque
+	param: front the end passed to _lockEnd
+	param: both the value returned by _lockEnd
+	pre: the locks taken by _lockEnd are held
+	post: those locks are released
+*/
+static void _unlockEnd(struct concLinkedList *lst, int front, int both)
+{
+    if (both || !front)
+        pthread_mutex_unlock(&lst->backLock);
+    if (both || front)
+        pthread_mutex_unlock(&lst->frontLock);
+}
+
+/*
+	_addConc
+	param: lst the deque
+	param: e the value to add
+	param: front 1 to add at the front, 0 to add at the back
+	pre: lst is not null
+	post: size increased by 1
+*/
+static void _addConc(struct concLinkedList *lst, TYPE e, int front)
+{
+    //allocate outside of the critical section
+    struct DLink *newLink = _allocLink();
+    assert(newLink != 0);
+    newLink->value = e;
+
+    int both = _lockEnd(lst, front);
+
+    struct DLink *before = front ? lst->firstLink : lst->lastLink->prev;
+    newLink->prev = before;
+    newLink->next = before->next;
+    (newLink->next)->prev = newLink;
+    before->next = newLink;
+
+    atomic_fetch_add(&lst->size, 1);
+    _unlockEnd(lst, front, both);
+}
+
+/*
+	_removeConc
+	param: lst the deque
+	param: e receives the removed value, may be null
+	param: front 1 to remove from the front, 0 from the back
+	pre: lst is not null
+	post: size reduced by 1 if lst was not empty
+	ret: 1 if a value was removed, 0 if lst was empty
+*/
+static int _removeConc(struct concLinkedList *lst, TYPE *e, int front)
+{
+    int both = _lockEnd(lst, front);
+
+    if (atomic_load(&lst->size) == 0) {
+        _unlockEnd(lst, front, both);
+        return 0;
+    }
+
+    struct DLink *l = front ? lst->firstLink->next : lst->lastLink->prev;
+    (l->prev)->next = l->next;
+    (l->next)->prev = l->prev;
+
+    atomic_fetch_sub(&lst->size, 1);
+    _unlockEnd(lst, front, both);
+
+    if (e != 0)
+        *e = l->value;
+    _freeLink(l);
+    return 1;
+}
+
+/*
+	_peekConc
+	param: lst the deque
+	param: e receives the value
+	param: front 1 to read the front, 0 the back
+	pre: lst is not null, e is not null
+	post: none
+	ret: 1 if a value was read, 0 if lst was empty
+*/
+static int _peekConc(struct concLinkedList *lst, TYPE *e, int front)
+{
+    assert(e != 0);
+
+    int both = _lockEnd(lst, front);
+    int found = atomic_load(&lst->size) > 0;
+
+    if (found)
+        *e = front ? lst->firstLink->next->value : lst->lastLink->prev->value;
+
+    _unlockEnd(lst, front, both);
+    return found;
+}
+
+/*
+	isEmptyConcList
+	param: lst the deque
+	pre: lst is not null
+	post: none
+	ret: 1 if the deque was empty when checked, else 0
+*/
+int isEmptyConcList(struct concLinkedList *lst)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null concLinkedList ptr to isEmptyConcList", 2);
+
+    return atomic_load(&lst->size) == 0;
+}
+
+/*
+	sizeConcList
+	param: lst the deque
+	pre: lst is not null
+	post: none
+	ret: number of elements when checked
+*/
+int sizeConcList(struct concLinkedList *lst)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null concLinkedList ptr to sizeConcList", 3);
+
+    return atomic_load(&lst->size);
+}
+
+/*
+	addBackConcList
+	param: lst the deque
+	param: e the element to be added
+	pre: lst is not null
+	post: lst is not empty, increased size by 1
+*/
+void addBackConcList(struct concLinkedList *lst, TYPE e)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null concLinkedList ptr to addBackConcList", 4);
+
+    _addConc(lst, e, 0);
+}
+
+/*
+	addFrontConcList
+	param: lst the deque
+	param: e the element to be added
+	pre: lst is not null
+	post: lst is not empty, increased size by 1
+*/
+void addFrontConcList(struct concLinkedList *lst, TYPE e)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null concLinkedList ptr to addFrontConcList", 5);
+
+    _addConc(lst, e, 1);
+}
+
+/*
+	frontConcList
+	param: lst the deque
+	param: e receives the front value
+	pre: lst is not null, e is not null
+	post: none
+	ret: 1 if the deque was not empty, else 0
+*/
+int frontConcList(struct concLinkedList *lst, TYPE *e)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null concLinkedList ptr to frontConcList", 6);
+
+    return _peekConc(lst, e, 1);
+}
+
+/*
+	backConcList
+	param: lst the deque
+	param: e receives the back value
+	pre: lst is not null, e is not null
+	post: none
+	ret: 1 if the deque was not empty, else 0
+*/
+int backConcList(struct concLinkedList *lst, TYPE *e)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null concLinkedList ptr to backConcList", 7);
+
+    return _peekConc(lst, e, 0);
+}
+
+/*
+	removeFrontConcList
+	param: lst the deque
+	param: e receives the removed value, may be null
+	pre: lst is not null
+	post: size reduced by 1 if the deque was not empty
+	ret: 1 if a value was removed, else 0
+*/
+int removeFrontConcList(struct concLinkedList *lst, TYPE *e)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null concLinkedList ptr to removeFrontConcList", 8);
+
+    return _removeConc(lst, e, 1);
+}
+
+/*
+	removeBackConcList
+	param: lst the deque
+	param: e receives the removed value, may be null
+	pre: lst is not null
+	post: size reduced by 1 if the deque was not empty
+	ret: 1 if a value was removed, else 0
+*/
+int removeBackConcList(struct concLinkedList *lst, TYPE *e)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null concLinkedList ptr to removeBackConcList", 9);
+
+    return _removeConc(lst, e, 0);
+}
@@ -0,0 +1,26 @@
+#ifndef __CONCLISTDEQUE_H
+#define __CONCLISTDEQUE_H
+
+#include "linkedList.h"
+
+/* Thread-safe deque with separate front and back locks. Operations on
+   opposite ends run in parallel while the deque holds enough elements
+   that they cannot touch the same link. */
+struct concLinkedList;
+
+struct concLinkedList *createConcLinkedList();
+void deleteConcLinkedList(struct concLinkedList *lst);
+
+/* Deque Interface */
+int  isEmptyConcList(struct concLinkedList *lst);
+int  sizeConcList(struct concLinkedList *lst);
+void addBackConcList(struct concLinkedList *lst, TYPE e);
+void addFrontConcList(struct concLinkedList *lst, TYPE e);
+
+/* peek/remove return 1 and store the value in *e, or 0 if the deque was empty */
+int  frontConcList(struct concLinkedList *lst, TYPE *e);
+int  backConcList(struct concLinkedList *lst, TYPE *e);
+int  removeFrontConcList(struct concLinkedList *lst, TYPE *e);
+int  removeBackConcList(struct concLinkedList *lst, TYPE *e);
+
+#endif
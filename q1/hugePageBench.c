@@ -0,0 +1,133 @@
+/* hugePageBench.c
+ * huge page node arena benchmark.
+
+ Description:   Spreads N nodes over LISTS containers, each value going
+                to a random one, so consecutive links of a container sit
+                in different pages. Then times full traversals of every
+                container and the free walk of deleting them, once with
+                regular slabs and once with huge page arenas, each in a
+                fresh child process. Reports nodes per second and dTLB
+                misses per node from the hardware counters.
+
+                Traversal is containsList of a missing value for the
+                linkedList and reverseCirListDeque for the cirListDeque.
+                  gcc -O2 -DNODE_CACHE hugePageBench.c linkedList.c nodeCache.c perfCounters.c -lpthread
+                  gcc -O2 -DNODE_CACHE -DBENCH_CIRLISTDEQUE -I../final hugePageBench.c ../final/cirListDeque.c ../final/nodeCache.c perfCounters.c -lpthread
+                Run:
+                  ./a.out [nodes]
+**** */
+
+# ifndef NODE_CACHE
+# error "huge page arenas come from the node cache, build with -DNODE_CACHE"
+# endif
+
+#include "nodeCache.h"
+#include "perfCounters.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+# ifdef BENCH_CIRLISTDEQUE
+#include "cirListDeque.h"
+# define BACKEND_NAME       "cirListDeque"
+# define BACKEND            struct cirListDeque
+# define CREATE()           createCirListDeque()
+# define DELETE(B)          deleteCirListDeque(B)
+# define ADD(B, V)          addBackCirListDeque(B, V)
+# define WALK(B)            reverseCirListDeque(B)
+# else
+#include "linkedList.h"
+# define BACKEND_NAME       "linkedList"
+# define BACKEND            struct linkedList
+# define CREATE()           createLinkedList()
+# define DELETE(B)          deleteLinkedList(B)
+# define ADD(B, V)          addBackList(B, V)
+# define WALK(B)            containsList(B, -1)
+# endif
+
+# define LISTS  256
+# define WALKS  5
+
+/*Function to get number of milliseconds of wall time*/
+double getMilliseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* Prints nodes per second and dTLB misses per node of one timed phase */
+void report(const char *phase, struct perfCounters *p, double ms, double nodes)
+{
+    printf("  %-10s %8.1f Mnodes/s", phase, nodes / ms / 1000.0);
+    if (readPerfCounter(p, PERF_DTLB_MISSES) >= 0)
+        printf("  %s %.4f/node", namePerfCounter(PERF_DTLB_MISSES), readPerfCounter(p, PERF_DTLB_MISSES) / nodes);
+    if (readPerfCounter(p, PERF_CYCLES) > 0)
+        printf("  %.1f cycles/node", readPerfCounter(p, PERF_CYCLES) / nodes);
+    printf("\n");
+}
+
+/* Builds, walks and deletes the containers with slabs in the given mode */
+void run(int huge, int n)
+{
+    static BACKEND *lists[LISTS];
+    struct perfCounters *p = createPerfCounters();
+
+    hugePagesNodeCache(huge);
+    srand(1);
+    for (int i = 0; i < LISTS; i++)
+        lists[i] = CREATE();
+    for (int i = 0; i < n; i++)
+        ADD(lists[rand() % LISTS], i);
+
+    if (!huge)
+        printf("regular slabs:\n");
+    else if (pageBackingNodeCache() == NODE_PAGES_HUGETLB)
+        printf("huge page arenas (hugetlb):\n");
+    else if (pageBackingNodeCache() == NODE_PAGES_THP)
+        printf("huge page arenas (transparent huge pages):\n");
+    else
+        printf("huge page arenas (fell back to regular pages):\n");
+
+    startPerfCounters(p);
+    double t1 = getMilliseconds();
+    for (int w = 0; w < WALKS; w++)
+        for (int i = 0; i < LISTS; i++)
+            WALK(lists[i]);
+    double t2 = getMilliseconds();
+    stopPerfCounters(p);
+    report("traverse", p, t2 - t1, (double)WALKS * n);
+
+    startPerfCounters(p);
+    t1 = getMilliseconds();
+    for (int i = 0; i < LISTS; i++)
+        DELETE(lists[i]);
+    t2 = getMilliseconds();
+    stopPerfCounters(p);
+    report("free walk", p, t2 - t1, n);
+
+    deletePerfCounters(p);
+}
+
+int main(int argc, char* argv[]) {
+    int n = (argc > 1) ? atoi(argv[1]) : 1 << 22;
+
+    if (n <= 0) {
+        printf("usage: %s [nodes]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%s: %d nodes over %d containers\n", BACKEND_NAME, n, LISTS);
+    fflush(stdout);
+    for (int huge = 0; huge <= 1; huge++) {
+        //a fresh process so no slab of the other mode is reused
+        pid_t pid = fork();
+        if (pid == 0) {
+            run(huge, n);
+            return 0;
+        }
+        waitpid(pid, 0, 0);
+    }
+    return 0;
+}
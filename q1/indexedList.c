@@ -0,0 +1,438 @@
+/* indexedList.c
+ * indexed sequence implementation file.
+ 
+ Description:   Implicit treap of chunks. Every tree node holds up to
+                IDX_CHUNK consecutive values and the number of values in its
+                subtree, so position i is found by steering on subtree
+                counts instead of walking i links. A full chunk splits in
+                two and the new half is inserted as the in-order successor;
+                a chunk that empties is removed by merging its children.
+                Random priorities keep the expected depth at
+                O(log(n / IDX_CHUNK)), a handful of levels for millions of
+                values, and the chunks keep neighbouring values in one
+                cache-friendly array for range reads.
+**** */
+
+#include "indexedList.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+# define IDX_CHUNK 64
+
+struct idxNode {
+    TYPE vals[IDX_CHUNK];
+    int n;                  /* values in this chunk */
+    int count;              /* values in this subtree */
+    unsigned int prio;      /* max-heap order on priorities */
+    struct idxNode *left;
+    struct idxNode *right;
+};
+
+struct indexedList {
+    struct idxNode *root;
+    unsigned int seed;      /* xorshift state for priorities */
+};
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+static int _count(struct idxNode *t)
+{
+    return (t != 0) ? t->count : 0;
+}
+
+static void _update(struct idxNode *t)
+{
+    t->count = _count(t->left) + t->n + _count(t->right);
+}
+
+static struct idxNode *_newNode(struct indexedList *lst)
+{
+    struct idxNode *t = malloc(sizeof(struct idxNode));
+    assert(t != 0);
+
+    lst->seed ^= lst->seed << 13;
+    lst->seed ^= lst->seed >> 17;
+    lst->seed ^= lst->seed << 5;
+
+    t->n = 0;
+    t->count = 0;
+    t->prio = lst->seed;
+    t->left = t->right = 0;
+    return t;
+}
+
+/* Rotate so that a child with a higher priority moves above t */
+static void _fixUp(struct idxNode **t)
+{
+    struct idxNode *node = *t, *child;
+
+    if (node->left != 0 && node->left->prio > node->prio) {
+        child = node->left;
+        node->left = child->right;
+        child->right = node;
+        _update(node);
+        *t = child;
+    }
+    else if (node->right != 0 && node->right->prio > node->prio) {
+        child = node->right;
+        node->right = child->left;
+        child->left = node;
+        _update(node);
+        *t = child;
+    }
+    _update(*t);
+}
+
+/* Merge two treaps, every position of a before every position of b */
+static struct idxNode *_merge(struct idxNode *a, struct idxNode *b)
+{
+    if (a == 0)
+        return b;
+    if (b == 0)
+        return a;
+
+    if (a->prio > b->prio) {
+        a->right = _merge(a->right, b);
+        _update(a);
+        return a;
+    }
+    b->left = _merge(a, b->left);
+    _update(b);
+    return b;
+}
+
+/* Insert node as the first chunk of the treap at *t */
+static void _insertFirst(struct idxNode **t, struct idxNode *node)
+{
+    if (*t == 0) {
+        _update(node);
+        *t = node;
+        return;
+    }
+    _insertFirst(&(*t)->left, node);
+    _fixUp(t);
+}
+
+/* Insert e at position i of the treap at *t, pre: 0 <= i <= count */
+static void _insert(struct indexedList *lst, struct idxNode **t, int i, TYPE e)
+{
+    struct idxNode *node = *t;
+    int ls = _count(node->left);
+
+    if (i < ls)
+        _insert(lst, &node->left, i, e);
+    else if (i > ls + node->n)
+        _insert(lst, &node->right, i - ls - node->n, e);
+    else {
+        int p = i - ls;
+
+        if (node->n == IDX_CHUNK) {
+            //move the upper half into a new successor chunk; at either end
+            //of the chunk move nothing or everything, so runs of adds to
+            //the front or back leave full chunks behind
+            struct idxNode *half = _newNode(lst);
+            half->n = (p == IDX_CHUNK) ? 0 : (p == 0) ? IDX_CHUNK : IDX_CHUNK / 2;
+            node->n = IDX_CHUNK - half->n;
+            memcpy(half->vals, node->vals + node->n, sizeof(TYPE) * half->n);
+
+            if (p > node->n || node->n == IDX_CHUNK) {
+                node = half;
+                p -= IDX_CHUNK - half->n;
+            }
+            memmove(node->vals + p + 1, node->vals + p, sizeof(TYPE) * (node->n - p));
+            node->vals[p] = e;
+            node->n++;
+
+            _insertFirst(&(*t)->right, half);
+        }
+        else {
+            memmove(node->vals + p + 1, node->vals + p, sizeof(TYPE) * (node->n - p));
+            node->vals[p] = e;
+            node->n++;
+        }
+    }
+    _fixUp(t);
+}
+
+/* Remove position i of the treap at *t, pre: 0 <= i < count */
+static void _remove(struct idxNode **t, int i)
+{
+    struct idxNode *node = *t;
+    int ls = _count(node->left);
+
+    if (i < ls)
+        _remove(&node->left, i);
+    else if (i >= ls + node->n)
+        _remove(&node->right, i - ls - node->n);
+    else {
+        int p = i - ls;
+
+        node->n--;
+        memmove(node->vals + p, node->vals + p + 1, sizeof(TYPE) * (node->n - p));
+
+        if (node->n == 0) {
+            *t = _merge(node->left, node->right);
+            free(node);
+            return;
+        }
+    }
+    _update(node);
+}
+
+/* Chunk and offset holding position i, pre: 0 <= i < count */
+static TYPE *_locate(struct idxNode *t, int i)
+{
+    while (1) {
+        int ls = _count(t->left);
+
+        if (i < ls)
+            t = t->left;
+        else if (i < ls + t->n)
+            return &t->vals[i - ls];
+        else {
+            i -= ls + t->n;
+            t = t->right;
+        }
+    }
+}
+
+/* Copy up to count values from position start of the treap at t */
+static int _copyRange(struct idxNode *t, int start, int count, TYPE *vals)
+{
+    if (t == 0 || count <= 0 || start >= t->count)
+        return 0;
+
+    int copied = 0, ls = _count(t->left);
+
+    if (start < ls)
+        copied = _copyRange(t->left, start, count, vals);
+
+    int p = (start > ls) ? start - ls : 0;
+    if (p < t->n && copied < count) {
+        int take = t->n - p;
+        if (take > count - copied)
+            take = count - copied;
+        memcpy(vals + copied, t->vals + p, sizeof(TYPE) * take);
+        copied += take;
+    }
+
+    int rs = start - ls - t->n;
+    return copied + _copyRange(t->right, (rs > 0) ? rs : 0, count - copied, vals + copied);
+}
+
+static void _freeTree(struct idxNode *t)
+{
+    if (t == 0)
+        return;
+    _freeTree(t->left);
+    _freeTree(t->right);
+    free(t);
+}
+
+/*
+ createIndexedList
+ param: none
+ pre: none
+ post: an empty sequence is allocated
+ */
+struct indexedList *createIndexedList()
+{
+    struct indexedList *lst = malloc(sizeof(struct indexedList));
+    assert(lst != 0);
+    lst->root = 0;
+    lst->seed = 2463534242u;
+    return lst;
+}
+
+/*
+	deleteIndexedList
+	param: lst the sequence
+	pre: lst is not null
+	post: every chunk and lst itself are freed
+*/
+void deleteIndexedList(struct indexedList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null indexedList ptr to deleteIndexedList", 1);
+
+    _freeTree(lst->root);
+    free(lst);
+}
+
+/*
+	isEmptyIndexedList
+	param: lst the sequence
+	pre: lst is not null
+	ret: 1 if lst holds no values, else 0
+*/
+int isEmptyIndexedList(struct indexedList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null indexedList ptr to isEmptyIndexedList", 2);
+
+    return lst->root == 0;
+}
+
+/*
+	sizeIndexedList
+	param: lst the sequence
+	pre: lst is not null
+	ret: number of values in lst
+*/
+int sizeIndexedList(struct indexedList *lst)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null indexedList ptr to sizeIndexedList", 3);
+
+    return _count(lst->root);
+}
+
+/*
+	getAtIndexedList
+	param: lst the sequence
+	param: i the position to read
+	pre: lst is not null, 0 <= i < size
+	ret: the value at position i
+*/
+TYPE getAtIndexedList(struct indexedList *lst, int i)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null indexedList ptr to getAtIndexedList", 4);
+
+    if (i < 0 || i >= _count(lst->root))
+        _gracefulExit("Passed out of range index to getAtIndexedList", 5);
+
+    return *_locate(lst->root, i);
+}
+
+/*
+	setAtIndexedList
+	param: lst the sequence
+	param: i the position to write
+	param: e the new value
+	pre: lst is not null, 0 <= i < size
+	post: position i holds e
+*/
+void setAtIndexedList(struct indexedList *lst, int i, TYPE e)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null indexedList ptr to setAtIndexedList", 6);
+
+    if (i < 0 || i >= _count(lst->root))
+        _gracefulExit("Passed out of range index to setAtIndexedList", 7);
+
+    *_locate(lst->root, i) = e;
+}
+
+/*
+	insertAtIndexedList
+	param: lst the sequence
+	param: i the position e will have
+	param: e the value to insert
+	pre: lst is not null, 0 <= i <= size
+	post: values from position i on move up by one, size increased by 1
+*/
+void insertAtIndexedList(struct indexedList *lst, int i, TYPE e)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null indexedList ptr to insertAtIndexedList", 8);
+
+    if (i < 0 || i > _count(lst->root))
+        _gracefulExit("Passed out of range index to insertAtIndexedList", 9);
+
+    if (lst->root == 0) {
+        lst->root = _newNode(lst);
+        lst->root->vals[0] = e;
+        lst->root->n = 1;
+        _update(lst->root);
+        return;
+    }
+    _insert(lst, &lst->root, i, e);
+}
+
+/*
+	removeAtIndexedList
+	param: lst the sequence
+	param: i the position to remove
+	pre: lst is not null, 0 <= i < size
+	post: values after position i move down by one, size reduced by 1
+*/
+void removeAtIndexedList(struct indexedList *lst, int i)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null indexedList ptr to removeAtIndexedList", 10);
+
+    if (i < 0 || i >= _count(lst->root))
+        _gracefulExit("Passed out of range index to removeAtIndexedList", 11);
+
+    _remove(&lst->root, i);
+}
+
+/*
+	readRangeIndexedList
+	param: lst the sequence
+	param: start first position to read
+	param: count number of values wanted
+	param: vals receives the values
+	pre: lst is not null, start >= 0, vals holds at least count values
+	post: none
+	ret: number of values copied, fewer than count at the end of lst
+*/
+int readRangeIndexedList(struct indexedList *lst, int start, int count, TYPE *vals)
+{
+    if (lst == 0)
+        _gracefulExit("Passed null indexedList ptr to readRangeIndexedList", 12);
+
+    assert(start >= 0 && vals != 0);
+    return _copyRange(lst->root, start, count, vals);
+}
+
+/* ************************************************************************
+	Deque Interface Functions
+************************************************************************ */
+
+void addFrontIndexedList(struct indexedList *lst, TYPE e)
+{
+    insertAtIndexedList(lst, 0, e);
+}
+
+void addBackIndexedList(struct indexedList *lst, TYPE e)
+{
+    insertAtIndexedList(lst, sizeIndexedList(lst), e);
+}
+
+TYPE frontIndexedList(struct indexedList *lst)
+{
+    return getAtIndexedList(lst, 0);
+}
+
+TYPE backIndexedList(struct indexedList *lst)
+{
+    return getAtIndexedList(lst, sizeIndexedList(lst) - 1);
+}
+
+void removeFrontIndexedList(struct indexedList *lst)
+{
+    removeAtIndexedList(lst, 0);
+}
+
+void removeBackIndexedList(struct indexedList *lst)
+{
+    removeAtIndexedList(lst, sizeIndexedList(lst) - 1);
+}
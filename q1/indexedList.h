@@ -0,0 +1,31 @@
+#ifndef __INDEXEDLIST_H
+#define __INDEXEDLIST_H
+
+#include "linkedList.h"
+
+/* Sequence with positional access: get/set/insert/remove at any index
+   in O(log n) expected time, plus the deque operations */
+struct indexedList;
+
+struct indexedList *createIndexedList();
+void deleteIndexedList(struct indexedList *lst);
+
+int  isEmptyIndexedList(struct indexedList *lst);
+int  sizeIndexedList(struct indexedList *lst);
+
+/* Indexed Interface, 0 <= i < size (i <= size for insert) */
+TYPE getAtIndexedList(struct indexedList *lst, int i);
+void setAtIndexedList(struct indexedList *lst, int i, TYPE e);
+void insertAtIndexedList(struct indexedList *lst, int i, TYPE e);
+void removeAtIndexedList(struct indexedList *lst, int i);
+int  readRangeIndexedList(struct indexedList *lst, int start, int count, TYPE *vals);
+
+/* Deque Interface */
+void addFrontIndexedList(struct indexedList *lst, TYPE e);
+void addBackIndexedList(struct indexedList *lst, TYPE e);
+TYPE frontIndexedList(struct indexedList *lst);
+TYPE backIndexedList(struct indexedList *lst);
+void removeFrontIndexedList(struct indexedList *lst);
+void removeBackIndexedList(struct indexedList *lst);
+
+#endif
@@ -13,11 +13,20 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 
 /* Double Link*/
 struct DLink {
 	TYPE value;
+	char dead;	/* removed lazily, skipped until the next sweep */
+	char head;	/* first link of a scan segment, listed in skips */
 	struct DLink * next;
 	struct DLink * prev;
 };
@@ -28,8 +37,406 @@ struct linkedList{
 	int size;
 	struct DLink *firstLink;
 	struct DLink *lastLink;
+	struct _setIndex *index;	/* hash index of the links in set mode, else null */
+	struct _linkSlab *slabs;	/* blocks filled by compaction, newest first */
+	struct _linkSlab *compactSlab;	/* block the running compaction pass fills */
+	struct DLink *compactCursor;	/* last link moved by the running pass, else null */
+	struct DLink **skips;		/* heads of scan segments 1 on, segment 0 starts the list */
+	int skipCount;			/* segments, including segment 0 */
+	int skipCap;
+	int skipHint;			/* where the last head was found in skips */
+	int skipTail;			/* links appended to the last segment */
+	int skipFront;			/* links prepended since skipFrontMark */
+	struct DLink *skipFrontMark;	/* first link when the prepends were counted from, or null */
+	int dead;			/* links marked dead and not yet swept */
+	double lazyRatio;		/* sweep once dead links pass this share, 0 removes at once */
+# ifdef TRACE_OPS
+	struct opTrace *trace;		/* records every API call when not null */
+# endif
 };
 
+# ifdef TRACE_OPS
+#include "opTrace.h"
+# define TRACE(L, OP, V) do { if ((L)->trace != 0) recordOpTrace((L)->trace, OP, (double)(V)); } while (0)
+# else
+# define TRACE(L, OP, V)
+# endif
+
+# ifdef NODE_CACHE
+#include "nodeCache.h"
+
+static struct nodePool *_linkPool;
+static pthread_once_t _linkPoolOnce = PTHREAD_ONCE_INIT;
+
+static void _initLinkPool() {
+    _linkPool = createNodePool(sizeof(struct DLink));
+}
+# endif
+
+/* Allocate a link, from the calling thread's node cache when built with
+   -DNODE_CACHE and from malloc otherwise */
+struct DLink *_allocLink() {
+# ifdef NODE_CACHE
+    pthread_once(&_linkPoolOnce, _initLinkPool);
+    return allocNode(_linkPool);
+# else
+    return malloc(sizeof(struct DLink));
+# endif
+}
+
+/* Free a link allocated by _allocLink */
+void _freeLink(struct DLink *l) {
+# ifdef NODE_CACHE
+    freeNode(_linkPool, l);
+# else
+    free(l);
+# endif
+}
+
+/* Contiguous block of links handed out in list order by compaction. The
+   block is freed once every link carved from it has been released. */
+struct _linkSlab {
+    struct _linkSlab *next;
+    int capacity;
+    int used;               /* links handed out */
+    int live;               /* links handed out and not yet released */
+    size_t released;        /* bytes of dead links returned to the OS by shrinkList */
+    struct DLink links[];
+};
+
+# define COMPACT_MIN_SLAB 64
+
+/*
+	_dropSlab
+	param: lst the linkedList
+	param: slab a slab of lst with no live links
+	pre: lst and slab are not null
+	post: slab is unlinked from lst and freed
+*/
+void _dropSlab(struct linkedList *lst, struct _linkSlab *slab)
+{
+    struct _linkSlab **p = &lst->slabs;
+
+    while (*p != slab)
+        p = &(*p)->next;
+    *p = slab->next;
+    free(slab);
+}
+
+/*
+	_slabOf
+	param: lst the linkedList
+	param: l a link of lst
+	pre: lst and l are not null
+	ret: the slab l was carved from, or null if it came from _allocLink
+*/
+struct _linkSlab *_slabOf(struct linkedList *lst, struct DLink *l)
+{
+    uintptr_t a = (uintptr_t)l;
+
+    for (struct _linkSlab *s = lst->slabs; s != 0; s = s->next)
+        if (a >= (uintptr_t)s->links && a < (uintptr_t)(s->links + s->capacity))
+            return s;
+    return 0;
+}
+
+/*
+	_releaseLink
+	param: lst the linkedList
+	param: l a link unlinked from lst
+	pre: lst and l are not null
+	post: l is returned to its slab, or to _freeLink if it came from _allocLink
+*/
+void _releaseLink(struct linkedList *lst, struct DLink *l)
+{
+    struct _linkSlab *s = _slabOf(lst, l);
+
+    if (s == 0) {
+        _freeLink(l);
+        return;
+    }
+
+    //the slab being filled stays until its pass moves on
+    if (--s->live == 0 && s != lst->compactSlab)
+        _dropSlab(lst, s);
+}
+
+/* Hash index over the links of a set, keyed by HASH and compared with EQ.
+   Open addressing with linear probing; a removal shifts the rest of its
+   probe run back instead of leaving a tombstone. */
+struct _setIndex {
+    int mask;               /* capacity - 1, capacity is a power of two */
+    int shift;              /* 32 - log2(capacity), keeps the high hash bits */
+    int count;
+    struct DLink **slots;   /* null when empty */
+};
+
+# define SET_MIN_CAPACITY 16
+
+/*
+	_setSlot
+	param: idx the index
+	param: v the value to hash
+	pre: idx is not null
+	ret: the home slot of v
+*/
+int _setSlot(struct _setIndex *idx, TYPE v)
+{
+    return (int)(((unsigned int)HASH(v) * 2654435761u) >> idx->shift);
+}
+
+/*
+	_createSetIndex
+	param: n number of links the index should hold without growing
+	pre: none
+	post: an empty index is allocated
+*/
+struct _setIndex *_createSetIndex(int n)
+{
+    struct _setIndex *idx = malloc(sizeof(struct _setIndex));
+    assert(idx != 0);
+
+    int capacity = SET_MIN_CAPACITY, bits = 4;
+    while (capacity < 2 * n) {  //keep the load factor at or below 1/2
+        capacity <<= 1;
+        bits++;
+    }
+
+    idx->mask = capacity - 1;
+    idx->shift = 32 - bits;
+    idx->count = 0;
+    idx->slots = calloc(capacity, sizeof(struct DLink *));
+    assert(idx->slots != 0);
+    return idx;
+}
+
+/*
+	_freeSetIndex
+	param: idx the index
+	pre: idx is not null
+	post: idx is freed, the links themselves are untouched
+*/
+void _freeSetIndex(struct _setIndex *idx)
+{
+    free(idx->slots);
+    free(idx);
+}
+
+/*
+	_findSetLink
+	param: idx the index
+	param: v the value to look up
+	pre: idx is not null
+	ret: the link holding v, or null
+*/
+struct DLink *_findSetLink(struct _setIndex *idx, TYPE v)
+{
+    int h = _setSlot(idx, v);
+
+    while (idx->slots[h] != 0) {
+        if (EQ(idx->slots[h]->value, v))
+            return idx->slots[h];
+        h = (h + 1) & idx->mask;
+    }
+    return 0;
+}
+
+/*
+	_insertSetLink
+	param: idx the index
+	param: l the link to index
+	pre: idx and l are not null, no indexed link holds l's value
+	post: l is indexed, the table doubles when more than half full
+*/
+void _insertSetLink(struct _setIndex *idx, struct DLink *l)
+{
+    if (2 * (idx->count + 1) > idx->mask + 1) {
+        struct _setIndex *bigger = _createSetIndex(idx->count + 1);
+
+        for (int i = 0; i <= idx->mask; i++)
+            if (idx->slots[i] != 0)
+                _insertSetLink(bigger, idx->slots[i]);
+
+        free(idx->slots);
+        *idx = *bigger;
+        free(bigger);
+    }
+
+    int h = _setSlot(idx, l->value);
+    while (idx->slots[h] != 0)
+        h = (h + 1) & idx->mask;
+
+    idx->slots[h] = l;
+    idx->count++;
+}
+
+/*
+	_eraseSetLink
+	param: idx the index
+	param: l the link to drop
+	pre: idx is not null, l is indexed
+	post: l is no longer indexed
+*/
+void _eraseSetLink(struct _setIndex *idx, struct DLink *l)
+{
+    int i = _setSlot(idx, l->value);
+
+    while (idx->slots[i] != l)
+        i = (i + 1) & idx->mask;
+
+    //pull back later entries of the run that could live in the hole
+    for (int j = (i + 1) & idx->mask; idx->slots[j] != 0; j = (j + 1) & idx->mask) {
+        int home = _setSlot(idx, idx->slots[j]->value);
+
+        if (((j - home) & idx->mask) >= ((j - i) & idx->mask)) {
+            idx->slots[i] = idx->slots[j];
+            i = j;
+        }
+    }
+    idx->slots[i] = 0;
+    idx->count--;
+}
+
+# define SCAN_SEGMENT   4096    /* links per segment handed to a parallel scan worker */
+
+/*
+	_clearSkips
+	param: lst the linkedList
+	pre: lst is not null and empty
+	post: lst has the single segment 0, the table keeps its capacity
+*/
+void _clearSkips(struct linkedList *lst)
+{
+    lst->skipCount = 1;
+    lst->skipHint = 1;
+    lst->skipTail = 0;
+    lst->skipFront = 0;
+    lst->skipFrontMark = 0;
+}
+
+/*
+	_insertSkip
+	param: lst the linkedList
+	param: i index the new segment takes, 1 <= i <= skipCount
+	param: l first link of the new segment
+	pre: l lies in segment i - 1 and is not its first link
+	post: l heads segment i, the segments from i on move up one index
+*/
+void _insertSkip(struct linkedList *lst, int i, struct DLink *l)
+{
+    if (lst->skipCount >= lst->skipCap) {
+        lst->skipCap = lst->skipCap ? 2 * lst->skipCap : 16;
+        lst->skips = realloc(lst->skips, sizeof(struct DLink *) * lst->skipCap);
+        assert(lst->skips != 0);
+        lst->skips[0] = 0;      //segment 0 always starts after firstLink
+    }
+
+    memmove(&lst->skips[i + 1], &lst->skips[i], sizeof(struct DLink *) * (lst->skipCount - i));
+    lst->skips[i] = l;
+    lst->skipCount++;
+    l->head = 1;
+}
+
+/*
+	_findSkip
+	param: lst the linkedList
+	param: l a segment head of lst
+	pre: l->head is set
+	ret: index of l in lst->skips
+*/
+int _findSkip(struct linkedList *lst, struct DLink *l)
+{
+    //heads are mostly met in order, so start where the last one was
+    int i = (lst->skipHint < lst->skipCount) ? lst->skipHint : 1;
+
+    while (lst->skips[i] != l)
+        i = (i + 1 < lst->skipCount) ? i + 1 : 1;
+
+    lst->skipHint = i;
+    return i;
+}
+
+/*
+	_skipAdded
+	param: lst the linkedList
+	param: l the link just linked in
+	pre: l is linked, l->head is not yet set
+	post: a segment grown to SCAN_SEGMENT links at either end is split off
+*/
+void _skipAdded(struct linkedList *lst, struct DLink *l)
+{
+    l->head = 0;
+
+    if (l->next == lst->lastLink) {
+        //appends fill the last segment, a full one is closed
+        if (++lst->skipTail >= SCAN_SEGMENT) {
+            _insertSkip(lst, lst->skipCount, l);
+            lst->skipTail = 1;
+        }
+    }
+    else if (l->prev == lst->firstLink) {
+        //prepends fill segment 0, the mark is where the next split goes
+        if (lst->skipFrontMark == 0 || ++lst->skipFront >= SCAN_SEGMENT) {
+            if (lst->skipFrontMark != 0)
+                _insertSkip(lst, 1, lst->skipFrontMark);
+            lst->skipFrontMark = l;
+            lst->skipFront = 0;
+        }
+    }
+}
+
+/*
+	_skipRemoved
+	param: lst the linkedList
+	param: l the link being unlinked
+	pre: l's neighbours are already linked to each other, l->next is intact
+	post: l is no longer a segment head or the front mark
+*/
+void _skipRemoved(struct linkedList *lst, struct DLink *l)
+{
+    if (l == lst->skipFrontMark)
+        lst->skipFrontMark = 0;
+    if (l->next == lst->lastLink && lst->skipTail > 0)
+        lst->skipTail--;
+
+    if (l->head) {
+        int i = _findSkip(lst, l);
+        struct DLink *end = (i + 1 < lst->skipCount) ? lst->skips[i + 1] : lst->lastLink;
+
+        if (l->next != end) {
+            lst->skips[i] = l->next;    //the segment now starts one link later
+            l->next->head = 1;
+        }
+        else {
+            memmove(&lst->skips[i], &lst->skips[i + 1], sizeof(struct DLink *) * (lst->skipCount - i - 1));
+            lst->skipCount--;
+            if (i == lst->skipCount)
+                lst->skipTail = SCAN_SEGMENT;   //the segment before was closed full
+        }
+        l->head = 0;
+    }
+
+    if (lst->firstLink->next == lst->lastLink)
+        _clearSkips(lst);
+}
+
+/*
+	_skipMoved
+	param: lst the linkedList
+	param: old a link of lst
+	param: l the link that took old's place
+	pre: l is linked where old was
+	post: the table and the front mark name l instead of old
+*/
+void _skipMoved(struct linkedList *lst, struct DLink *old, struct DLink *l)
+{
+    l->head = old->head;
+    if (old->head)
+        lst->skips[_findSkip(lst, old)] = l;
+    if (lst->skipFrontMark == old)
+        lst->skipFrontMark = l;
+}
+
 /*
 	initList
 	param lst the linkedList
@@ -40,16 +447,36 @@ struct linkedList{
 void _initList (struct linkedList *lst) {
 
     lst->size = 0;
+    lst->index = 0;
+    lst->slabs = 0;
+    lst->compactSlab = 0;
+    lst->compactCursor = 0;
+    lst->skips = 0;
+    lst->skipCount = 1;
+    lst->skipCap = 0;
+    lst->skipHint = 1;
+    lst->skipTail = 0;
+    lst->skipFront = 0;
+    lst->skipFrontMark = 0;
+    lst->dead = 0;
+    lst->lazyRatio = 0;
+# ifdef TRACE_OPS
+    lst->trace = 0;
+# endif
 
-    struct DLink *firstLinkSentinel = malloc(sizeof(struct DLink));
-    struct DLink *lastLinkSentinel = malloc(sizeof(struct DLink));
+    struct DLink *firstLinkSentinel = _allocLink();
+    struct DLink *lastLinkSentinel = _allocLink();
     assert(lastLinkSentinel != 0 && firstLinkSentinel != 0);    //check allocation
     
-    firstLinkSentinel->value = 0;    //doesnt matter
+    memset(&firstLinkSentinel->value, 0, sizeof(TYPE));    //doesnt matter
+    firstLinkSentinel->dead = 0;
+    firstLinkSentinel->head = 0;
     firstLinkSentinel->next = lastLinkSentinel;
     firstLinkSentinel->prev = 0;
     
-    lastLinkSentinel->value = 0;    //doesnt matter
+    memset(&lastLinkSentinel->value, 0, sizeof(TYPE));    //doesnt matter
+    lastLinkSentinel->dead = 0;
+    lastLinkSentinel->head = 0;
     lastLinkSentinel->next = 0;
     lastLinkSentinel->prev = firstLinkSentinel;
     
@@ -93,11 +520,12 @@ void _addLinkBefore(struct linkedList *lst, struct DLink *l, TYPE v)
     //cannot add link before head sentinel
     assert(lst->firstLink != l);
     
-    struct DLink *newLink = malloc(sizeof(struct DLink));
+    struct DLink *newLink = _allocLink();
     assert(newLink != 0);
     
     //init new link
     newLink->value = v;
+    newLink->dead = 0;
     newLink->next = l;
     newLink->prev = l->prev;
     
@@ -105,6 +533,10 @@ void _addLinkBefore(struct linkedList *lst, struct DLink *l, TYPE v)
     (newLink->prev)->next = newLink;
     l->prev = newLink;
     
+    if (lst->index != 0)
+        _insertSetLink(lst->index, newLink);
+
+    _skipAdded(lst, newLink);
     lst->size++;
 }
 
@@ -129,8 +561,94 @@ void _removeLink(struct linkedList *lst, struct DLink *l)
     (l->prev)->next = l->next;
     (l->next)->prev = l->prev;
     
-    free(l);
+    if (lst->index != 0)
+        _eraseSetLink(lst->index, l);
+
+    //a running compaction resumes after the link before l
+    if (lst->compactCursor == l)
+        lst->compactCursor = l->prev;
+
+    _skipRemoved(lst, l);
+    _releaseLink(lst, l);
+    lst->size--;
+}
+
+/*
+	_unlinkDead
+	param: lst the linkedList
+	param: l a dead link of lst
+	pre: lst is not null, l is dead
+	post: l is unlinked and released, the dead count is reduced by 1
+*/
+void _unlinkDead(struct linkedList *lst, struct DLink *l)
+{
+    assert(l->dead);
+
+    (l->prev)->next = l->next;
+    (l->next)->prev = l->prev;
+
+    if (lst->compactCursor == l)
+        lst->compactCursor = l->prev;
+
+    _skipRemoved(lst, l);
+    _releaseLink(lst, l);
+    lst->dead--;
+}
+
+/*
+	_retireLink
+	param: lst the linkedList
+	param: l a live link of lst
+	pre: lst is not null, l is not a sentinel
+	post: l is gone from the list's contents, either unlinked at once or,
+	      in lazy mode, marked dead and left for a sweep
+*/
+void _retireLink(struct linkedList *lst, struct DLink *l)
+{
+    if (lst->lazyRatio <= 0) {
+        _removeLink(lst, l);
+        return;
+    }
+
+    //the link stays where it is, only the index forgets it
+    if (lst->index != 0)
+        _eraseSetLink(lst->index, l);
+    l->dead = 1;
     lst->size--;
+    lst->dead++;
+}
+
+/*
+	_sweepDead
+	param: lst the linkedList
+	pre: lst is not null
+	post: every dead link is unlinked and released
+	ret: number of links swept
+*/
+int _sweepDead(struct linkedList *lst)
+{
+    int swept = lst->dead;
+    struct DLink *current = lst->firstLink->next, *next;
+
+    while (lst->dead > 0 && current != lst->lastLink) {
+        next = current->next;
+        if (current->dead)
+            _unlinkDead(lst, current);
+        current = next;
+    }
+    return swept;
+}
+
+/*
+	_sweepIfDue
+	param: lst the linkedList
+	pre: lst is not null
+	post: the dead links are swept if they pass the lazy ratio
+*/
+void _sweepIfDue(struct linkedList *lst)
+{
+    if (lst->dead > 0 && lst->dead > lst->lazyRatio * (lst->size + lst->dead))
+        _sweepDead(lst);
 }
 
 /*  _containsListRecursive
@@ -151,7 +669,7 @@ int _containsListRecursive(struct DLink *l, TYPE e) {
     //enforce preconditions
     assert(l != 0);
     
-    if (l->value == e && l->next != 0) //dont want the value if we are at the sentinel
+    if (EQ(l->value, e) && l->next != 0) //dont want the value if we are at the sentinel
         return 1;
     
     else if (l->next == 0)
@@ -202,13 +720,25 @@ int isEmptyList(struct linkedList *lst) {
 */
 void freeLinkedList(struct linkedList *lst)
 {
+	/* drop the set index first, the links go with the list anyway */
+	if (lst->index != 0) {
+		_freeSetIndex(lst->index);
+		lst->index = 0;
+	}
+
+	_sweepDead(lst);
 	while(!isEmptyList(lst)) {
 		/* remove the link right after the first sentinel */
 		_removeLink(lst, lst->firstLink->next);
 	}		
 	/* remove the first and last sentinels */
-	free(lst->firstLink);
-	free(lst->lastLink);	
+	_freeLink(lst->firstLink);
+	_freeLink(lst->lastLink);
+
+	/* only an emptied slab of an unfinished pass can be left */
+	while (lst->slabs != 0)
+		_dropSlab(lst, lst->slabs);
+	free(lst->skips);
 }
 
 /* 	Deallocate all the links and the linked list itself. 
@@ -246,7 +776,9 @@ void _printList(struct linkedList* lst) { // --------------DEBUG
         
         while (current->next != lst->lastLink) {
             current = current->next;
-            printf("List[%d]: %d\n", i, current->value);
+            if (current->dead)
+                continue;
+            printf("List[%d]: %lld\n", i, (long long)KEY(current->value));
             i++;
         }
     }
@@ -279,6 +811,12 @@ void addFrontList(struct linkedList *lst, TYPE e)
     if (lst == 0)
         _gracefulExit("Passed null linkedList ptr to addFrontList", 3);
     
+    TRACE(lst, TRACE_ADD_FRONT, KEY(e));
+
+    //a set ignores values it already holds
+    if (lst->index != 0 && _findSetLink(lst->index, e) != 0)
+        return;
+
     if (isEmptyList(lst))
         _addLinkBefore(lst, lst->lastLink, e);
     
@@ -299,6 +837,12 @@ void addBackList(struct linkedList *lst, TYPE e) {
     if (lst == 0)
         _gracefulExit("Passed null linkedList ptr to addBackList", 4);
     
+    TRACE(lst, TRACE_ADD_BACK, KEY(e));
+
+    //a set ignores values it already holds
+    if (lst->index != 0 && _findSetLink(lst->index, e) != 0)
+        return;
+
     //add same place whether or not list is empty
     _addLinkBefore(lst, lst->lastLink, e);
 }
@@ -319,7 +863,12 @@ TYPE frontList (struct linkedList *lst) {
     if (isEmptyList(lst))
         _gracefulExit("Passed empty linkedList to frontList", 6);
     
-    return ((lst->firstLink)->next)->value;
+    TRACE(lst, TRACE_FRONT, 0);
+
+    struct DLink *l = (lst->firstLink)->next;
+    while (l->dead)
+        l = l->next;
+    return l->value;
 }
 
 /*
@@ -338,7 +887,12 @@ TYPE backList(struct linkedList *lst)
     if (isEmptyList(lst))
         _gracefulExit("Passed empty linkedList to backList", 8);
     
-    return ((lst->lastLink)->prev)->value;
+    TRACE(lst, TRACE_BACK, 0);
+
+    struct DLink *l = (lst->lastLink)->prev;
+    while (l->dead)
+        l = l->prev;
+    return l->value;
 }
 
 
@@ -359,6 +913,11 @@ void removeFrontList(struct linkedList *lst) {
     if (isEmptyList(lst))
         _gracefulExit("Passed empty linkedList to removeFrontList", 10);
 
+    TRACE(lst, TRACE_REMOVE_FRONT, 0);
+
+    //dead links reached on the way go now
+    while (((lst->firstLink)->next)->dead)
+        _unlinkDead(lst, (lst->firstLink)->next);
     _removeLink(lst, (lst->firstLink)->next);
 }
 
@@ -378,6 +937,11 @@ void removeBackList(struct linkedList *lst) {
     if (isEmptyList(lst))
         _gracefulExit("Passed empty linkedList to removeBackList", 12);
     
+    TRACE(lst, TRACE_REMOVE_BACK, 0);
+
+    //dead links reached on the way go now
+    while (((lst->lastLink)->prev)->dead)
+        _unlinkDead(lst, (lst->lastLink)->prev);
     _removeLink(lst, (lst->lastLink)->prev);
 }
 
@@ -399,8 +963,13 @@ void addList(struct linkedList *lst, TYPE v)
     if (lst == 0)
         _gracefulExit("Passed null linkedList ptr to addList", 13);
     
-    addFrontList(lst, v);
+    TRACE(lst, TRACE_ADD, KEY(v));
 
+    //same as addFrontList, without tracing the call twice
+    if (lst->index != 0 && _findSetLink(lst->index, v) != 0)
+        return;
+
+    _addLinkBefore(lst, (lst->firstLink)->next, v);
 }
 
 /*	Returns boolean (encoded as an int) demonstrating whether or not
@@ -423,12 +992,17 @@ int containsList (struct linkedList *lst, TYPE e) {
     if (isEmptyList(lst))
         _gracefulExit("Passed empty linkedList to containsList", 15);
     
+    TRACE(lst, TRACE_CONTAINS, KEY(e));
+
+    if (lst->index != 0)
+        return _findSetLink(lst->index, e) != 0;
+
     struct DLink *current = lst->firstLink;
     
     while (current->next != lst->lastLink) {
         current = current->next;
         
-        if (current->value == e)
+        if (EQ(current->value, e) && !current->dead)
             return 1;
     }
     
@@ -456,20 +1030,1575 @@ void removeList (struct linkedList *lst, TYPE e) {
     if (isEmptyList(lst))
         _gracefulExit("Passed empty linkedList to removeList", 17);
     
+    TRACE(lst, TRACE_REMOVE, KEY(e));
+
     int removed = 0;
     
-    struct DLink *current = lst->firstLink;
-    
-    while (current->next != lst->lastLink) {    //dont want the sentinels
-        
-        current = current->next;
-        
-        if (current->value == e) {
-            _removeLink(lst, current);
+    //a set finds the link through its index
+    if (lst->index != 0) {
+        struct DLink *l = _findSetLink(lst->index, e);
+        if (l != 0) {
+            _retireLink(lst, l);
             removed = 1;
-            break;
         }
     }
+    else {
+        struct DLink *current = lst->firstLink;
+        
+        while (current->next != lst->lastLink) {    //dont want the sentinels
+            
+            current = current->next;
+            
+            if (EQ(current->value, e) && !current->dead) {
+                _retireLink(lst, current);
+                removed = 1;
+                break;
+            }
+        }
+    }
+    _sweepIfDue(lst);
     if (!removed)
-        printf("The element: %d that you tried to remove does not exist in the linked list.\n", e);
-}
\ No newline at end of file
+        printf("The element: %lld that you tried to remove does not exist in the linked list.\n", (long long)KEY(e));
+}
+
+/* ************************************************************************
+	Batch Bag Interface Functions
+************************************************************************ */
+
+/* Temporary hash set over a batch of query values. Queries with equal
+   values share one slot and are chained through next[] so a single
+   traversal of the list can answer every one of them. */
+struct _querySet {
+    int mask;       /* capacity - 1, capacity is a power of two */
+    int shift;      /* 32 - log2(capacity), keeps the high hash bits */
+    int *slots;     /* index of a query holding the slot's value, -1 if empty */
+    int *pending;   /* head of the chain of unanswered queries per slot */
+    int *next;      /* next query index with the same value, -1 terminates */
+    TYPE *vals;
+};
+
+/*
+	_hashSlot
+	param: set the query set
+	param: v the value to hash
+	pre: set is not null
+	post: none
+	ret: the home slot of v
+*/
+int _hashSlot(struct _querySet *set, TYPE v)
+{
+    return (int)(((unsigned int)HASH(v) * 2654435761u) >> set->shift);
+}
+
+/*
+	_initQuerySet
+	param: set the query set
+	param: vals the query values
+	param: n number of query values
+	pre: set is not null, vals is not null, n > 0
+	post: every query index is chained under the slot holding its value
+*/
+void _initQuerySet(struct _querySet *set, TYPE *vals, int n)
+{
+    assert(set != 0);
+    assert(vals != 0);
+
+    int capacity = 1, bits = 0;
+    while (capacity < 2 * n) {  //keep the load factor at or below 1/2
+        capacity <<= 1;
+        bits++;
+    }
+
+    set->mask = capacity - 1;
+    set->shift = 32 - bits;
+    set->vals = vals;
+    set->slots = malloc(sizeof(int) * capacity);
+    set->pending = malloc(sizeof(int) * capacity);
+    set->next = malloc(sizeof(int) * n);
+    assert(set->slots != 0 && set->pending != 0 && set->next != 0);
+
+    for (int i = 0; i < capacity; i++)
+        set->slots[i] = -1;
+
+    //insert back to front so each chain is in query order
+    for (int i = n - 1; i >= 0; i--) {
+        int h = _hashSlot(set, vals[i]);
+
+        while (set->slots[h] != -1 && !EQ(vals[set->slots[h]], vals[i]))
+            h = (h + 1) & set->mask;
+
+        if (set->slots[h] == -1) {
+            set->slots[h] = i;
+            set->next[i] = -1;
+        }
+        else
+            set->next[i] = set->pending[h];
+
+        set->pending[h] = i;
+    }
+}
+
+/*
+	_findQuerySlot
+	param: set the query set
+	param: v the value to look up
+	pre: set is initialized
+	post: none
+	ret: slot holding v, or -1 if v is not a query value
+*/
+int _findQuerySlot(struct _querySet *set, TYPE v)
+{
+    int h = _hashSlot(set, v);
+
+    while (set->slots[h] != -1) {
+        if (EQ(set->vals[set->slots[h]], v))
+            return h;
+        h = (h + 1) & set->mask;
+    }
+    return -1;
+}
+
+/*
+	_freeQuerySet
+	param: set the query set
+	pre: set is initialized
+	post: the memory owned by set is freed
+*/
+void _freeQuerySet(struct _querySet *set)
+{
+    free(set->slots);
+    free(set->pending);
+    free(set->next);
+}
+
+/*	Tests a batch of values for membership in one traversal of the bag
+
+	param:	lst		pointer to the bag
+	param:	vals	the values to look for
+	param:	n		number of values
+	param:	found	output, found[i] is set to 1 if vals[i] is in the bag, else 0
+	pre:	lst is not null
+	pre:	vals and found hold at least n elements
+	post:	no changes to the bag
+	ret:	number of values found
+*/
+int containsListBatch(struct linkedList *lst, TYPE *vals, int n, int *found)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to containsListBatch", 18);
+
+    if (n <= 0)
+        return 0;
+
+    assert(vals != 0 && found != 0);
+
+    for (int i = 0; i < n; i++)
+        found[i] = 0;
+
+    struct _querySet set;
+    _initQuerySet(&set, vals, n);
+
+    int remaining = n, count = 0;
+    struct DLink *current = lst->firstLink->next;
+
+    while (current != lst->lastLink && remaining > 0) {
+        int h = current->dead ? -1 : _findQuerySlot(&set, current->value);
+
+        //answer every query with this value at once
+        if (h != -1) {
+            for (int i = set.pending[h]; i != -1; i = set.next[i]) {
+                found[i] = 1;
+                count++;
+                remaining--;
+            }
+            set.pending[h] = -1;
+        }
+        current = current->next;
+    }
+
+    _freeQuerySet(&set);
+    return count;
+}
+
+/*	Removes one occurrence per entry of a batch of values in one traversal
+	of the bag. A value repeated k times in vals removes up to k occurrences.
+	Unlike removeList, misses are reported only through removed[].
+
+	param:	lst		pointer to the bag
+	param:	vals	the values to be removed
+	param:	n		number of values
+	param:	removed	output, removed[i] is set to 1 if an occurrence of vals[i]
+					was removed, else 0
+	pre:	lst is not null
+	pre:	vals and removed hold at least n elements
+	post:	size of the bag is reduced by the number of values removed
+	ret:	number of values removed
+*/
+int removeListBatch(struct linkedList *lst, TYPE *vals, int n, int *removed)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to removeListBatch", 19);
+
+    if (n <= 0)
+        return 0;
+
+    assert(vals != 0 && removed != 0);
+
+    for (int i = 0; i < n; i++)
+        removed[i] = 0;
+
+    struct _querySet set;
+    _initQuerySet(&set, vals, n);
+
+    int remaining = n, count = 0;
+    struct DLink *current = lst->firstLink->next, *next;
+
+    while (current != lst->lastLink && remaining > 0) {
+        next = current->next;
+        int h = current->dead ? -1 : _findQuerySlot(&set, current->value);
+
+        //match the earliest unanswered query with this value
+        if (h != -1 && set.pending[h] != -1) {
+            int i = set.pending[h];
+            set.pending[h] = set.next[i];
+            removed[i] = 1;
+            count++;
+            remaining--;
+            _retireLink(lst, current);
+        }
+        current = next;
+    }
+
+    _freeQuerySet(&set);
+    _sweepIfDue(lst);
+    return count;
+}
+
+
+/* ************************************************************************
+	Set Interface Functions
+************************************************************************ */
+
+/*
+	createLinkedSet
+	param: none
+	pre: none
+	post: an empty list in set mode is allocated
+*/
+struct linkedList *createLinkedSet()
+{
+    struct linkedList *lst = createLinkedList();
+    lst->index = _createSetIndex(0);
+    return lst;
+}
+
+/*	Switches a bag to set mode. The first occurrence of every value is kept
+	and later duplicates are removed; adds of a value already present are
+	ignored from then on.
+
+	param:	lst		pointer to the bag
+	pre:	lst is not null
+	post:	lst is in set mode
+	ret:	number of duplicates removed
+*/
+int setModeList(struct linkedList *lst)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to setModeList", 21);
+
+    if (lst->index != 0)
+        return 0;
+
+    _sweepDead(lst);
+    int before = lst->size;
+    struct DLink *current = lst->firstLink->next, *next;
+
+    //duplicates were never indexed, so attach the index only afterwards
+    struct _setIndex *idx = _createSetIndex(lst->size);
+    while (current != lst->lastLink) {
+        next = current->next;
+        if (_findSetLink(idx, current->value) != 0)
+            _removeLink(lst, current);
+        else
+            _insertSetLink(idx, current);
+        current = next;
+    }
+    lst->index = idx;
+    return before - lst->size;
+}
+
+/*
+	isSetList
+	param: lst the linkedList
+	pre: lst is not null
+	ret: 1 if lst is in set mode, else 0
+*/
+int isSetList(struct linkedList *lst)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to isSetList", 22);
+
+    return lst->index != 0;
+}
+
+/*	Values in a, b or both, in O(|a| + |b|)
+
+	param:	a, b	the sets
+	pre:	a and b are not null and in set mode
+	post:	a and b are unchanged
+	ret:	a new set, a's values in a's order followed by b's other values
+*/
+struct linkedList *unionList(struct linkedList *a, struct linkedList *b)
+{
+    //pre-conditions
+    if (a == 0 || b == 0)
+        _gracefulExit("Passed null linkedList ptr to unionList", 23);
+
+    if (a->index == 0 || b->index == 0)
+        _gracefulExit("Passed non-set linkedList to unionList", 24);
+
+    struct linkedList *result = createLinkedList();
+    result->index = _createSetIndex(a->size + b->size);
+
+    for (struct DLink *l = a->firstLink->next; l != a->lastLink; l = l->next)
+        if (!l->dead)
+            _addLinkBefore(result, result->lastLink, l->value);
+
+    for (struct DLink *l = b->firstLink->next; l != b->lastLink; l = l->next)
+        if (!l->dead && _findSetLink(a->index, l->value) == 0)
+            _addLinkBefore(result, result->lastLink, l->value);
+
+    return result;
+}
+
+/*	Values in both a and b, in O(|a|)
+
+	param:	a, b	the sets
+	pre:	a and b are not null and in set mode
+	post:	a and b are unchanged
+	ret:	a new set in a's order
+*/
+struct linkedList *intersectList(struct linkedList *a, struct linkedList *b)
+{
+    //pre-conditions
+    if (a == 0 || b == 0)
+        _gracefulExit("Passed null linkedList ptr to intersectList", 25);
+
+    if (a->index == 0 || b->index == 0)
+        _gracefulExit("Passed non-set linkedList to intersectList", 26);
+
+    struct linkedList *result = createLinkedList();
+    result->index = _createSetIndex(a->size < b->size ? a->size : b->size);
+
+    for (struct DLink *l = a->firstLink->next; l != a->lastLink; l = l->next)
+        if (!l->dead && _findSetLink(b->index, l->value) != 0)
+            _addLinkBefore(result, result->lastLink, l->value);
+
+    return result;
+}
+
+/*	Values in a but not in b, in O(|a|)
+
+	param:	a, b	the sets
+	pre:	a and b are not null and in set mode
+	post:	a and b are unchanged
+	ret:	a new set in a's order
+*/
+struct linkedList *differenceList(struct linkedList *a, struct linkedList *b)
+{
+    //pre-conditions
+    if (a == 0 || b == 0)
+        _gracefulExit("Passed null linkedList ptr to differenceList", 27);
+
+    if (a->index == 0 || b->index == 0)
+        _gracefulExit("Passed non-set linkedList to differenceList", 28);
+
+    struct linkedList *result = createLinkedList();
+    result->index = _createSetIndex(a->size);
+
+    for (struct DLink *l = a->firstLink->next; l != a->lastLink; l = l->next)
+        if (!l->dead && _findSetLink(b->index, l->value) == 0)
+            _addLinkBefore(result, result->lastLink, l->value);
+
+    return result;
+}
+
+
+/* ************************************************************************
+	Lazy Removal Functions
+************************************************************************ */
+
+/*	Sets how removes are carried out. With ratio > 0 removeList and
+	removeListBatch only mark links dead; reads skip them and one sweep
+	unlinks them all once they pass ratio of the links in the list. A
+	ratio >= 1 never sweeps on its own. A ratio of 0 removes at once and
+	sweeps the links already dead.
+
+	param:	lst		pointer to the list
+	param:	ratio	share of dead links that triggers a sweep, 0 to turn off
+	pre:	lst is not null, ratio >= 0
+	post:	later removes follow the new mode
+*/
+void lazyRemoveList(struct linkedList *lst, double ratio)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to lazyRemoveList", 42);
+
+    assert(ratio >= 0);
+
+    lst->lazyRatio = ratio;
+    if (ratio == 0)
+        _sweepDead(lst);
+    else
+        _sweepIfDue(lst);
+}
+
+/*	Number of links marked dead and not swept yet
+
+	param:	lst		pointer to the list
+	pre:	lst is not null
+	ret:	the dead count
+*/
+int deadCountList(struct linkedList *lst)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to deadCountList", 43);
+
+    return lst->dead;
+}
+
+/*	Unlinks and frees every dead link now, whatever the ratio
+
+	param:	lst		pointer to the list
+	pre:	lst is not null
+	post:	no link of lst is dead
+	ret:	number of links swept
+*/
+int sweepList(struct linkedList *lst)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to sweepList", 44);
+
+    return _sweepDead(lst);
+}
+
+
+/* ************************************************************************
+	Compaction Functions
+************************************************************************ */
+
+/*
+	_slabLink
+	param: lst the linkedList
+	pre: lst has a compaction pass running
+	post: none
+	ret: the next unused link of the pass's slab, opening a new slab when full
+*/
+struct DLink *_slabLink(struct linkedList *lst)
+{
+    struct _linkSlab *slab = lst->compactSlab;
+
+    if (slab == 0 || slab->used == slab->capacity) {
+        //room for the whole list keeps a single pass in one block
+        int capacity = lst->size > COMPACT_MIN_SLAB ? lst->size : COMPACT_MIN_SLAB;
+
+        lst->compactSlab = malloc(sizeof(struct _linkSlab) + sizeof(struct DLink) * capacity);
+        assert(lst->compactSlab != 0);
+        lst->compactSlab->capacity = capacity;
+        lst->compactSlab->used = 0;
+        lst->compactSlab->live = 0;
+        lst->compactSlab->released = 0;
+        lst->compactSlab->next = lst->slabs;
+        lst->slabs = lst->compactSlab;
+
+        if (slab != 0 && slab->live == 0)
+            _dropSlab(lst, slab);
+        slab = lst->compactSlab;
+    }
+
+    slab->live++;
+    return &slab->links[slab->used++];
+}
+
+/*
+	_endCompaction
+	param: lst the linkedList
+	pre: lst is not null
+	post: the running pass, if any, ends and its slab becomes an ordinary one
+*/
+void _endCompaction(struct linkedList *lst)
+{
+    struct _linkSlab *slab = lst->compactSlab;
+
+    lst->compactCursor = 0;
+    lst->compactSlab = 0;
+    if (slab != 0 && slab->live == 0)
+        _dropSlab(lst, slab);
+}
+
+/*	Moves up to maxNodes links into contiguous memory in list order,
+	continuing the pass started by an earlier call. Adds and removes may
+	happen between calls; links added behind the pass wait for the next one.
+	Dead links the pass reaches are swept instead of moved.
+
+	param:	lst			pointer to the list
+	param:	maxNodes	most links to move in this call
+	pre:	lst is not null, maxNodes > 0
+	post:	the moved links follow each other in memory
+	ret:	1 while the pass has links left to move, 0 once it is done
+*/
+int compactListStep(struct linkedList *lst, int maxNodes)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to compactListStep", 29);
+
+    assert(maxNodes > 0);
+
+    if (lst->compactCursor == 0)
+        lst->compactCursor = lst->firstLink;    //start a new pass
+
+    for (int moved = 0; moved < maxNodes && lst->compactCursor->next != lst->lastLink; moved++) {
+        struct DLink *old = lst->compactCursor->next;
+
+        //the pass sweeps dead links instead of moving them
+        if (old->dead) {
+            _unlinkDead(lst, old);
+            continue;
+        }
+
+        struct DLink *l = _slabLink(lst);
+
+        //take old's place
+        l->value = old->value;
+        l->dead = 0;
+        l->prev = old->prev;
+        l->next = old->next;
+        (l->prev)->next = l;
+        (l->next)->prev = l;
+
+        if (lst->index != 0) {
+            _eraseSetLink(lst->index, old);
+            _insertSetLink(lst->index, l);
+        }
+        _skipMoved(lst, old, l);
+
+        _releaseLink(lst, old);
+        lst->compactCursor = l;
+    }
+
+    if (lst->compactCursor->next != lst->lastLink)
+        return 1;
+
+    _endCompaction(lst);
+    return 0;
+}
+
+/*	Moves every link into one freshly allocated block in list order so
+	traversals read memory sequentially. Finishes a pass already begun by
+	compactListStep.
+
+	param:	lst		pointer to the list
+	pre:	lst is not null
+	post:	the links follow each other in memory
+*/
+void compactList(struct linkedList *lst)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to compactList", 30);
+
+    compactListStep(lst, lst->size + lst->dead + 1);
+}
+
+
+/* ************************************************************************
+	Parallel Bag Interface Functions
+************************************************************************ */
+
+# define SCAN_POLL      1024    /* links scanned between checks for a hit elsewhere */
+# define SCAN_MAX_THREADS 256
+
+# define SCAN_CONTAINS  0
+# define SCAN_COUNT     1
+# define SCAN_FIND      2
+
+/* Query shared by the workers of one parallel scan */
+struct _scanJob {
+    struct linkedList *lst;
+    TYPE e;
+    int mode;                   /* SCAN_CONTAINS, SCAN_COUNT or SCAN_FIND */
+    int *live;                  /* live links of each segment in SCAN_FIND mode, else null */
+    atomic_int nextSegment;     /* next segment to claim */
+    atomic_int stop;            /* set by the first hit of a contains query */
+};
+
+/* One worker and the matches it found */
+struct _scanWorker {
+    struct _scanJob *job;
+    pthread_t tid;
+    int count;
+    long long *hits;            /* segment << 32 | live offset of each match in SCAN_FIND mode */
+    int cap;
+};
+
+/*
+	_scanMain
+	param: arg the worker
+	pre: the list is not modified until the scan ends
+	post: the worker's count and hits cover every segment it claimed
+*/
+void *_scanMain(void *arg)
+{
+    struct _scanWorker *w = arg;
+    struct _scanJob *job = w->job;
+    struct linkedList *lst = job->lst;
+    int seg;
+
+    while (!atomic_load_explicit(&job->stop, memory_order_relaxed)
+           && (seg = atomic_fetch_add(&job->nextSegment, 1)) < lst->skipCount) {
+
+        struct DLink *current = (seg == 0) ? lst->firstLink->next : lst->skips[seg];
+        struct DLink *end = (seg + 1 < lst->skipCount) ? lst->skips[seg + 1] : lst->lastLink;
+        int live = 0;
+
+        for (int n = 0; current != end; n++, current = current->next) {
+            if (n % SCAN_POLL == 0 && atomic_load_explicit(&job->stop, memory_order_relaxed))
+                return 0;
+
+            //dead links are neither matched nor counted in positions
+            if (current->dead)
+                continue;
+
+            if (EQ(current->value, job->e)) {
+                if (job->mode == SCAN_FIND) {
+                    if (w->count == w->cap) {
+                        w->cap = w->cap ? 2 * w->cap : 64;
+                        w->hits = realloc(w->hits, sizeof(long long) * w->cap);
+                        assert(w->hits != 0);
+                    }
+                    w->hits[w->count] = (long long)seg << 32 | live;
+                }
+                w->count++;
+
+                if (job->mode == SCAN_CONTAINS) {
+                    atomic_store(&job->stop, 1);    //cancel the other workers
+                    return 0;
+                }
+            }
+            live++;
+        }
+
+        if (job->live != 0)
+            job->live[seg] = live;
+    }
+    return 0;
+}
+
+/*
+	_hitCompare
+	param: a, b pointers to scan hits
+	ret: negative, zero or positive as *a is before, at or after *b
+*/
+int _hitCompare(const void *a, const void *b)
+{
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+	_scanParallel
+	param: lst the linkedList
+	param: e the value to look for
+	param: mode SCAN_CONTAINS, SCAN_COUNT or SCAN_FIND
+	param: threads number of workers, <= 0 for one per online CPU
+	param: positions output for SCAN_FIND, may be null
+	param: max capacity of positions
+	pre: lst is not null and not modified during the scan
+	ret: 1/0 for SCAN_CONTAINS, else the number of matches
+*/
+int _scanParallel(struct linkedList *lst, TYPE e, int mode, int threads, int *positions, int max)
+{
+    if (threads <= 0)
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > SCAN_MAX_THREADS)
+        threads = SCAN_MAX_THREADS;
+
+    //the skip table is kept current by every add, remove and move
+    int segments = lst->skipCount;
+    if (threads > segments)
+        threads = segments;
+
+    struct _scanJob job;
+    job.lst = lst;
+    job.e = e;
+    job.mode = mode;
+    job.live = 0;
+    if (mode == SCAN_FIND) {
+        job.live = malloc(sizeof(int) * segments);
+        assert(job.live != 0);
+    }
+    atomic_init(&job.nextSegment, 0);
+    atomic_init(&job.stop, 0);
+
+    struct _scanWorker workers[SCAN_MAX_THREADS];
+    for (int i = 0; i < threads; i++) {
+        workers[i].job = &job;
+        workers[i].count = 0;
+        workers[i].hits = 0;
+        workers[i].cap = 0;
+    }
+
+    //the calling thread is worker 0
+    for (int i = 1; i < threads; i++) {
+        int rc = pthread_create(&workers[i].tid, 0, _scanMain, &workers[i]);
+        assert(rc == 0);
+    }
+    if (threads > 0)
+        _scanMain(&workers[0]);
+
+    int count = 0, stored = 0;
+    for (int i = 0; i < threads; i++) {
+        if (i > 0)
+            pthread_join(workers[i].tid, 0);
+        count += workers[i].count;
+    }
+
+    if (mode == SCAN_FIND) {
+        //segments finish out of order, gather every hit then sort
+        long long *all = malloc(sizeof(long long) * (count > 0 ? count : 1));
+        assert(all != 0);
+        for (int i = 0; i < threads; i++) {
+            if (workers[i].count > 0)
+                memcpy(all + stored, workers[i].hits, sizeof(long long) * workers[i].count);
+            stored += workers[i].count;
+        }
+        qsort(all, count, sizeof(long long), _hitCompare);
+
+        //live counts become the position each segment starts at
+        for (int i = 0, start = 0; i < segments; i++) {
+            int live = job.live[i];
+            job.live[i] = start;
+            start += live;
+        }
+        for (int i = 0; i < count && i < max; i++)
+            positions[i] = job.live[all[i] >> 32] + (int)(all[i] & 0xffffffff);
+
+        free(all);
+        free(job.live);
+    }
+
+    for (int i = 0; i < threads; i++)
+        free(workers[i].hits);
+
+    return mode == SCAN_CONTAINS ? count > 0 : count;
+}
+
+/*	Returns boolean (encoded as an int) demonstrating whether or not
+	the specified value is in the collection, scanning segments of the
+	list on several threads and stopping all of them at the first hit
+
+	param:	lst		pointer to the bag
+	param:	e		the value to look for in the bag
+	param:	threads	number of threads, <= 0 for one per online CPU
+	pre:	lst is not null
+	pre:	no other thread modifies lst during the call
+	post:	no changes to the bag
+*/
+int containsListParallel(struct linkedList *lst, TYPE e, int threads)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to containsListParallel", 31);
+
+    if (lst->index != 0)
+        return _findSetLink(lst->index, e) != 0;
+
+    return _scanParallel(lst, e, SCAN_CONTAINS, threads, 0, 0);
+}
+
+/*	Counts the occurrences of a value using several threads
+
+	param:	lst		pointer to the bag
+	param:	e		the value to count
+	param:	threads	number of threads, <= 0 for one per online CPU
+	pre:	lst is not null
+	pre:	no other thread modifies lst during the call
+	post:	no changes to the bag
+	ret:	number of links holding e
+*/
+int countListParallel(struct linkedList *lst, TYPE e, int threads)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to countListParallel", 32);
+
+    if (lst->index != 0)
+        return _findSetLink(lst->index, e) != 0;
+
+    return _scanParallel(lst, e, SCAN_COUNT, threads, 0, 0);
+}
+
+/*	Finds the positions, counted from the front, of every occurrence of a
+	value using several threads
+
+	param:	lst			pointer to the bag
+	param:	e			the value to look for
+	param:	threads		number of threads, <= 0 for one per online CPU
+	param:	positions	output, the first max positions in increasing order
+	param:	max			capacity of positions
+	pre:	lst is not null, positions holds max ints
+	pre:	no other thread modifies lst during the call
+	post:	no changes to the bag
+	ret:	number of occurrences, which may exceed max
+*/
+int findAllListParallel(struct linkedList *lst, TYPE e, int threads, int *positions, int max)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to findAllListParallel", 33);
+
+    assert(positions != 0 || max == 0);
+
+    return _scanParallel(lst, e, SCAN_FIND, threads, positions, max);
+}
+
+
+/* ************************************************************************
+	Merge Interface Functions
+************************************************************************ */
+
+/* Loser tree over the heads of k sorted runs of links. Leaf i sits at
+   position k + i, internal node n holds the loser of the match played
+   there and tree[0] the overall winner, so replacing the winner replays
+   only the log2(k) matches on its path. */
+struct _loserTree {
+    int k;
+    int *tree;
+    struct DLink **head;    /* next link of each run */
+    struct DLink **end;     /* link that ends each run, its lastLink sentinel */
+};
+
+/*
+	_beats
+	param: t the tree
+	param: a, b two runs
+	pre: t is not null
+	ret: whether run a's head goes first; exhausted runs lose and ties go
+	     to the lower run so equal values keep their source order
+*/
+int _beats(struct _loserTree *t, int a, int b)
+{
+    if (t->head[a] == t->end[a])
+        return 0;
+    if (t->head[b] == t->end[b])
+        return 1;
+    if (LT(t->head[b]->value, t->head[a]->value))
+        return 0;
+    return LT(t->head[a]->value, t->head[b]->value) || a < b;
+}
+
+/*
+	_replayLoserTree
+	param: t the tree
+	param: w the run whose head just changed, the last winner
+	pre: t is not null
+	post: the matches on w's path are replayed and tree[0] is the new winner
+*/
+void _replayLoserTree(struct _loserTree *t, int w)
+{
+    for (int n = (t->k + w) / 2; n >= 1; n /= 2) {
+        if (_beats(t, t->tree[n], w)) {
+            int loser = w;
+            w = t->tree[n];
+            t->tree[n] = loser;
+        }
+    }
+    t->tree[0] = w;
+}
+
+/*
+	_initLoserTree
+	param: t the tree
+	param: lists the sorted runs
+	param: k number of runs
+	pre: t is not null, lists holds k lists
+	post: every match is played once
+*/
+void _initLoserTree(struct _loserTree *t, struct linkedList **lists, int k)
+{
+    int slots = k > 0 ? k : 1;
+
+    t->k = k;
+    t->tree = malloc(sizeof(int) * slots);
+    t->head = malloc(sizeof(struct DLink *) * slots);
+    t->end = malloc(sizeof(struct DLink *) * slots);
+    assert(t->tree != 0 && t->head != 0 && t->end != 0);
+
+    for (int i = 0; i < k; i++) {
+        assert(lists[i] != 0);
+        t->head[i] = lists[i]->firstLink->next;
+        t->end[i] = lists[i]->lastLink;
+    }
+    if (k <= 0)
+        return;
+
+    //winners of every node, leaves first
+    size_t nodes = 2 * (size_t)k;
+    int *winner = malloc(sizeof(int) * nodes);
+    assert(winner != 0);
+    for (int i = 0; i < k; i++)
+        winner[k + i] = i;
+
+    for (int n = k - 1; n >= 1; n--) {
+        int a = winner[2 * n], b = winner[2 * n + 1];
+        if (_beats(t, a, b)) {
+            winner[n] = a;
+            t->tree[n] = b;
+        }
+        else {
+            winner[n] = b;
+            t->tree[n] = a;
+        }
+    }
+    t->tree[0] = (k == 1) ? 0 : winner[1];
+    free(winner);
+}
+
+/*
+	_freeLoserTree
+	param: t the tree
+	pre: t is not null
+	post: the tree's arrays are freed, the runs are untouched
+*/
+void _freeLoserTree(struct _loserTree *t)
+{
+    free(t->tree);
+    free(t->head);
+    free(t->end);
+}
+
+/*	Merges k lists, each sorted by LT, onto the back of out. The links are
+	moved rather than copied, with O(log k) comparisons per value; equal
+	values keep the order of their lists in lists.
+
+	param:	out		pointer to the list receiving the values
+	param:	lists	the sorted lists to merge
+	param:	k		number of lists
+	pre:	out is not null and not in set mode, lists holds k distinct
+			lists other than out
+	post:	out ends with every value of lists in LT order, the lists in
+			lists are empty and keep their set mode
+*/
+void mergeLists(struct linkedList *out, struct linkedList **lists, int k)
+{
+    //pre-conditions
+    if (out == 0)
+        _gracefulExit("Passed null linkedList ptr to mergeLists", 35);
+
+    if (out->index != 0)
+        _gracefulExit("Passed set mode linkedList to mergeLists", 36);
+
+    assert(lists != 0 || k == 0);
+
+    for (int i = 0; i < k; i++) {
+        assert(lists[i] != out);
+        _sweepDead(lists[i]);
+
+        //links carved from a slab take the slab with them
+        if (lists[i]->compactCursor != 0)
+            _endCompaction(lists[i]);
+        if (lists[i]->slabs != 0) {
+            struct _linkSlab *last = lists[i]->slabs;
+            while (last->next != 0)
+                last = last->next;
+            last->next = out->slabs;
+            out->slabs = lists[i]->slabs;
+            lists[i]->slabs = 0;
+        }
+    }
+
+    struct _loserTree t;
+    _initLoserTree(&t, lists, k);
+
+    while (k > 0 && t.head[t.tree[0]] != t.end[t.tree[0]]) {
+        int w = t.tree[0];
+        struct DLink *l = t.head[w];
+
+        t.head[w] = l->next;
+
+        //relink l before out's lastLink
+        l->prev = out->lastLink->prev;
+        l->next = out->lastLink;
+        (l->prev)->next = l;
+        out->lastLink->prev = l;
+        out->size++;
+        _skipAdded(out, l);
+
+        _replayLoserTree(&t, w);
+    }
+
+    for (int i = 0; i < k; i++) {
+        struct linkedList *src = lists[i];
+
+        src->firstLink->next = src->lastLink;
+        src->lastLink->prev = src->firstLink;
+        src->size = 0;
+        _clearSkips(src);
+        if (src->index != 0) {
+            _freeSetIndex(src->index);
+            src->index = _createSetIndex(0);
+        }
+    }
+    _freeLoserTree(&t);
+}
+
+/* Streaming merge of sorted lists, read one value at a time */
+struct listMerge {
+    struct _loserTree t;
+};
+
+/*	Starts a streaming merge of k lists, each sorted by LT. Dead links
+	are swept first, after that the lists are only read and must not
+	change until the merge is deleted.
+
+	param:	lists	the sorted lists to merge
+	param:	k		number of lists
+	pre:	lists holds k lists
+	ret:	a merge positioned before the smallest value
+*/
+struct listMerge *createListMerge(struct linkedList **lists, int k)
+{
+    //pre-conditions
+    if (lists == 0 && k > 0)
+        _gracefulExit("Passed null linkedList array to createListMerge", 37);
+
+    for (int i = 0; i < k; i++)
+        _sweepDead(lists[i]);
+
+    struct listMerge *m = malloc(sizeof(struct listMerge));
+    assert(m != 0);
+    _initLoserTree(&m->t, lists, k);
+    return m;
+}
+
+/*	Takes the next value of a streaming merge
+
+	param:	m		pointer to the merge
+	param:	val		receives the value
+	pre:	m is not null, val is not null
+	ret:	1 if a value was read, 0 once every list is exhausted
+*/
+int nextListMerge(struct listMerge *m, TYPE *val)
+{
+    //pre-conditions
+    if (m == 0)
+        _gracefulExit("Passed null listMerge ptr to nextListMerge", 38);
+
+    assert(val != 0);
+
+    struct _loserTree *t = &m->t;
+    if (t->k == 0 || t->head[t->tree[0]] == t->end[t->tree[0]])
+        return 0;
+
+    int w = t->tree[0];
+    *val = t->head[w]->value;
+    t->head[w] = t->head[w]->next;
+    _replayLoserTree(t, w);
+    return 1;
+}
+
+/*	Frees a streaming merge, the lists are left untouched
+
+	param:	m		pointer to the merge
+	pre:	m is not null
+*/
+void deleteListMerge(struct listMerge *m)
+{
+    //pre-conditions
+    if (m == 0)
+        _gracefulExit("Passed null listMerge ptr to deleteListMerge", 39);
+
+    _freeLoserTree(&m->t);
+    free(m);
+}
+
+
+/* ************************************************************************
+	Footprint Interface Functions
+************************************************************************ */
+
+# ifdef __GLIBC__
+#include <malloc.h>
+# endif
+
+/*
+	_heapBytes
+	param: p a block from malloc, or null
+	param: size the size it was requested with
+	pre: none
+	ret: bytes the block takes from the heap, its malloc header included
+*/
+size_t _heapBytes(void *p, size_t size)
+{
+    if (p == 0)
+        return 0;
+# ifdef __GLIBC__
+    //the request is a floor should the allocator report less
+    size_t usable = malloc_usable_size(p);
+    if (usable > size)
+        size = usable;
+    return size + sizeof(size_t);
+# else
+    return size;
+# endif
+}
+
+/*
+	_linkBytes
+	param: l a link from _allocLink
+	pre: l is not null
+	ret: bytes the link takes from its allocator
+*/
+size_t _linkBytes(struct DLink *l)
+{
+# ifdef NODE_CACHE
+    //pool nodes carry no header, the pool's spare nodes are not the list's
+    (void)l;
+    return sizeof(struct DLink);
+# else
+    return _heapBytes(l, sizeof(struct DLink));
+# endif
+}
+
+/*	Reports the memory the list holds. Values in links count as payload;
+	link pointers, padding, sentinels, allocator headers, the set index and
+	scan tables as overhead; slab space holding no live link as reserved.
+	Spare nodes of a -DNODE_CACHE pool are shared by every list and are
+	reported by residentNodeCache instead.
+
+	param:	lst		pointer to the list
+	param:	f		receives the byte counts
+	pre:	lst is not null, f is not null
+	post:	f->payload + f->overhead + f->reserved is the list's footprint
+*/
+void footprintList(struct linkedList *lst, struct memoryFootprint *f)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to footprintList", 40);
+
+    assert(f != 0);
+
+    f->payload = (size_t)lst->size * sizeof(TYPE);
+    f->overhead = _heapBytes(lst, sizeof(struct linkedList))
+                  + _linkBytes(lst->firstLink) + _linkBytes(lst->lastLink);
+    f->reserved = 0;
+
+    for (struct DLink *l = lst->firstLink->next; l != lst->lastLink; l = l->next) {
+        //a dead link holds no value, all of it waits for the sweep
+        if (l->dead)
+            f->reserved += _slabOf(lst, l) != 0 ? sizeof(struct DLink) : _linkBytes(l);
+        else if (_slabOf(lst, l) != 0)
+            f->overhead += sizeof(struct DLink) - sizeof(TYPE);
+        else
+            f->overhead += _linkBytes(l) - sizeof(TYPE);
+    }
+
+    for (struct _linkSlab *s = lst->slabs; s != 0; s = s->next) {
+        size_t block = sizeof(struct _linkSlab) + sizeof(struct DLink) * s->capacity;
+
+        f->overhead += _heapBytes(s, block) - sizeof(struct DLink) * s->capacity;
+        f->reserved += sizeof(struct DLink) * (s->capacity - s->live) - s->released;
+    }
+
+    if (lst->index != 0)
+        f->overhead += _heapBytes(lst->index, sizeof(struct _setIndex))
+                       + _heapBytes(lst->index->slots, sizeof(struct DLink *) * (lst->index->mask + 1));
+    f->overhead += _heapBytes(lst->skips, sizeof(struct DLink *) * lst->skipCap);
+}
+
+/* Whole pages of a slab's links, and which of them hold a live link */
+struct _slabPages {
+    struct _linkSlab *slab;
+    uintptr_t first;        /* first page boundary inside the links */
+    size_t pages;
+    unsigned char *live;
+};
+
+/*
+	_releaseDeadPages
+	param: lst the linkedList
+	pre: lst is not null
+	post: the whole pages of finished slabs that hold no live link are
+	      returned to the OS; compaction never hands those links out again
+	ret: bytes newly returned
+*/
+size_t _releaseDeadPages(struct linkedList *lst)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE), released = 0;
+    int slabs = 0, i;
+
+    for (struct _linkSlab *s = lst->slabs; s != 0; s = s->next)
+        slabs++;
+    if (slabs == 0)
+        return 0;
+
+    struct _slabPages *sp = malloc(sizeof(struct _slabPages) * slabs);
+    assert(sp != 0);
+
+    i = 0;
+    for (struct _linkSlab *s = lst->slabs; s != 0; s = s->next, i++) {
+        uintptr_t start = ((uintptr_t)s->links + page - 1) & ~(uintptr_t)(page - 1);
+        uintptr_t end = (uintptr_t)(s->links + s->capacity) & ~(uintptr_t)(page - 1);
+
+        sp[i].slab = s;
+        sp[i].first = start;
+        sp[i].pages = (end > start) ? (end - start) / page : 0;
+        sp[i].live = calloc(sp[i].pages + 1, 1);
+        assert(sp[i].live != 0);
+    }
+
+    for (struct DLink *l = lst->firstLink->next; l != lst->lastLink; l = l->next) {
+        struct _linkSlab *s = _slabOf(lst, l);
+        if (s == 0)
+            continue;
+        for (i = 0; sp[i].slab != s; i++)
+            ;
+
+        //a link may straddle two pages
+        uintptr_t ends[2] = {(uintptr_t)l, (uintptr_t)(l + 1) - 1};
+        for (int e = 0; e < 2; e++)
+            if (ends[e] >= sp[i].first && (ends[e] - sp[i].first) / page < sp[i].pages)
+                sp[i].live[(ends[e] - sp[i].first) / page] = 1;
+    }
+
+    for (i = 0; i < slabs; i++) {
+        struct _linkSlab *s = sp[i].slab;
+        size_t dead = 0;
+
+        //the running pass still hands out links from its slab
+        if (s != lst->compactSlab) {
+            for (size_t p = 0; p < sp[i].pages; p++)
+                if (!sp[i].live[p] && madvise((void *)(sp[i].first + p * page), page, MADV_DONTNEED) == 0)
+                    dead += page;
+
+            if (dead > s->released) {
+                released += dead - s->released;
+                s->released = dead;
+            }
+        }
+        free(sp[i].live);
+    }
+    free(sp);
+    return released;
+}
+
+/*	Returns memory the list no longer needs: the unused end of the scan
+	skip table, an oversized set index and the dead pages of compaction
+	slabs. Free heap memory is then handed back with malloc_trim, and the
+	node cache's free slabs with trimNodeCache when built with -DNODE_CACHE.
+
+	param:	lst		pointer to the list
+	pre:	lst is not null
+	post:	the list's contents are unchanged
+	ret:	bytes returned, not counting what malloc_trim releases
+*/
+size_t shrinkList(struct linkedList *lst)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to shrinkList", 41);
+
+    size_t released = 0;
+
+    _sweepDead(lst);
+
+    //the skip table is cut to the segments in use
+    if (lst->skipCap > lst->skipCount) {
+        size_t before = _heapBytes(lst->skips, sizeof(struct DLink *) * lst->skipCap);
+
+        if (lst->skipCount == 1) {
+            free(lst->skips);
+            lst->skips = 0;
+            lst->skipCap = 0;
+        }
+        else {
+            lst->skips = realloc(lst->skips, sizeof(struct DLink *) * lst->skipCount);
+            assert(lst->skips != 0);
+            lst->skipCap = lst->skipCount;
+        }
+
+        size_t after = _heapBytes(lst->skips, sizeof(struct DLink *) * lst->skipCap);
+        if (before > after)
+            released += before - after;
+    }
+
+    //an index left large by a burst of adds is rebuilt to fit
+    struct _setIndex *idx = lst->index;
+    if (idx != 0 && idx->mask + 1 > SET_MIN_CAPACITY && idx->mask + 1 > 4 * idx->count) {
+        struct _setIndex *fit = _createSetIndex(idx->count);
+        for (struct DLink *l = lst->firstLink->next; l != lst->lastLink; l = l->next)
+            _insertSetLink(fit, l);
+
+        size_t before = _heapBytes(idx->slots, sizeof(struct DLink *) * (idx->mask + 1));
+        size_t after = _heapBytes(fit->slots, sizeof(struct DLink *) * (fit->mask + 1));
+        if (before > after)
+            released += before - after;
+        _freeSetIndex(idx);
+        lst->index = fit;
+    }
+
+    released += _releaseDeadPages(lst);
+
+# ifdef NODE_CACHE
+    released += trimNodeCache();
+# endif
+# ifdef __GLIBC__
+    malloc_trim(0);
+# endif
+    return released;
+}
+
+
+# ifdef TRACE_OPS
+/* ************************************************************************
+	Trace Interface Functions
+************************************************************************ */
+
+/*	Starts or stops recording the deque and bag calls made on the list
+
+	param:	lst		pointer to the list
+	param:	t		trace to append to, or null to stop recording
+	pre:	lst is not null
+	post:	every later deque and bag call on lst is appended to t
+*/
+void traceList(struct linkedList *lst, struct opTrace *t)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to traceList", 34);
+
+    lst->trace = t;
+}
+# endif
+
+
+/* ************************************************************************
+	Export Interface Functions
+************************************************************************ */
+
+# define EXPORT_BUFFER_SIZE (1 << 16)
+# define EXPORT_MAX_ROW     64      /* longest formatted row, with room to spare */
+
+/* Output buffer shared by the export functions */
+struct _exportBuffer {
+    char *data;
+    int len;
+    exportWriter write;
+    void *ctx;
+    int error;
+};
+
+/* Two digit lookup table used by _formatInt */
+static const char _digitPairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/*
+	_formatInt
+	param: out buffer with room for at least 21 chars
+	param: v the value to format
+	pre: out is not null
+	post: the decimal representation of v is written to out
+	ret: number of chars written
+*/
+int _formatInt(char *out, long long v)
+{
+    char tmp[24];
+    char *p = tmp + sizeof(tmp);
+    unsigned long long u = (v < 0) ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+
+    while (u >= 100) {
+        int pair = (int)(u % 100) * 2;
+        u /= 100;
+        *--p = _digitPairs[pair + 1];
+        *--p = _digitPairs[pair];
+    }
+    if (u >= 10) {
+        *--p = _digitPairs[u * 2 + 1];
+        *--p = _digitPairs[u * 2];
+    }
+    else
+        *--p = (char)('0' + u);
+
+    if (v < 0)
+        *--p = '-';
+
+    int len = (int)(tmp + sizeof(tmp) - p);
+    memcpy(out, p, len);
+    return len;
+}
+
+/*
+	_flushExport
+	param: buf the export buffer
+	pre: buf is not null
+	post: buffered bytes are handed to the writer, buf->len is 0
+*/
+void _flushExport(struct _exportBuffer *buf)
+{
+    if (buf->len > 0 && !buf->error)
+        if (buf->write(buf->ctx, buf->data, buf->len) != 0)
+            buf->error = 1;
+    buf->len = 0;
+}
+
+/*
+	_reserveExport
+	param: buf the export buffer
+	param: n number of bytes about to be appended
+	pre: buf is not null, n <= EXPORT_BUFFER_SIZE
+	post: buf has room for n more bytes
+	ret: pointer to the first free byte
+*/
+char *_reserveExport(struct _exportBuffer *buf, int n)
+{
+    if (buf->len + n > EXPORT_BUFFER_SIZE)
+        _flushExport(buf);
+    return buf->data + buf->len;
+}
+
+/*	Streams the list contents front to back through a writer callback.
+	Output is assembled in a large buffer so the writer sees few, large
+	chunks regardless of the list size.
+
+	param:	lst		pointer to the list
+	param:	mode	EXPORT_TEXT, EXPORT_CSV or EXPORT_BINARY
+	param:	write	the writer callback
+	param:	ctx		opaque pointer passed through to write
+	pre:	lst is not null, write is not null
+	post:	no changes to the list
+	ret:	0 on success, -1 if the writer reported an error
+*/
+int exportList(struct linkedList *lst, int mode, exportWriter write, void *ctx)
+{
+    //pre-conditions
+    if (lst == 0)
+        _gracefulExit("Passed null linkedList ptr to exportList", 20);
+
+    assert(write != 0);
+    assert(mode == EXPORT_TEXT || mode == EXPORT_CSV || mode == EXPORT_BINARY);
+
+    struct _exportBuffer buf;
+    buf.data = malloc(EXPORT_BUFFER_SIZE);
+    assert(buf.data != 0);
+    buf.len = 0;
+    buf.write = write;
+    buf.ctx = ctx;
+    buf.error = 0;
+
+    if (mode == EXPORT_CSV) {
+        memcpy(_reserveExport(&buf, 12), "index,value\n", 12);
+        buf.len += 12;
+    }
+
+    struct DLink *current = lst->firstLink->next;
+    int i = 0;
+
+    //a binary row is one TYPE, which a struct payload can make longer than a text row
+    int row = (mode == EXPORT_BINARY && sizeof(TYPE) > EXPORT_MAX_ROW) ? (int)sizeof(TYPE) : EXPORT_MAX_ROW;
+    assert(row <= EXPORT_BUFFER_SIZE);
+
+    while (current != lst->lastLink && !buf.error) {
+        if (current->dead) {
+            current = current->next;
+            continue;
+        }
+
+        char *out = _reserveExport(&buf, row);
+        int n = 0;
+
+        if (mode == EXPORT_BINARY) {
+            memcpy(out, &current->value, sizeof(TYPE));
+            n = sizeof(TYPE);
+        }
+        else {
+            if (mode == EXPORT_CSV) {
+                n += _formatInt(out, i);
+                out[n++] = ',';
+            }
+            n += _formatInt(out + n, KEY(current->value));
+            out[n++] = '\n';
+        }
+
+        buf.len += n;
+        current = current->next;
+        i++;
+    }
+
+    _flushExport(&buf);
+    free(buf.data);
+    return buf.error ? -1 : 0;
+}
+
+/* exportWriter for stdio streams */
+int _writeFile(void *ctx, const char *buf, int len)
+{
+    return (fwrite(buf, 1, len, (FILE *)ctx) == (size_t)len) ? 0 : -1;
+}
+
+/* exportWriter for file descriptors, retries short writes */
+int _writeFd(void *ctx, const char *buf, int len)
+{
+    int fd = *(int *)ctx;
+
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        buf += n;
+        len -= (int)n;
+    }
+    return 0;
+}
+
+/*	Streams the list contents to a stdio stream, see exportList
+
+	param:	lst		pointer to the list
+	param:	mode	EXPORT_TEXT, EXPORT_CSV or EXPORT_BINARY
+	param:	fp		the destination stream
+	pre:	lst is not null, fp is not null
+	post:	no changes to the list
+	ret:	0 on success, -1 on a write error
+*/
+int exportListToFile(struct linkedList *lst, int mode, FILE *fp)
+{
+    assert(fp != 0);
+    return exportList(lst, mode, _writeFile, fp);
+}
+
+/*	Streams the list contents to a file descriptor, see exportList
+
+	param:	lst		pointer to the list
+	param:	mode	EXPORT_TEXT, EXPORT_CSV or EXPORT_BINARY
+	param:	fd		the destination file descriptor
+	pre:	lst is not null, fd is open for writing
+	post:	no changes to the list
+	ret:	0 on success, -1 on a write error
+*/
+int exportListToFd(struct linkedList *lst, int mode, int fd)
+{
+    return exportList(lst, mode, _writeFd, &fd);
+}
@@ -1,16 +1,32 @@
 #ifndef __LISTDEQUE_H
 #define __LISTDEQUE_H
 
+#include <stdio.h>
+
+/* Payload hooks, defined before including this header (and compiled
+   into linkedList.c with the same definitions). TYPE may be a struct:
+   KEY extracts the arithmetic key that EQ, LT and HASH look at by
+   default and that print and text export show. Searches and removes
+   match on EQ, so a struct is looked up with a probe holding its key. */
 # ifndef TYPE
 # define TYPE      int
 # define TYPE_SIZE sizeof(int)
 # endif
+
+# ifndef KEY
+# define KEY(A) (A)
+# endif
+
 # ifndef LT
-# define LT(A, B) ((A) < (B))
+# define LT(A, B) (KEY(A) < KEY(B))
 # endif
 
 # ifndef EQ
-# define EQ(A, B) ((A) == (B))
+# define EQ(A, B) (KEY(A) == KEY(B))
+# endif
+
+# ifndef HASH
+# define HASH(A) ((unsigned int)KEY(A))
 # endif
 
 struct linkedList;
@@ -35,5 +51,79 @@ void addList(struct linkedList *lst, TYPE v);
 int containsList(struct linkedList *lst, TYPE e);
 void removeList(struct linkedList *lst, TYPE e);
 
+/* Batch Bag Interface */
+int containsListBatch(struct linkedList *lst, TYPE *vals, int n, int *found);
+int removeListBatch(struct linkedList *lst, TYPE *vals, int n, int *removed);
+
+/* Parallel Bag Interface: the list is split into segments of about 4096
+   links through a skip table that adds and removes at either end keep
+   current, so no call walks the list before its threads start; threads <= 0
+   uses every CPU. The list must not be modified during a call. */
+int containsListParallel(struct linkedList *lst, TYPE e, int threads);
+int countListParallel(struct linkedList *lst, TYPE e, int threads);
+int findAllListParallel(struct linkedList *lst, TYPE e, int threads, int *positions, int max);
+
+/* Set Interface: adds of a value already present are ignored and
+   contains/remove take O(1) expected time through a hash index */
+struct linkedList *createLinkedSet();
+int setModeList(struct linkedList *lst);
+int isSetList(struct linkedList *lst);
+struct linkedList *unionList(struct linkedList *a, struct linkedList *b);
+struct linkedList *intersectList(struct linkedList *a, struct linkedList *b);
+struct linkedList *differenceList(struct linkedList *a, struct linkedList *b);
+
+/* Lazy Removal Interface: removes mark links dead, reads skip them and
+   a single sweep frees them once their share of the list passes the
+   ratio set by lazyRemoveList */
+void lazyRemoveList(struct linkedList *lst, double ratio);
+int deadCountList(struct linkedList *lst);
+int sweepList(struct linkedList *lst);
+
+/* Compaction Interface: relocate the links into contiguous memory in
+   list order, all at once or a bounded number per step */
+void compactList(struct linkedList *lst);
+int compactListStep(struct linkedList *lst, int maxNodes);
+
+/* Merge Interface: k-way merge of lists sorted by LT through a loser
+   tree, O(log k) per value. mergeLists moves the links onto the back of
+   out; a streaming merge reads the values without moving them. */
+struct listMerge;
+
+void mergeLists(struct linkedList *out, struct linkedList **lists, int k);
+struct listMerge *createListMerge(struct linkedList **lists, int k);
+int nextListMerge(struct listMerge *m, TYPE *val);
+void deleteListMerge(struct listMerge *m);
+
+/* Footprint Interface: bytes of stored values, of structure (links,
+   sentinels, allocator headers, indexes) and of space reserved but
+   unused; shrinkList returns what it can to the OS */
+struct memoryFootprint {
+    size_t payload;
+    size_t overhead;
+    size_t reserved;
+};
+
+void footprintList(struct linkedList *lst, struct memoryFootprint *f);
+size_t shrinkList(struct linkedList *lst);
+
+/* Trace Interface, built with -DTRACE_OPS and opTrace.c: records every
+   deque and bag call made on the list, see opTrace.h */
+# ifdef TRACE_OPS
+struct opTrace;
+void traceList(struct linkedList *lst, struct opTrace *t);
+# endif
+
+/* Export Interface */
+# define EXPORT_TEXT   0    /* one value per line */
+# define EXPORT_CSV    1    /* "index,value" header followed by one row per value */
+# define EXPORT_BINARY 2    /* raw TYPE values, front to back */
+
+/* Export sink, returns 0 on success and -1 on a write error */
+typedef int (*exportWriter)(void *ctx, const char *buf, int len);
+
+int exportList(struct linkedList *lst, int mode, exportWriter write, void *ctx);
+int exportListToFile(struct linkedList *lst, int mode, FILE *fp);
+int exportListToFd(struct linkedList *lst, int mode, int fd);
+
 #endif
 
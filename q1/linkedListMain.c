@@ -1,4 +1,5 @@
 #include "linkedList.h"
+#include "perfCounters.h"
 #include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
@@ -10,8 +11,13 @@ double getMilliseconds() {
 
 int main(int argc, char* argv[]) {
         struct linkedList *b;
-        int n, i;
-        double t1, t2;
+        struct perfCounters *p;
+        int n, i, e;
+        double t1, t2, visits;
+
+        p = createPerfCounters();
+        if (availablePerfCounters(p) == 0)
+                printf("Hardware counters unavailable, reporting time only\n");
 
         for(n=1000; n < 200000; n=n*2) /* outer loop */
         {
@@ -23,19 +29,32 @@ int main(int argc, char* argv[]) {
         }
 
         t1 = getMilliseconds();/*Time before contains()*/
+        startPerfCounters(p);
 
         for(i=0; i<n; i++) {
                 containsList(b, i);
         }
 
+        stopPerfCounters(p);
         t2 = getMilliseconds();/*Time after contains()*/
 
         printf("Time for running contains() on %d elements: %g ms\n", n, t2-t1);
 
+        /* every value is found once, after visiting 1, 2, ... n nodes */
+        visits = (double)n * (n + 1) / 2;
+        printf("        %.3f ns/node", (t2 - t1) * 1e6 / visits);
+        for(e = 0; e < PERF_EVENTS; e++) {
+                if (readPerfCounter(p, e) >= 0)
+                        printf("  %s %.4f/node", namePerfCounter(e), readPerfCounter(p, e) / visits);
+        }
+        if (readPerfCounter(p, PERF_CYCLES) > 0 && readPerfCounter(p, PERF_INSTRUCTIONS) >= 0)
+                printf("  IPC %.2f", (double)readPerfCounter(p, PERF_INSTRUCTIONS) / readPerfCounter(p, PERF_CYCLES));
+        printf("\n");
+
         /* delete DynArr */
         deleteLinkedList(b);
         }
+
+        deletePerfCounters(p);
         return 0;
 }
-
-
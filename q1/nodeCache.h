@@ -0,0 +1,39 @@
+#ifndef __NODECACHE_H
+#define __NODECACHE_H
+
+#include <stddef.h>
+
+/* Fixed size node allocator with per-thread free lists. Nodes are carved
+   from aligned slabs owned by the thread that created them; a node freed
+   by another thread is batched and handed back to its owner in one atomic
+   push, so alloc/free never touch a shared lock in the steady state. */
+struct nodePool;
+
+struct nodePool *createNodePool(size_t nodeSize);
+
+void *allocNode(struct nodePool *pool);
+void freeNode(struct nodePool *pool, void *node);
+
+/* hand any batched foreign frees of the calling thread back to their owners */
+void flushNodeCache();
+
+/* return the pages of entirely free slabs to the OS, see nodeCache.c;
+   returns the bytes released */
+size_t trimNodeCache();
+
+/* bytes of slab memory currently backed, in use or cached */
+size_t residentNodeCache();
+
+/* Huge page mode: while on, new slabs of every pool are carved from 2MB
+   arenas backed by huge pages where the system allows, see nodeCache.c.
+   Slabs carved before the switch keep their pages. */
+# define NODE_PAGES_REGULAR 0   /* 4KB pages */
+# define NODE_PAGES_HUGETLB 1   /* reserved huge pages, MAP_HUGETLB */
+# define NODE_PAGES_THP     2   /* transparent huge pages, MADV_HUGEPAGE */
+
+void hugePagesNodeCache(int on);
+
+/* backing of the most recently mapped arena, NODE_PAGES_REGULAR if none */
+int pageBackingNodeCache();
+
+#endif
@@ -0,0 +1,88 @@
+/* nodeCacheBench.c
+ * cross-thread node churn benchmark.
+ 
+ Description:   T threads are arranged in a ring, each with its own
+                concLinkedList inbox. Every thread pops from its inbox and
+                pushes the value on to the next thread's inbox, so every
+                node is allocated by one thread and freed by another.
+
+                Build once with and once without the node cache to compare:
+                  gcc -O2 -DNODE_CACHE nodeCacheBench.c concLinkedList.c nodeCache.c -lpthread
+                  gcc -O2 nodeCacheBench.c concLinkedList.c -lpthread
+**** */
+
+#include "concLinkedList.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+# define TOKENS_PER_THREAD 64
+# define HOPS_PER_THREAD   200000
+
+struct ringThread {
+    struct concLinkedList *inbox;
+    struct concLinkedList *outbox;
+};
+
+/*Function to get number of milliseconds of wall time*/
+double getMilliseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* Pass HOPS_PER_THREAD values from the inbox on to the outbox */
+void *passAlong(void *arg)
+{
+    struct ringThread *t = arg;
+    TYPE v;
+
+    for (int hops = 0; hops < HOPS_PER_THREAD; ) {
+        if (removeFrontConcList(t->inbox, &v)) {
+            addBackConcList(t->outbox, v);
+            hops++;
+        }
+        else
+            sched_yield();
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+# ifdef NODE_CACHE
+    printf("allocator: per-thread node cache\n");
+# else
+    printf("allocator: malloc\n");
+# endif
+
+    for (int n = 2; n <= 32; n *= 2) {
+        struct ringThread *ring = malloc(sizeof(struct ringThread) * n);
+        pthread_t *threads = malloc(sizeof(pthread_t) * n);
+
+        for (int i = 0; i < n; i++)
+            ring[i].inbox = createConcLinkedList();
+        for (int i = 0; i < n; i++) {
+            ring[i].outbox = ring[(i + 1) % n].inbox;
+            for (int j = 0; j < TOKENS_PER_THREAD; j++)
+                addBackConcList(ring[i].inbox, j);
+        }
+
+        double t1 = getMilliseconds();
+        for (int i = 0; i < n; i++)
+            pthread_create(&threads[i], 0, passAlong, &ring[i]);
+        for (int i = 0; i < n; i++)
+            pthread_join(threads[i], 0);
+        double t2 = getMilliseconds();
+
+        double hops = (double)n * HOPS_PER_THREAD;
+        printf("%2d threads: %8.1f ms, %6.2f Mhops/s\n", n, t2 - t1, hops / (t2 - t1) / 1000.0);
+
+        for (int i = 0; i < n; i++)
+            deleteConcLinkedList(ring[i].inbox);
+        free(ring);
+        free(threads);
+    }
+    return 0;
+}
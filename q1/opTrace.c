@@ -0,0 +1,183 @@
+/* opTrace.c
+ * operation trace implementation file.
+ 
+ Description:   Records are appended through a stdio stream with a large
+                buffer, so recording costs a few stores per call and one
+                write per TRACE_BUFFER bytes. Only the ops that take a value
+                store one; removes and reads are a single byte.
+**** */
+
+#include "opTrace.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+# define TRACE_BUFFER  (1 << 20)
+# define TRACE_VERSION 1
+
+static const char _traceMagic[4] = {'O', 'P', 'T', 'R'};
+
+static const char *_traceNames[TRACE_OP_COUNT] = {
+    "?", "addFront", "addBack", "front", "back", "removeFront",
+    "removeBack", "add", "contains", "remove"
+};
+
+struct opTrace {
+    FILE *fp;
+    char *buffer;
+};
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+/* 1 if records of op carry a value */
+static int _hasValue(int op)
+{
+    return op == TRACE_ADD_FRONT || op == TRACE_ADD_BACK || op == TRACE_ADD
+        || op == TRACE_CONTAINS || op == TRACE_REMOVE;
+}
+
+/*
+	openOpTrace
+	param: path file to create or truncate
+	pre: path is not null
+	post: the header is written
+	ret: the trace, or null if path cannot be opened
+*/
+struct opTrace *openOpTrace(const char *path)
+{
+    if (path == 0)
+        _gracefulExit("Passed null path to openOpTrace", 1);
+
+    FILE *fp = fopen(path, "wb");
+    if (fp == 0)
+        return 0;
+
+    struct opTrace *t = malloc(sizeof(struct opTrace));
+    assert(t != 0);
+    t->fp = fp;
+    t->buffer = malloc(TRACE_BUFFER);
+    assert(t->buffer != 0);
+    setvbuf(fp, t->buffer, _IOFBF, TRACE_BUFFER);
+
+    unsigned int version = TRACE_VERSION;
+    fwrite(_traceMagic, 1, 4, fp);
+    fwrite(&version, 4, 1, fp);
+    return t;
+}
+
+/*
+	recordOpTrace
+	param: t the trace
+	param: op one of the TRACE_* ops
+	param: value the call's value, ignored for ops without one
+	pre: t is not null
+	post: one record is appended
+*/
+void recordOpTrace(struct opTrace *t, int op, double value)
+{
+    if (t == 0)
+        _gracefulExit("Passed null opTrace ptr to recordOpTrace", 2);
+
+    assert(op > 0 && op < TRACE_OP_COUNT);
+
+    putc(op, t->fp);
+    if (_hasValue(op))
+        fwrite(&value, sizeof(double), 1, t->fp);
+}
+
+/*
+	closeOpTrace
+	param: t the trace
+	pre: t is not null
+	post: the records are flushed and t is freed
+	ret: 0, or -1 if any write failed
+*/
+int closeOpTrace(struct opTrace *t)
+{
+    if (t == 0)
+        _gracefulExit("Passed null opTrace ptr to closeOpTrace", 3);
+
+    int rc = ferror(t->fp) ? -1 : 0;
+    if (fclose(t->fp) != 0)
+        rc = -1;
+    free(t->buffer);
+    free(t);
+    return rc;
+}
+
+/*
+	loadOpTrace
+	param: path the trace file
+	param: ops output, a malloc'd array of the records
+	pre: path and ops are not null
+	post: *ops is owned by the caller; a torn last record is dropped
+	ret: number of records, or -1 if path is missing or not a trace
+*/
+int loadOpTrace(const char *path, struct traceOp **ops)
+{
+    if (path == 0 || ops == 0)
+        _gracefulExit("Passed null argument to loadOpTrace", 4);
+
+    FILE *fp = fopen(path, "rb");
+    if (fp == 0)
+        return -1;
+
+    char magic[4];
+    unsigned int version = 0;
+    if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, _traceMagic, 4) != 0
+        || fread(&version, 4, 1, fp) != 1 || version != TRACE_VERSION) {
+        fclose(fp);
+        return -1;
+    }
+
+    int n = 0, cap = 1024, op;
+    *ops = malloc(sizeof(struct traceOp) * cap);
+    assert(*ops != 0);
+
+    while ((op = getc(fp)) != EOF) {
+        double value = 0;
+
+        if (op <= 0 || op >= TRACE_OP_COUNT)
+            break;
+        if (_hasValue(op) && fread(&value, sizeof(double), 1, fp) != 1)
+            break;
+
+        if (n == cap) {
+            cap *= 2;
+            *ops = realloc(*ops, sizeof(struct traceOp) * cap);
+            assert(*ops != 0);
+        }
+        (*ops)[n].op = op;
+        (*ops)[n].value = value;
+        n++;
+    }
+
+    fclose(fp);
+    return n;
+}
+
+/*
+	nameOpTrace
+	param: op one of the TRACE_* ops
+	ret: the API call the op stands for
+*/
+const char *nameOpTrace(int op)
+{
+    assert(op >= 0 && op < TRACE_OP_COUNT);
+    return _traceNames[op];
+}
@@ -0,0 +1,39 @@
+#ifndef __OPTRACE_H
+#define __OPTRACE_H
+
+/* Compact binary trace of container API calls. A trace starts with the
+   magic "OPTR" and a 4 byte version, then holds one record per call: an
+   op byte, followed by the value as an 8 byte double for ops that take one. */
+struct opTrace;
+
+/* traced operations */
+# define TRACE_ADD_FRONT     1
+# define TRACE_ADD_BACK      2
+# define TRACE_FRONT         3
+# define TRACE_BACK          4
+# define TRACE_REMOVE_FRONT  5
+# define TRACE_REMOVE_BACK   6
+# define TRACE_ADD           7
+# define TRACE_CONTAINS      8
+# define TRACE_REMOVE        9
+# define TRACE_OP_COUNT     10  /* one past the last op */
+
+/* a decoded record */
+struct traceOp {
+    int op;
+    double value;
+};
+
+/* returns null if path cannot be created */
+struct opTrace *openOpTrace(const char *path);
+void recordOpTrace(struct opTrace *t, int op, double value);
+
+/* flushes and closes, returns 0 or -1 on a write error */
+int  closeOpTrace(struct opTrace *t);
+
+/* reads a whole trace into a malloc'd array, returns its length or -1 */
+int  loadOpTrace(const char *path, struct traceOp **ops);
+
+const char *nameOpTrace(int op);
+
+#endif
@@ -0,0 +1,221 @@
+/* perfCounters.c
+ * hardware event counter implementation file.
+ 
+ Description:   Opens one perf_event_open counter per event for the calling
+                thread, user space only, each disabled until
+                startPerfCounters. Events are opened one by one rather than
+                as a group so a CPU or VM missing one of them still reports
+                the rest. When the kernel has more events than hardware
+                counters it time-slices them; reads are scaled by
+                time enabled over time running to estimate the full count.
+                On systems without perf_event_open, or when
+                kernel.perf_event_paranoid forbids it, every event is simply
+                unavailable.
+**** */
+
+#include "perfCounters.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+struct perfCounters {
+    int fds[PERF_EVENTS];           /* -1 when the event is unavailable */
+    long long counts[PERF_EVENTS];  /* scaled counts of the last start/stop */
+};
+
+static const char *_names[PERF_EVENTS] = {
+    "cycles", "instructions", "L1d-misses", "LLC-misses", "dTLB-misses", "branch-misses"
+};
+
+/* Prints custom error message and exits w/ custom error code
+ 
+	param: 	message     c str - error message
+	param: 	errorCode	integer error code
+	pre:	message is not null
+	post:	program has exited
+*/
+static void _gracefulExit(char *message, int errorCode) {
+    
+    //pre-conditions
+    assert(message != 0);
+    
+    printf("Error: %s\nGoodbye.\n", message);
+    exit(errorCode);
+}
+
+#ifdef __linux__
+/* Open one counter for the calling thread on any CPU, or return -1 */
+static int _openEvent(unsigned int type, unsigned long long config)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/* config of a read miss in one of the generic cache events */
+# define CACHE_READ_MISS(C) \
+    ((C) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+#endif
+
+/*
+	createPerfCounters
+	param: none
+	pre: none
+	post: every event the system supports is open and stopped
+	ret: the counters, possibly with none available
+*/
+struct perfCounters *createPerfCounters()
+{
+    struct perfCounters *p = malloc(sizeof(struct perfCounters));
+    assert(p != 0);
+
+    for (int i = 0; i < PERF_EVENTS; i++) {
+        p->fds[i] = -1;
+        p->counts[i] = -1;
+    }
+
+#ifdef __linux__
+    p->fds[PERF_CYCLES] = _openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    p->fds[PERF_INSTRUCTIONS] = _openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    p->fds[PERF_L1D_MISSES] = _openEvent(PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D));
+    p->fds[PERF_LLC_MISSES] = _openEvent(PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL));
+    p->fds[PERF_DTLB_MISSES] = _openEvent(PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB));
+    p->fds[PERF_BRANCH_MISSES] = _openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+
+    return p;
+}
+
+/*
+	deletePerfCounters
+	param: p the counters
+	pre: p is not null
+	post: every counter is closed and p is freed
+*/
+void deletePerfCounters(struct perfCounters *p)
+{
+    if (p == 0)
+        _gracefulExit("Passed null perfCounters ptr to deletePerfCounters", 1);
+
+#ifdef __linux__
+    for (int i = 0; i < PERF_EVENTS; i++)
+        if (p->fds[i] >= 0)
+            close(p->fds[i]);
+#endif
+    free(p);
+}
+
+/*
+	availablePerfCounters
+	param: p the counters
+	pre: p is not null
+	ret: the number of events that opened
+*/
+int availablePerfCounters(struct perfCounters *p)
+{
+    if (p == 0)
+        _gracefulExit("Passed null perfCounters ptr to availablePerfCounters", 2);
+
+    int n = 0;
+    for (int i = 0; i < PERF_EVENTS; i++)
+        n += p->fds[i] >= 0;
+    return n;
+}
+
+/*
+	startPerfCounters
+	param: p the counters
+	pre: p is not null
+	post: every available counter is zeroed and counting
+*/
+void startPerfCounters(struct perfCounters *p)
+{
+    if (p == 0)
+        _gracefulExit("Passed null perfCounters ptr to startPerfCounters", 3);
+
+#ifdef __linux__
+    for (int i = 0; i < PERF_EVENTS; i++)
+        if (p->fds[i] >= 0)
+            ioctl(p->fds[i], PERF_EVENT_IOC_RESET, 0);
+    for (int i = 0; i < PERF_EVENTS; i++)
+        if (p->fds[i] >= 0)
+            ioctl(p->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+/*
+	stopPerfCounters
+	param: p the counters
+	pre: p is not null
+	post: every available counter is stopped and its count saved
+*/
+void stopPerfCounters(struct perfCounters *p)
+{
+    if (p == 0)
+        _gracefulExit("Passed null perfCounters ptr to stopPerfCounters", 4);
+
+#ifdef __linux__
+    for (int i = 0; i < PERF_EVENTS; i++)
+        if (p->fds[i] >= 0)
+            ioctl(p->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+    for (int i = 0; i < PERF_EVENTS; i++) {
+        unsigned long long v[3];   //value, time enabled, time running
+
+        p->counts[i] = -1;
+        if (p->fds[i] < 0 || read(p->fds[i], v, sizeof(v)) != sizeof(v))
+            continue;
+
+        if (v[2] == 0)
+            p->counts[i] = 0;      //never scheduled onto a hardware counter
+        else if (v[2] < v[1])
+            p->counts[i] = (long long)((double)v[0] * v[1] / v[2]);
+        else
+            p->counts[i] = (long long)v[0];
+    }
+#endif
+}
+
+/*
+	readPerfCounter
+	param: p the counters
+	param: event one of the PERF_* events
+	pre: p is not null, stopPerfCounters has been called
+	ret: the count, or -1 if the event is unavailable
+*/
+long long readPerfCounter(struct perfCounters *p, int event)
+{
+    if (p == 0)
+        _gracefulExit("Passed null perfCounters ptr to readPerfCounter", 5);
+
+    assert(event >= 0 && event < PERF_EVENTS);
+    return p->counts[event];
+}
+
+/*
+	namePerfCounter
+	param: event one of the PERF_* events
+	ret: the event name as perf(1) prints it
+*/
+const char *namePerfCounter(int event)
+{
+    assert(event >= 0 && event < PERF_EVENTS);
+    return _names[event];
+}
@@ -0,0 +1,34 @@
+#ifndef __PERFCOUNTERS_H
+#define __PERFCOUNTERS_H
+
+/* Hardware event counters for the calling thread, read through
+   perf_event_open. Counters the kernel or CPU cannot provide are reported
+   as unavailable instead of failing. */
+struct perfCounters;
+
+/* events */
+# define PERF_CYCLES        0
+# define PERF_INSTRUCTIONS  1
+# define PERF_L1D_MISSES    2
+# define PERF_LLC_MISSES    3
+# define PERF_DTLB_MISSES   4
+# define PERF_BRANCH_MISSES 5
+# define PERF_EVENTS        6
+
+struct perfCounters *createPerfCounters();
+void deletePerfCounters(struct perfCounters *p);
+
+/* number of events that could be opened */
+int  availablePerfCounters(struct perfCounters *p);
+
+/* zero and start, or stop, every available counter */
+void startPerfCounters(struct perfCounters *p);
+void stopPerfCounters(struct perfCounters *p);
+
+/* count between the last start and stop, scaled up when the kernel
+   multiplexed the counter; -1 if the event is unavailable */
+long long readPerfCounter(struct perfCounters *p, int event);
+
+const char *namePerfCounter(int event);
+
+#endif
@@ -0,0 +1,138 @@
+/* testCompList.c
+ * compList testing file.
+ 
+ Description:   Tests the compressed integer list against a plain array
+                and reports its footprint next to a linkedList
+                uses assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "compList.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+# define IDS 100000
+# define OPS 50000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+    pre:	predicate is a boolean encoded int
+	post:	none
+ */
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Creating compressed list...\n");
+    struct compList *c = createCompList();
+    assertTrue(isEmptyCompList(c), "isEmptyCompList == true");
+
+    printf("\nAdding increasing IDs with small gaps...\n");
+    int id = 1000, ok = 1;
+    for (int i = 0; i < IDS; i++) {
+        id += 1 + i % 7;
+        addCompList(c, id);
+    }
+    assertTrue(sizeCompList(c) == IDS, "sizeCompList == IDS");
+    assertTrue(frontCompList(c) == 1001, "frontCompList == 1001");
+    assertTrue(backCompList(c) == id, "backCompList == last ID");
+    assertTrue(containsCompList(c, 1001 + 2), "containsCompList(1003)");
+    assertTrue(!containsCompList(c, 1001 + 1), "!containsCompList(1002)");
+    assertTrue(!containsCompList(c, id + 1), "!containsCompList(past the back)");
+
+    //a linkedList node is a value plus next and prev pointers
+    long plain = (long)IDS * (sizeof(int) + 2 * sizeof(void *));
+    printf("compressed: %ld bytes, linkedList nodes: %ld bytes (%.2f bytes/value)\n",
+           memoryCompList(c), plain, (double)memoryCompList(c) / IDS);
+    assertTrue(memoryCompList(c) * 8 < plain, "compressed is under 1/8 of the node footprint");
+
+    printf("\nDraining from the front...\n");
+    id = 1000;
+    for (int i = 0; i < IDS && ok; i++) {
+        id += 1 + i % 7;
+        ok = frontCompList(c) == id;
+        removeFrontCompList(c);
+    }
+    assertTrue(ok && isEmptyCompList(c), "front drain is in order");
+    deleteCompList(c);
+
+    printf("\nRandom deque and bag ops against an array...\n");
+    c = createCompList();
+    int *ref = malloc(sizeof(int) * 2 * OPS);
+    int lo = OPS, hi = OPS;     //ref[lo .. hi-1]
+    srand(7);
+    for (int i = 0; i < OPS && ok; i++) {
+        int r = rand() % 10, v = rand() % 5000 - 2500;
+
+        if (r < 3) {
+            addBackCompList(c, v);
+            ref[hi++] = v;
+        }
+        else if (r < 6) {
+            addFrontCompList(c, v);
+            ref[--lo] = v;
+        }
+        else if (r == 6 && hi > lo) {
+            removeFrontCompList(c);
+            lo++;
+        }
+        else if (r == 7 && hi > lo) {
+            removeBackCompList(c);
+            hi--;
+        }
+        else if (r == 8) {
+            int j = lo;
+            while (j < hi && ref[j] != v)
+                j++;
+            ok = containsCompList(c, v) == (j < hi);
+        }
+        else {
+            int j = lo;
+            while (j < hi && ref[j] != v)
+                j++;
+            ok = removeCompList(c, v) == (j < hi);
+            if (j < hi) {
+                memmove(ref + j, ref + j + 1, sizeof(int) * (hi - j - 1));
+                hi--;
+            }
+        }
+
+        ok = ok && sizeCompList(c) == hi - lo;
+        if (ok && hi > lo)
+            ok = frontCompList(c) == ref[lo] && backCompList(c) == ref[hi - 1];
+    }
+    assertTrue(ok, "random ops match the array");
+
+    while (ok && hi > lo) {
+        ok = backCompList(c) == ref[hi - 1];
+        removeBackCompList(c);
+        hi--;
+    }
+    assertTrue(ok && isEmptyCompList(c), "back drain matches the array");
+
+    printf("\nExtreme deltas...\n");
+    addBackCompList(c, 0x7fffffff);
+    for (int i = 0; i < 300; i++)
+        addBackCompList(c, (i & 1) ? 0x7fffffff : (int)0x80000000);
+    ok = 1;
+    for (int i = 0; i < 301 && ok; i++) {
+        ok = frontCompList(c) == ((i & 1) ? (int)0x80000000 : 0x7fffffff);
+        removeFrontCompList(c);
+    }
+    assertTrue(ok, "INT_MIN/INT_MAX alternate round trip");
+
+    free(ref);
+    deleteCompList(c);
+    return 0;
+}
@@ -0,0 +1,126 @@
+/* testConcLinkedList.c
+ * concLinkedList testing file.
+ 
+ Description:   Tests the two-lock concurrent deque, first single threaded
+                then with producers and consumers on opposite ends
+                uses assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "concLinkedList.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+# define ITEMS 200000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+    pre:	predicate is a boolean encoded int
+	post:	none
+ */
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+struct worker {
+    struct concLinkedList *l;
+    int front;          /* which end this worker uses */
+    long long sum;      /* sum of the values consumed */
+    int ordered;        /* 1 while values arrive in production order */
+};
+
+/* Adds 0 .. ITEMS-1 at one end */
+void *producer(void *arg)
+{
+    struct worker *w = arg;
+    for (int i = 0; i < ITEMS; i++) {
+        if (w->front)
+            addFrontConcList(w->l, i);
+        else
+            addBackConcList(w->l, i);
+    }
+    return 0;
+}
+
+/* Removes ITEMS values from one end, checking they arrive in order */
+void *consumer(void *arg)
+{
+    struct worker *w = arg;
+    TYPE v;
+    int expected = 0;
+
+    w->sum = 0;
+    w->ordered = 1;
+    while (expected < ITEMS) {
+        int got = w->front ? removeFrontConcList(w->l, &v)
+                           : removeBackConcList(w->l, &v);
+        if (!got)
+            continue;
+        if (v != expected)
+            w->ordered = 0;
+        w->sum += v;
+        expected++;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Creating concurrent linked list...\n");
+    struct concLinkedList *l = createConcLinkedList();
+    TYPE v;
+
+    assertTrue(isEmptyConcList(l), "isEmptyConcList == true");
+    assertTrue(!removeFrontConcList(l, &v) && !removeBackConcList(l, &v),
+               "removing from an empty list returns 0");
+
+    printf("\nAdding 1, 2 to the back and 0 to the front...\n");
+    addBackConcList(l, 1);
+    addBackConcList(l, 2);
+    addFrontConcList(l, 0);
+    assertTrue(sizeConcList(l) == 3, "sizeConcList(l) == 3");
+    assertTrue(frontConcList(l, &v) && v == 0, "frontConcList(l) == 0");
+    assertTrue(backConcList(l, &v) && v == 2, "backConcList(l) == 2");
+    assertTrue(removeBackConcList(l, &v) && v == 2, "removeBackConcList(l) == 2");
+    assertTrue(removeFrontConcList(l, &v) && v == 0, "removeFrontConcList(l) == 0");
+    assertTrue(removeFrontConcList(l, &v) && v == 1, "removeFrontConcList(l) == 1");
+    assertTrue(isEmptyConcList(l), "isEmptyConcList == true");
+
+    printf("\nOne producer at the back, one consumer at the front, %d items...\n", ITEMS);
+    struct worker p = {l, 0, 0, 0}, c = {l, 1, 0, 0};
+    pthread_t pt, ct;
+    pthread_create(&pt, 0, producer, &p);
+    pthread_create(&ct, 0, consumer, &c);
+    pthread_join(pt, 0);
+    pthread_join(ct, 0);
+    assertTrue(c.ordered, "values dequeued in FIFO order");
+    assertTrue(c.sum == (long long)ITEMS * (ITEMS - 1) / 2, "sum of dequeued values matches");
+    assertTrue(isEmptyConcList(l), "isEmptyConcList == true");
+
+    printf("\nProducers and consumers on both ends at once...\n");
+    struct worker p1 = {l, 0, 0, 0}, c1 = {l, 1, 0, 0};
+    struct worker p2 = {l, 1, 0, 0}, c2 = {l, 0, 0, 0};
+    pthread_t t[4];
+    pthread_create(&t[0], 0, producer, &p1);
+    pthread_create(&t[1], 0, consumer, &c1);
+    pthread_create(&t[2], 0, producer, &p2);
+    pthread_create(&t[3], 0, consumer, &c2);
+    for (int i = 0; i < 4; i++)
+        pthread_join(t[i], 0);
+    assertTrue(c1.sum + c2.sum == (long long)ITEMS * (ITEMS - 1),
+               "every value added was removed exactly once");
+    assertTrue(isEmptyConcList(l), "isEmptyConcList == true");
+
+    deleteConcLinkedList(l);
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+/* testIndexedList.c
+ * indexedList testing file.
+ 
+ Description:   Tests positional and deque access of the indexed sequence
+                against a plain array
+                uses assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "indexedList.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+# define OPS 20000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+    pre:	predicate is a boolean encoded int
+	post:	none
+ */
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Creating indexed list...\n");
+    struct indexedList *l = createIndexedList();
+    assertTrue(isEmptyIndexedList(l), "isEmptyIndexedList == true");
+
+    printf("\nAdding integers 0 - 999 to back, then -1 to front...\n");
+    for (int i = 0; i < 1000; i++)
+        addBackIndexedList(l, i);
+    addFrontIndexedList(l, -1);
+    assertTrue(sizeIndexedList(l) == 1001, "sizeIndexedList(l) == 1001");
+    assertTrue(frontIndexedList(l) == -1 && backIndexedList(l) == 999,
+               "frontIndexedList(l) == -1, backIndexedList(l) == 999");
+    assertTrue(getAtIndexedList(l, 501) == 500, "getAtIndexedList(l, 501) == 500");
+
+    insertAtIndexedList(l, 501, 12345);
+    assertTrue(getAtIndexedList(l, 501) == 12345 && getAtIndexedList(l, 502) == 500,
+               "insertAtIndexedList(l, 501, 12345) shifts 500 to 502");
+    removeAtIndexedList(l, 501);
+    setAtIndexedList(l, 0, 7);
+    assertTrue(getAtIndexedList(l, 501) == 500 && frontIndexedList(l) == 7,
+               "removeAtIndexedList and setAtIndexedList");
+
+    TYPE page[10];
+    int n = readRangeIndexedList(l, 995, 10, page);
+    assertTrue(n == 6 && page[0] == 994 && page[5] == 999,
+               "readRangeIndexedList(l, 995, 10) reads the last 6 values");
+
+    removeFrontIndexedList(l);
+    removeBackIndexedList(l);
+    assertTrue(frontIndexedList(l) == 0 && backIndexedList(l) == 998,
+               "removeFront/removeBack leave 0 - 998");
+    while (!isEmptyIndexedList(l))
+        removeBackIndexedList(l);
+    assertTrue(sizeIndexedList(l) == 0, "sizeIndexedList(l) == 0 after removing all");
+
+    printf("\nRunning %d random positional operations against an array...\n", OPS);
+    TYPE *ref = malloc(sizeof(TYPE) * OPS), *out = malloc(sizeof(TYPE) * OPS);
+    int size = 0, ok = 1;
+    srand(261);
+    for (int i = 0; i < OPS; i++) {
+        int op = rand() % 4, at = size ? rand() % size : 0;
+        if (op < 2 || size == 0) {
+            at = rand() % (size + 1);
+            insertAtIndexedList(l, at, i);
+            memmove(ref + at + 1, ref + at, sizeof(TYPE) * (size - at));
+            ref[at] = i;
+            size++;
+        }
+        else if (op == 2) {
+            removeAtIndexedList(l, at);
+            memmove(ref + at, ref + at + 1, sizeof(TYPE) * (size - at - 1));
+            size--;
+        }
+        else {
+            setAtIndexedList(l, at, -i);
+            ref[at] = -i;
+        }
+        if (size > 0 && getAtIndexedList(l, at < size ? at : size - 1) != ref[at < size ? at : size - 1])
+            ok = 0;
+    }
+    assertTrue(ok && sizeIndexedList(l) == size, "every read matched the array");
+    assertTrue(readRangeIndexedList(l, 0, size, out) == size
+               && memcmp(out, ref, sizeof(TYPE) * size) == 0,
+               "readRangeIndexedList over everything matches the array");
+
+    free(ref);
+    free(out);
+    deleteIndexedList(l);
+
+    return 0;
+}
@@ -10,6 +10,12 @@
 #include "linkedList.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+# ifdef TRACE_OPS
+#include "opTrace.h"
+# endif
 
 /*	Testing function, takes predicate, and message and prints the message
     and if the test passed or failed, ie if the predicate expression evaluated
@@ -29,6 +35,43 @@ void assertTrue(int predicate, char *message)
         printf("FAILED\n");
 }
 
+/*	exportWriter that appends the exported bytes to a fixed size capture
+    buffer, used to check the output of exportList()
+	param: 	ctx pointer to the capture buffer
+	param: 	buf bytes to append
+	param: 	len number of bytes
+	pre:	the capture buffer has room for len more bytes
+	post:	buf is appended to the capture buffer
+ */
+struct capture { char data[256]; int len; };
+int captureWriter(void *ctx, const char *buf, int len)
+{
+    struct capture *c = ctx;
+    memcpy(c->data + c->len, buf, len);
+    c->len += len;
+    c->data[c->len] = '\0';
+    return 0;
+}
+
+/*	Returns 1 if the list holds exactly vals[0 .. n-1] front to back,
+	checked through exportList so the list is left untouched
+ */
+struct expect { const char *data; int len; int at; int same; };
+int expectWriter(void *ctx, const char *buf, int len)
+{
+    struct expect *e = ctx;
+    if (e->at + len > e->len || memcmp(e->data + e->at, buf, len) != 0)
+        e->same = 0;
+    e->at += len;
+    return 0;
+}
+int sameContents(struct linkedList *l, TYPE *vals, int n)
+{
+    struct expect e = { (const char *)vals, n * (int)sizeof(TYPE), 0, 1 };
+    exportList(l, EXPORT_BINARY, expectWriter, &e);
+    return e.same && e.at == e.len;
+}
+
 int main(int argc, char* argv[]) {
     
     
@@ -139,9 +182,462 @@ int main(int argc, char* argv[]) {
     removeList(l, 5);
     printList(l);
     
+
+
+    printf("\nNow testing containsListBatch() and removeListBatch()\n");
+    printf("Adding integers 0 - 99 to back of list...\n");
+    for (int i = 0; i < 100; i++) {
+        addBackList(l, i);
+    }
+    TYPE queries[6] = {4, 50, 57, 1000, 99, 4};
+    int results[6];
+    assertTrue(containsListBatch(l, queries, 6, results) == 5,
+               "containsListBatch(l, {4, 50, 57, 1000, 99, 4}) == 5");
+    assertTrue(results[0] && results[1] && results[2] && !results[3]
+               && results[4] && results[5], "found == {1, 1, 1, 0, 1, 1}");
+
+    printf("The list holds 4 twice, so both 4's in the batch are removed.\n");
+    assertTrue(removeListBatch(l, queries, 6, results) == 5,
+               "removeListBatch(l, {4, 50, 57, 1000, 99, 4}) == 5");
+    assertTrue(results[0] && results[1] && results[2] && !results[3]
+               && results[4] && results[5], "removed == {1, 1, 1, 0, 1, 1}");
+    assertTrue(!containsList(l, 4) && !containsList(l, 50),
+               "containsList(l, 4) == false, containsList(l, 50) == false");
+    assertTrue(removeListBatch(l, queries, 6, results) == 0,
+               "removeListBatch() again removes nothing");
+    assertTrue(frontList(l) == 2 && backList(l) == 98,
+               "frontList(l) == 2, backList(l) == 98");
+
     deleteLinkedList(l);
 
-    return 0;
-}
+    printf("Querying 20000 multiples of 65536, every other one in the list...\n");
+    l = createLinkedList();
+    TYPE *strided = malloc(sizeof(TYPE) * 20000);
+    int *hits = malloc(sizeof(int) * 20000);
+    for (int i = 0; i < 20000; i++) {
+        strided[i] = i * 65536;
+        if (i % 2 == 0)
+            addBackList(l, strided[i]);
+    }
+    int ok = containsListBatch(l, strided, 20000, hits) == 10000;
+    for (int i = 0; i < 20000 && ok; i++)
+        ok = hits[i] == (i % 2 == 0);
+    assertTrue(ok, "containsListBatch hashes keys that differ only in high bits");
+    free(strided);
+    free(hits);
+    deleteLinkedList(l);
+
+
+    printf("\nNow testing exportList()\n");
+    printf("Creating list -12, 0, 7, 2147483647 using addBackList()...\n");
+    l = createLinkedList();
+    struct capture c;
+
+    c.len = 0;
+    assertTrue(exportList(l, EXPORT_CSV, captureWriter, &c) == 0
+               && strcmp(c.data, "index,value\n") == 0,
+               "exportList(empty, EXPORT_CSV) == header only");
+    addBackList(l, -12);
+    addBackList(l, 0);
+    addBackList(l, 7);
+    addBackList(l, 2147483647);
+
+    c.len = 0;
+    exportList(l, EXPORT_TEXT, captureWriter, &c);
+    assertTrue(strcmp(c.data, "-12\n0\n7\n2147483647\n") == 0,
+               "exportList(l, EXPORT_TEXT) == \"-12\\n0\\n7\\n2147483647\\n\"");
+    c.len = 0;
+    exportList(l, EXPORT_CSV, captureWriter, &c);
+    assertTrue(strcmp(c.data, "index,value\n0,-12\n1,0\n2,7\n3,2147483647\n") == 0,
+               "exportList(l, EXPORT_CSV) has one row per value");
+    c.len = 0;
+    exportList(l, EXPORT_BINARY, captureWriter, &c);
+    assertTrue(c.len == 4 * sizeof(TYPE) && ((TYPE *)c.data)[3] == 2147483647,
+               "exportList(l, EXPORT_BINARY) == raw values");
+
+    deleteLinkedList(l);
+
+
+    printf("\nNow testing set mode\n");
+    printf("Adding 0 - 9999 twice to a set...\n");
+    l = createLinkedSet();
+    for (int r = 0; r < 2; r++)
+        for (int i = 0; i < 10000; i++)
+            addList(l, i);
+    assertTrue(isSetList(l), "isSetList(l) == true");
+    assertTrue(frontList(l) == 9999 && backList(l) == 0,
+               "duplicates are ignored, frontList(l) == 9999, backList(l) == 0");
+    addBackList(l, 5);
+    addFrontList(l, 7);
+    assertTrue(frontList(l) == 9999 && backList(l) == 0,
+               "addFrontList/addBackList of present values are ignored");
+    ok = 1;
+    for (int i = 0; i < 10000; i += 2)
+        removeList(l, i);
+    for (int i = 0; i < 10000; i++)
+        ok = ok && containsList(l, i) == (i % 2);
+    assertTrue(ok, "even values removed through the index");
+    assertTrue(!containsList(l, -1) && !containsList(l, 10000),
+               "containsList(l, -1) == false, containsList(l, 10000) == false");
+    addList(l, 4);
+    assertTrue(frontList(l) == 4, "a removed value can be added again");
+    removeFrontList(l);
+    removeBackList(l);
+    assertTrue(!containsList(l, 4) && !containsList(l, 1) && containsList(l, 3),
+               "removeFrontList/removeBackList keep the index in step");
+
+    printf("Switching a bag holding 3, 1, 3, 2, 1 to set mode...\n");
+    struct linkedList *a = createLinkedList();
+    addBackList(a, 3);
+    addBackList(a, 1);
+    addBackList(a, 3);
+    addBackList(a, 2);
+    addBackList(a, 1);
+    assertTrue(setModeList(a) == 2, "setModeList(a) == 2 duplicates removed");
+    c.len = 0;
+    exportList(a, EXPORT_TEXT, captureWriter, &c);
+    assertTrue(strcmp(c.data, "3\n1\n2\n") == 0, "first occurrences kept, a == {3, 1, 2}");
+
+    printf("b == {2, 3, 4, 5}...\n");
+    struct linkedList *b = createLinkedSet();
+    for (int i = 2; i <= 5; i++)
+        addBackList(b, i);
+
+    struct linkedList *u = unionList(a, b);
+    c.len = 0;
+    exportList(u, EXPORT_TEXT, captureWriter, &c);
+    assertTrue(strcmp(c.data, "3\n1\n2\n4\n5\n") == 0, "unionList(a, b) == {3, 1, 2, 4, 5}");
+    addList(u, 4);
+    assertTrue(isSetList(u) && frontList(u) == 3, "the union is a set");
+
+    struct linkedList *n = intersectList(a, b);
+    c.len = 0;
+    exportList(n, EXPORT_TEXT, captureWriter, &c);
+    assertTrue(strcmp(c.data, "3\n2\n") == 0, "intersectList(a, b) == {3, 2}");
+
+    struct linkedList *d = differenceList(a, b);
+    c.len = 0;
+    exportList(d, EXPORT_TEXT, captureWriter, &c);
+    assertTrue(strcmp(c.data, "1\n") == 0, "differenceList(a, b) == {1}");
+
+    deleteLinkedList(u);
+    deleteLinkedList(n);
+    deleteLinkedList(d);
+    deleteLinkedList(a);
+    deleteLinkedList(b);
+    deleteLinkedList(l);
+
+    printf("\nNow testing compactList() and compactListStep()\n");
+    printf("Scattering 0 - 2999 with interleaved removes...\n");
+    l = createLinkedList();
+    int *ref = malloc(sizeof(int) * 3000), refLen = 0;
+    for (int i = 0; i < 3000; i++) {
+        addBackList(l, i);
+        ref[refLen++] = i;
+        if (i % 3 == 2) {
+            removeList(l, i - 1);
+            memmove(ref + refLen - 2, ref + refLen - 1, sizeof(int));
+            refLen--;
+        }
+    }
+    compactList(l);
+    assertTrue(sameContents(l, ref, refLen), "compactList keeps the contents and order");
+
+    printf("Stepping 7 links at a time while adding and removing...\n");
+    int steps = 0;
+    while (compactListStep(l, 7)) {
+        steps++;
+        removeFrontList(l);             //may be a link the pass already moved
+        memmove(ref, ref + 1, sizeof(int) * --refLen);
+        removeBackList(l);              //one the pass has not reached yet
+        refLen--;
+        addBackList(l, 5000 + steps);   //added behind the pass
+        ref[refLen++] = 5000 + steps;
+    }
+    assertTrue(steps > 0 && sameContents(l, ref, refLen),
+               "compactListStep keeps the contents while the list changes");
+
+    printf("Removing the link the pass stopped at...\n");
+    compactListStep(l, 5);
+    for (int i = 0; i < 6; i++)
+        removeFrontList(l);
+    while (compactListStep(l, 100))
+        ;
+    assertTrue(frontList(l) == ref[6] && backList(l) == ref[refLen - 1],
+               "the pass resumes before a removed cursor");
+    deleteLinkedList(l);
 
+    printf("Compacting a set...\n");
+    l = createLinkedSet();
+    for (int i = 0; i < 500; i++)
+        addList(l, i);
+    while (compactListStep(l, 64))
+        ;
+    ok = 1;
+    for (int i = 0; i < 500; i++)
+        ok = ok && containsList(l, i);
+    removeList(l, 250);
+    addList(l, 10);
+    assertTrue(ok && !containsList(l, 250) && frontList(l) == 499,
+               "the set index follows moved links");
+    free(ref);
+    deleteLinkedList(l);
+
+
+    printf("\nNow testing the parallel bag interface\n");
+    printf("Adding i %% 1000 for i = 0 - 99999 to the back...\n");
+    l = createLinkedList();
+    for (int i = 0; i < 100000; i++)
+        addBackList(l, i % 1000);
+    assertTrue(containsListParallel(l, 999, 4) && !containsListParallel(l, 1000, 4),
+               "containsListParallel(l, 999) == true, (l, 1000) == false");
+    assertTrue(countListParallel(l, 7, 4) == 100 && countListParallel(l, 7, 1) == 100
+               && countListParallel(l, 7, 0) == 100, "countListParallel(l, 7) == 100 on 4, 1 and all CPUs");
+    int positions[128];
+    ok = findAllListParallel(l, 7, 3, positions, 128) == 100;
+    for (int i = 0; i < 100 && ok; i++)
+        ok = positions[i] == 7 + 1000 * i;
+    assertTrue(ok, "findAllListParallel(l, 7) == {7, 1007, ..., 99007} in order");
+    assertTrue(findAllListParallel(l, 7, 3, positions, 10) == 100 && positions[9] == 9007,
+               "findAllListParallel reports every match but stores only max");
+
+    printf("Removing the front 500 links, then adding 7 to the front...\n");
+    for (int i = 0; i < 500; i++)
+        removeFrontList(l);
+    addFrontList(l, 7);
+    assertTrue(countListParallel(l, 7, 4) == 100 && findAllListParallel(l, 7, 4, positions, 1) == 100
+               && positions[0] == 0, "the skip table follows removes and adds at the front");
+    deleteLinkedList(l);
+
+    printf("Mixing 200000 adds and removes at both ends, keeping a copy in an array...\n");
+    l = createLinkedList();
+    int *model = malloc(sizeof(int) * 300000), *found = malloc(sizeof(int) * 300000);
+    int first = 100000, last = 100000;      //model holds model[first .. last - 1]
+    srand(41);
+    for (int i = 0; i < 200000; i++) {
+        int op = rand() % 5, v = rand() % 50;
+        if (op <= 1) {
+            addBackList(l, v);
+            model[last++] = v;
+        }
+        else if (op == 2) {
+            addFrontList(l, v);
+            model[--first] = v;
+        }
+        else if (op == 3 && last > first) {
+            removeFrontList(l);
+            first++;
+        }
+        else if (op == 4 && last > first) {
+            removeBackList(l);
+            last--;
+        }
+    }
+    for (int round = 0; round < 3; round++) {
+        if (round == 1) {
+            printf("Lazily removing the first 50 sevens...\n");
+            lazyRemoveList(l, 1);
+            for (int k = 0; k < 50; k++) {
+                removeList(l, 7);
+                int j = first;
+                while (model[j] != 7)
+                    j++;
+                memmove(&model[j], &model[j + 1], sizeof(int) * (last - j - 1));
+                last--;
+            }
+        }
+        if (round == 2) {
+            printf("Compacting the list...\n");
+            compactList(l);
+        }
+        int expected = 0;
+        ok = 1;
+        for (int j = first; j < last; j++)
+            if (model[j] == 7)
+                expected++;
+        ok = findAllListParallel(l, 7, 4, found, 300000) == expected && countListParallel(l, 7, 3) == expected;
+        for (int j = first, k = 0; j < last && ok; j++)
+            if (model[j] == 7)
+                ok = found[k++] == j - first;
+        assertTrue(ok, "findAllListParallel positions match the copy");
+    }
+    free(model);
+    free(found);
+    deleteLinkedList(l);
+
+
+    printf("\nNow testing mergeLists() and the streaming listMerge\n");
+    printf("Filling 20 sorted lists, list j holding multiples of j + 1 below 2000...\n");
+    struct linkedList *runs[20];
+    int total = 0;
+    for (int j = 0; j < 20; j++) {
+        runs[j] = (j == 3) ? createLinkedSet() : createLinkedList();
+        for (int v = 0; v < 2000; v += j + 1, total++)
+            addBackList(runs[j], v);
+    }
+    compactList(runs[5]);       //its slab has to follow the links
+
+    ref = malloc(sizeof(TYPE) * total);
+    refLen = 0;
+    for (int v = 0; v < 2000; v++)
+        for (int j = 0; j < 20; j++)
+            if (v % (j + 1) == 0)
+                ref[refLen++] = v;
+
+    struct listMerge *m = createListMerge(runs, 20);
+    TYPE v;
+    int read = 0;
+    ok = 1;
+    while (nextListMerge(m, &v))
+        ok = ok && read < refLen && v == ref[read++];
+    deleteListMerge(m);
+    assertTrue(ok && read == refLen, "the streaming merge reads every value in order");
+    assertTrue(frontList(runs[0]) == 0 && backList(runs[19]) == 1980, "the streaming merge leaves the lists alone");
+
+    l = createLinkedList();
+    addBackList(l, -1);
+    mergeLists(l, runs, 20);
+    removeFrontList(l);
+    assertTrue(sameContents(l, ref, refLen), "mergeLists relinks every value in order");
+    ok = 1;
+    for (int j = 0; j < 20; j++)
+        ok = ok && isEmptyList(runs[j]);
+    assertTrue(ok && isSetList(runs[3]), "the merged lists are empty and keep their mode");
+
+    addList(runs[3], 4);
+    addList(runs[3], 4);
+    while (!isEmptyList(l))
+        removeBackList(l);
+    assertTrue(frontList(runs[3]) == 4 && backList(runs[3]) == 4, "merged lists and links stay usable");
+    for (int j = 0; j < 20; j++)
+        deleteLinkedList(runs[j]);
+    deleteLinkedList(l);
+    free(ref);
+
+
+    printf("\nNow testing footprintList() and shrinkList()\n");
+    printf("Adding 0 - 99999 to the back and compacting...\n");
+    struct memoryFootprint fp, after;
+    l = createLinkedList();
+    for (int i = 0; i < 100000; i++)
+        addBackList(l, i);
+    footprintList(l, &fp);
+    assertTrue(fp.payload == 100000 * sizeof(TYPE) && fp.overhead >= 100000 * 2 * sizeof(void *)
+               && fp.reserved == 0, "footprint counts values, link pointers and nothing reserved");
+    compactList(l);
+    footprintList(l, &after);
+# ifndef NODE_CACHE
+    assertTrue(after.payload == fp.payload && after.overhead < fp.overhead,
+               "compacted links drop their allocator headers");
+# endif
 
+    printf("Removing the front 90000 values...\n");
+    for (int i = 0; i < 90000; i++)
+        removeFrontList(l);
+    footprintList(l, &fp);
+    assertTrue(fp.payload == 10000 * sizeof(TYPE) && fp.reserved >= 90000 * (sizeof(TYPE) + 2 * sizeof(void *)),
+               "the emptied part of the slab shows as reserved");
+    size_t released = shrinkList(l);
+    footprintList(l, &after);
+    assertTrue(after.reserved < fp.reserved && released >= fp.reserved - after.reserved,
+               "shrinkList returns the dead slab pages");
+    assertTrue(shrinkList(l) == 0 && frontList(l) == 90000 && backList(l) == 99999,
+               "shrinking again returns nothing and keeps the values");
+    deleteLinkedList(l);
+
+    l = createLinkedSet();
+    for (int i = 0; i < 20000; i++)
+        addList(l, i);
+    for (int i = 0; i < 19990; i++)
+        removeList(l, i);
+    footprintList(l, &fp);
+    released = shrinkList(l);
+    footprintList(l, &after);
+    assertTrue(released > 0 && after.overhead < fp.overhead && containsList(l, 19995) && !containsList(l, 5),
+               "shrinkList refits the set index");
+    deleteLinkedList(l);
+
+
+    printf("\nNow testing lazy removal\n");
+    printf("Adding 0 - 99, sweeping on demand only, removing 0, 50 and 99...\n");
+    l = createLinkedList();
+    for (int i = 0; i < 100; i++)
+        addBackList(l, i);
+    lazyRemoveList(l, 1);
+    removeList(l, 0);
+    removeList(l, 50);
+    removeList(l, 99);
+    assertTrue(deadCountList(l) == 3, "deadCountList == 3");
+    assertTrue(frontList(l) == 1 && backList(l) == 98, "front and back skip dead links");
+    assertTrue(!containsList(l, 50) && containsList(l, 51), "containsList skips dead links");
+    removeFrontList(l);
+    assertTrue(frontList(l) == 2 && deadCountList(l) == 2, "removeFrontList frees the dead links it passes");
+    assertTrue(sweepList(l) == 2 && deadCountList(l) == 0 && !containsList(l, 50), "sweepList frees every dead link");
+
+    int batchVals[] = {10, 20, 30}, batchRemoved[3];
+    assertTrue(removeListBatch(l, batchVals, 3, batchRemoved) == 3 && deadCountList(l) == 3
+               && !containsList(l, 20), "removeListBatch marks links dead");
+    lazyRemoveList(l, 0);
+    assertTrue(deadCountList(l) == 0 && frontList(l) == 2, "turning lazy mode off sweeps");
+    deleteLinkedList(l);
+
+    printf("Adding 0 - 99 with ratio 0.25 and removing from the front of the values...\n");
+    l = createLinkedList();
+    for (int i = 0; i < 100; i++)
+        addBackList(l, i);
+    lazyRemoveList(l, 0.25);
+    for (int i = 0; i < 25; i++)
+        removeList(l, i);
+    assertTrue(deadCountList(l) == 25 && frontList(l) == 25, "25 of 100 dead stays under the ratio");
+    removeList(l, 25);
+    assertTrue(deadCountList(l) == 0 && frontList(l) == 26 && !containsList(l, 25),
+               "the 26th removal sweeps all of them at once");
+    deleteLinkedList(l);
+
+    printf("Lazy removal in set mode, then compacting...\n");
+    l = createLinkedSet();
+    for (int i = 0; i < 10; i++)
+        addList(l, i);
+    lazyRemoveList(l, 1);
+    removeList(l, 3);
+    addList(l, 3);
+    assertTrue(containsList(l, 3) && deadCountList(l) == 1, "a dead value can be added again");
+    compactList(l);
+    assertTrue(deadCountList(l) == 0 && containsList(l, 3) && frontList(l) == 3 && backList(l) == 0,
+               "compaction sweeps dead links instead of moving them");
+    deleteLinkedList(l);
+
+
+# ifdef TRACE_OPS
+    printf("\nNow testing traceList()\n");
+    char tracePath[] = "/tmp/traceXXXXXX";
+    close(mkstemp(tracePath));
+    struct opTrace *t = openOpTrace(tracePath);
+    l = createLinkedList();
+    traceList(l, t);
+    addList(l, 5);
+    addBackList(l, 6);
+    addFrontList(l, -7);
+    containsList(l, 6);
+    frontList(l);
+    removeList(l, 5);
+    removeBackList(l);
+    traceList(l, 0);
+    removeFrontList(l);         //not recorded
+    assertTrue(closeOpTrace(t) == 0, "closeOpTrace(t) == 0");
+
+    struct traceOp *ops;
+    int expectOps[7] = {TRACE_ADD, TRACE_ADD_BACK, TRACE_ADD_FRONT, TRACE_CONTAINS,
+                        TRACE_FRONT, TRACE_REMOVE, TRACE_REMOVE_BACK};
+    double expectVals[7] = {5, 6, -7, 6, 0, 5, 0};
+    ok = loadOpTrace(tracePath, &ops) == 7;
+    for (int i = 0; i < 7 && ok; i++)
+        ok = ops[i].op == expectOps[i] && ops[i].value == expectVals[i];
+    assertTrue(ok, "the trace holds each call once, in order, with its value");
+    free(ops);
+    unlink(tracePath);
+    deleteLinkedList(l);
+# endif
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+/* testNodeCache.c
+ * nodeCache testing file.
+ 
+ Description:   Tests that nodes are recycled by the allocating thread,
+                including nodes freed by another thread, that trimmed
+                slabs are returned and reused, and that huge page arenas
+                hand out usable nodes
+                uses assertTrue function from assignment 2 skeleton code
+**** */
+
+#include "nodeCache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+# define NODES 1000
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+    pre:	predicate is a boolean encoded int
+	post:	none
+ */
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+struct nodePool *pool;
+void *nodes[NODES];
+
+/* Frees every node in nodes[] from a thread that does not own them */
+void *freeAll(void *arg)
+{
+    for (int i = 0; i < NODES; i++)
+        freeNode(pool, nodes[i]);
+    return 0;   //thread exit flushes the last partial batch
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Creating pool of 24 byte nodes...\n");
+    pool = createNodePool(24);
+
+    void *a = allocNode(pool);
+    freeNode(pool, a);
+    assertTrue(allocNode(pool) == a, "a node freed by its owner is reused first");
+
+    printf("\nAllocating %d nodes, then freeing them on another thread...\n", NODES);
+    int distinct = 1;
+    for (int i = 0; i < NODES; i++) {
+        nodes[i] = allocNode(pool);
+        ((int *)nodes[i])[0] = i;
+        if (nodes[i] == a)
+            distinct = 0;
+    }
+    assertTrue(distinct, "live nodes are never handed out twice");
+
+    pthread_t t;
+    pthread_create(&t, 0, freeAll, 0);
+    pthread_join(t, 0);
+
+    printf("Allocating until the rest of the slab is used up...\n");
+    int recycled = 0;
+    for (int i = 0; i < 10 * NODES && recycled < NODES; i++) {
+        void *n = allocNode(pool);
+        for (int j = 0; j < NODES; j++)
+            if (nodes[j] == n) {
+                recycled++;
+                break;
+            }
+    }
+    assertTrue(recycled == NODES, "every node freed remotely came back to its owner");
+
+    printf("\nFilling several slabs of a second pool, then freeing and trimming...\n");
+    struct nodePool *big = createNodePool(32);
+    void **many = malloc(sizeof(void *) * 10 * NODES);
+    size_t before = residentNodeCache();
+    for (int i = 0; i < 10 * NODES; i++)
+        many[i] = allocNode(big);
+    size_t filled = residentNodeCache();
+    for (int i = 0; i < 10 * NODES; i++)
+        freeNode(big, many[i]);
+    size_t released = trimNodeCache();
+    assertTrue(released > 0 && residentNodeCache() == before, "trimNodeCache returns every free slab");
+    assertTrue(trimNodeCache() == 0, "trimming again returns nothing");
+
+    for (int i = 0; i < 10 * NODES; i++) {
+        many[i] = allocNode(big);
+        ((int *)many[i])[7] = i;
+    }
+    int intact = residentNodeCache() == filled;
+    for (int i = 0; i < 10 * NODES; i++)
+        intact = intact && ((int *)many[i])[7] == i;
+    assertTrue(intact, "trimmed slabs are reused before new ones are allocated");
+    free(many);
+
+    printf("\nFilling a third pool in huge page mode, past one arena...\n");
+    hugePagesNodeCache(1);
+    struct nodePool *huge = createNodePool(24);
+    many = malloc(sizeof(void *) * 100 * NODES);
+    for (int i = 0; i < 100 * NODES; i++) {
+        many[i] = allocNode(huge);
+        ((int *)many[i])[5] = i;
+    }
+    filled = residentNodeCache();
+    int backing = pageBackingNodeCache();
+    printf("arena backing: %s\n", backing == NODE_PAGES_HUGETLB ? "hugetlb"
+           : backing == NODE_PAGES_THP ? "transparent huge pages" : "regular pages");
+    intact = 1;
+    for (int i = 0; i < 100 * NODES; i++)
+        intact = intact && ((int *)many[i])[5] == i;
+    assertTrue(intact, "nodes from huge page arenas hold their values");
+
+    for (int i = 0; i < 100 * NODES; i++)
+        freeNode(huge, many[i]);
+    released = trimNodeCache();
+    assertTrue(released > 0 ? residentNodeCache() < filled : residentNodeCache() == filled,
+               "resident bytes only drop for slabs whose pages went back");
+    hugePagesNodeCache(0);
+    for (int i = 0; i < 100 * NODES; i++)
+        many[i] = allocNode(huge);
+    assertTrue(residentNodeCache() == filled, "trimmed arena slabs are reused");
+    free(many);
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/* testStructList.c
+ * struct payload testing file.
+
+ Description:   Builds linkedList.c in this translation unit with a struct
+                TYPE and KEY, EQ, LT and HASH hooks, and tests the search,
+                removal, set, batch, parallel and merge paths by key
+                Build:
+                  gcc testStructList.c -lpthread
+                uses assertTrue function from assignment 2 skeleton code
+**** */
+
+struct record {
+    int id;         /* key */
+    double score;
+    char note[80];  /* makes a record longer than an export row */
+};
+
+# define TYPE       struct record
+# define TYPE_SIZE  sizeof(struct record)
+# define KEY(A)     ((A).id)
+
+#include "linkedList.c"
+
+/*	Testing function, takes predicate, and message and prints the message
+    and if the test passed or failed, ie if the predicate expression evaluated
+    to true or false. NOT WRITTEN BY ME - TAKEN FROM ASSIGNMENT 2 SKELETON CODE
+	param: 	char *message message to be printed out
+    param: 	int predicate, boolean encoded as int
+	pre:	*message is not null
+    pre:	predicate is a boolean encoded int
+	post:	none
+ */
+void assertTrue(int predicate, char *message)
+{
+    printf("%s: ", message);
+    if (predicate)
+        printf("PASSED\n");
+    else
+        printf("FAILED\n");
+}
+
+/* Collects what a binary export writes */
+struct capture {
+    char *data;
+    int len;
+};
+
+int capture(void *ctx, const char *buf, int len)
+{
+    struct capture *c = ctx;
+    c->data = realloc(c->data, c->len + len);
+    assert(c->data != 0);
+    memcpy(c->data + c->len, buf, len);
+    c->len += len;
+    return 0;
+}
+
+/* A record, and the probe used to look it up by key */
+struct record rec(int id, double score)
+{
+    struct record r = {id, score, ""};
+    return r;
+}
+
+struct record probe(int id)
+{
+    return rec(id, -1);
+}
+
+int main(int argc, char* argv[]) {
+
+    printf("Adding records 0 - 9999 to the back, score = 2 * id...\n");
+    struct linkedList *l = createLinkedList();
+    for (int i = 0; i < 10000; i++)
+        addBackList(l, rec(i, 2.0 * i));
+    assertTrue(frontList(l).id == 0 && backList(l).score == 19998, "front and back return whole records");
+    assertTrue(containsList(l, probe(1234)) && !containsList(l, probe(10000)), "containsList matches by key");
+    removeList(l, probe(1234));
+    assertTrue(!containsList(l, probe(1234)) && containsList(l, probe(1235)), "removeList removes by key");
+    assertTrue(_containsListRecursive(l->firstLink->next, probe(9999)), "_containsListRecursive matches by key");
+    assertTrue(containsListParallel(l, probe(5000), 4) && countListParallel(l, probe(1234), 4) == 0,
+               "parallel scans match by key");
+
+    TYPE vals[] = {probe(1), probe(1234), probe(7777)};
+    int found[3];
+    assertTrue(containsListBatch(l, vals, 3, found) == 2 && found[0] && !found[1] && found[2],
+               "containsListBatch hashes the key");
+    deleteLinkedList(l);
+
+    printf("\nSet mode keyed on id...\n");
+    l = createLinkedSet();
+    for (int i = 0; i < 1000; i++)
+        addList(l, rec(i % 100, i));
+    assertTrue(containsList(l, probe(42)) && !containsList(l, probe(100)), "one record per key");
+    removeList(l, probe(42));
+    assertTrue(!containsList(l, probe(42)) && containsList(l, probe(43)), "set removal by key");
+
+    struct linkedList *other = createLinkedSet();
+    for (int i = 50; i < 150; i++)
+        addList(other, rec(i, 0));
+    struct linkedList *both = intersectList(l, other);
+    assertTrue(containsList(both, probe(99)) && !containsList(both, probe(42)) && !containsList(both, probe(10)),
+               "intersectList compares keys");
+    deleteLinkedList(both);
+    deleteLinkedList(other);
+    deleteLinkedList(l);
+
+    printf("\nMerging two runs sorted by id...\n");
+    struct linkedList *runs[2] = {createLinkedList(), createLinkedList()};
+    for (int i = 0; i < 100; i++)
+        addBackList(runs[i % 2], rec(i, i % 2));
+    l = createLinkedList();
+    mergeLists(l, runs, 2);
+    int ordered = 1;
+    for (int i = 0; i < 100; i++) {
+        ordered = ordered && frontList(l).id == i && frontList(l).score == i % 2;
+        removeFrontList(l);
+    }
+    assertTrue(ordered && isEmptyList(l), "mergeLists orders by LT on the key and keeps the payloads");
+    deleteLinkedList(runs[0]);
+    deleteLinkedList(runs[1]);
+    deleteLinkedList(l);
+
+    printf("\nExporting 2000 records of %d bytes as binary...\n", (int)sizeof(struct record));
+    l = createLinkedList();
+    for (int i = 0; i < 2000; i++) {
+        struct record r = rec(i, i / 2.0);
+        snprintf(r.note, sizeof(r.note), "record %d", i);
+        addBackList(l, r);
+    }
+    struct capture c = {0, 0};
+    int exact = exportList(l, EXPORT_BINARY, capture, &c) == 0 && c.len == 2000 * (int)sizeof(struct record);
+    for (int i = 0; i < 2000 && exact; i++) {
+        struct record r;
+        char note[80];
+        memcpy(&r, c.data + (size_t)i * sizeof(struct record), sizeof(struct record));
+        snprintf(note, sizeof(note), "record %d", i);
+        exact = r.id == i && r.score == i / 2.0 && strcmp(r.note, note) == 0;
+    }
+    assertTrue(exact, "binary export writes whole records longer than a text row");
+    free(c.data);
+    deleteLinkedList(l);
+
+	return 0;
+}
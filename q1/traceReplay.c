@@ -0,0 +1,192 @@
+/* traceReplay.c
+ * operation trace replay benchmark.
+
+ Description:   Replays a trace recorded with -DTRACE_OPS against one
+                backend of the deque/bag API and reports throughput and
+                per-operation latency histograms. The trace is replayed
+                twice on fresh containers: once untimed for throughput, and
+                once timing every call for the latencies, which therefore
+                include about one clock_gettime of overhead.
+
+                Calls a backend cannot serve (bag calls on a deque, reads
+                of an empty container) are skipped and counted.
+
+                Build against the backend to measure:
+                  gcc -O2 traceReplay.c linkedList.c opTrace.c -lpthread
+                  gcc -O2 -DNODE_CACHE traceReplay.c linkedList.c opTrace.c nodeCache.c -lpthread
+                  gcc -O2 -DREPLAY_CIRLISTDEQUE -I../final traceReplay.c ../final/cirListDeque.c opTrace.c
+                Run:
+                  ./a.out trace.bin
+**** */
+
+#include "opTrace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+# ifdef REPLAY_CIRLISTDEQUE
+#include "cirListDeque.h"
+# define BACKEND_NAME       "cirListDeque"
+# define BACKEND            struct cirListDeque
+# define CREATE()           createCirListDeque()
+# define DELETE(B)          deleteCirListDeque(B)
+# define IS_EMPTY(B)        isEmptyCirListDeque(B)
+# define ADD_FRONT(B, V)    addFrontCirListDeque(B, V)
+# define ADD_BACK(B, V)     addBackCirListDeque(B, V)
+# define FRONT(B)           frontCirListDeque(B)
+# define BACK(B)            backCirListDeque(B)
+# define REMOVE_FRONT(B)    removeFrontCirListDeque(B)
+# define REMOVE_BACK(B)     removeBackCirListDeque(B)
+# define HAS_BAG            0
+# else
+#include "linkedList.h"
+# define BACKEND_NAME       "linkedList"
+# define BACKEND            struct linkedList
+# define CREATE()           createLinkedList()
+# define DELETE(B)          deleteLinkedList(B)
+# define IS_EMPTY(B)        isEmptyList(B)
+# define ADD_FRONT(B, V)    addFrontList(B, V)
+# define ADD_BACK(B, V)     addBackList(B, V)
+# define FRONT(B)           frontList(B)
+# define BACK(B)            backList(B)
+# define REMOVE_FRONT(B)    removeFrontList(B)
+# define REMOVE_BACK(B)     removeBackList(B)
+# define ADD(B, V)          addList(B, V)
+# define CONTAINS(B, V)     containsList(B, V)
+# define REMOVE(B, V)       removeList(B, V)
+# define HAS_BAG            1
+# endif
+
+# define BUCKETS 40     /* bucket b holds latencies in [2^b, 2^(b+1)) ns */
+
+double getNanoseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Replays one record, returns 0 if the backend had to skip it */
+int replay(BACKEND *b, struct traceOp *r, TYPE *sink)
+{
+    switch (r->op) {
+        case TRACE_ADD_FRONT:    ADD_FRONT(b, (TYPE)r->value); return 1;
+        case TRACE_ADD_BACK:     ADD_BACK(b, (TYPE)r->value); return 1;
+# if HAS_BAG
+        case TRACE_ADD:          ADD(b, (TYPE)r->value); return 1;
+# else
+        case TRACE_ADD:          ADD_FRONT(b, (TYPE)r->value); return 1;
+# endif
+    }
+
+    if (IS_EMPTY(b))
+        return 0;
+
+    switch (r->op) {
+        case TRACE_FRONT:        *sink += FRONT(b); return 1;
+        case TRACE_BACK:         *sink += BACK(b); return 1;
+        case TRACE_REMOVE_FRONT: REMOVE_FRONT(b); return 1;
+        case TRACE_REMOVE_BACK:  REMOVE_BACK(b); return 1;
+# if HAS_BAG
+        case TRACE_CONTAINS:     *sink += CONTAINS(b, (TYPE)r->value); return 1;
+        case TRACE_REMOVE:       REMOVE(b, (TYPE)r->value); return 1;
+# endif
+    }
+    return 0;
+}
+
+/* Upper bound in ns of the bucket holding the p-th fraction of n samples */
+double percentile(long *hist, long n, double p)
+{
+    long target = (long)(p * n), seen = 0;
+
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += hist[b];
+        if (seen > target)
+            return (double)(2L << b);
+    }
+    return (double)(2L << (BUCKETS - 1));
+}
+
+int main(int argc, char* argv[]) {
+    struct traceOp *ops;
+    TYPE sink = 0;
+
+    if (argc < 2) {
+        printf("usage: %s trace.bin\n", argv[0]);
+        return 1;
+    }
+
+    int n = loadOpTrace(argv[1], &ops);
+    if (n < 0) {
+        printf("%s is not a readable trace\n", argv[1]);
+        return 1;
+    }
+
+    //pass 1: throughput
+    BACKEND *b = CREATE();
+    long skipped = 0;
+    double t1 = getNanoseconds();
+    for (int i = 0; i < n; i++)
+        skipped += !replay(b, &ops[i], &sink);
+    double t2 = getNanoseconds();
+    DELETE(b);
+
+    printf("%s: %d ops in %.2f ms, %.0f ops/s, %ld skipped\n",
+           BACKEND_NAME, n, (t2 - t1) / 1e6, n / ((t2 - t1) / 1e9), skipped);
+
+    //pass 2: latency of every call
+    static long hist[TRACE_OP_COUNT][BUCKETS], all[BUCKETS];
+    long counts[TRACE_OP_COUNT] = {0};
+    double totals[TRACE_OP_COUNT] = {0};
+
+    b = CREATE();
+    for (int i = 0; i < n; i++) {
+        double s = getNanoseconds();
+        int done = replay(b, &ops[i], &sink);
+        double ns = getNanoseconds() - s;
+
+        if (!done)
+            continue;
+
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 && ns >= (double)(2L << bucket))
+            bucket++;
+        hist[ops[i].op][bucket]++;
+        all[bucket]++;
+        counts[ops[i].op]++;
+        totals[ops[i].op] += ns;
+    }
+    DELETE(b);
+
+    printf("\n%-12s %10s %10s %10s %10s %10s\n", "op", "count", "mean ns", "p50 <", "p99 <", "p99.9 <");
+    for (int op = 1; op < TRACE_OP_COUNT; op++) {
+        if (counts[op] == 0)
+            continue;
+        printf("%-12s %10ld %10.0f %10.0f %10.0f %10.0f\n", nameOpTrace(op), counts[op],
+               totals[op] / counts[op], percentile(hist[op], counts[op], 0.5),
+               percentile(hist[op], counts[op], 0.99), percentile(hist[op], counts[op], 0.999));
+    }
+
+    long total = 0, peak = 1;
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        total += all[bucket];
+        if (all[bucket] > peak)
+            peak = all[bucket];
+    }
+
+    printf("\nlatency histogram, all ops\n");
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        if (all[bucket] == 0)
+            continue;
+        int bar = (int)(50 * all[bucket] / peak);
+        printf("  < %10ld ns %10ld %5.1f%% ", 2L << bucket, all[bucket], 100.0 * all[bucket] / total);
+        for (int i = 0; i < bar; i++)
+            putchar('#');
+        putchar('\n');
+    }
+
+    if (sink == 12345)  //keeps the reads from being optimized away
+        printf("\n");
+    free(ops);
+    return 0;
+}